@@ -0,0 +1,90 @@
+#include "Rcpp.h"
+#include "beachmat3/kernels.h"
+
+#include <chrono>
+#include <vector>
+
+// Not necessary in a package context:
+// [[Rcpp::depends(beachmat)]]
+
+/* Microbenchmarks for the copy and scatter kernels in beachmat3/kernels.h,
+ * compared to the plain loops that they replace. Each function returns the
+ * average time per call in microseconds.
+ */
+
+// Stops the compiler from optimizing away the loops, as their outputs are otherwise unused.
+volatile double guard=0;
+
+template<class FUN>
+double time_kernel(FUN fun, int iterations) {
+    auto start=std::chrono::steady_clock::now();
+    for (int it=0; it<iterations; ++it) {
+        fun();
+    }
+    auto end=std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector bench_int_to_double(Rcpp::IntegerVector input, int iterations) {
+    const int* in=input.begin();
+    const size_t n=input.size();
+    std::vector<double> out(n);
+
+    double kernel=time_kernel([&]() -> void {
+        beachmat::copy_n_values(in, n, out.data());
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    double plain=time_kernel([&]() -> void {
+        for (size_t i=0; i<n; ++i) {
+            out[i]=(in[i]==NA_INTEGER ? NA_REAL : in[i]);
+        }
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    return Rcpp::NumericVector::create(Rcpp::Named("kernel")=kernel, Rcpp::Named("plain")=plain);
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector bench_double_to_int(Rcpp::NumericVector input, int iterations) {
+    const double* in=input.begin();
+    const size_t n=input.size();
+    std::vector<int> out(n);
+
+    double kernel=time_kernel([&]() -> void {
+        beachmat::copy_n_values(in, n, out.data());
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    double plain=time_kernel([&]() -> void {
+        std::copy(in, in + n, out.begin());
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    return Rcpp::NumericVector::create(Rcpp::Named("kernel")=kernel, Rcpp::Named("plain")=plain);
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector bench_scatter(Rcpp::NumericVector values, Rcpp::IntegerVector indices, int nrow, int iterations) {
+    const double* x=values.begin();
+    const int* idx=indices.begin();
+    const size_t n=values.size();
+    std::vector<double> out(nrow);
+
+    double kernel=time_kernel([&]() -> void {
+        std::fill(out.begin(), out.end(), 0);
+        beachmat::scatter_values(x, idx, n, out.data(), 0);
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    double plain=time_kernel([&]() -> void {
+        std::fill(out.begin(), out.end(), 0);
+        for (size_t i=0; i<n; ++i) {
+            out[idx[i]]=x[i];
+        }
+        guard=(out.empty() ? 0 : out.back());
+    }, iterations);
+
+    return Rcpp::NumericVector::create(Rcpp::Named("kernel")=kernel, Rcpp::Named("plain")=plain);
+}
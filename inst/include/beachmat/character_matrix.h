@@ -190,8 +190,8 @@ using simple_character_matrix=general_character_matrix<simple_reader<Rcpp::Strin
 typedef delayed_reader<Rcpp::String, Rcpp::StringVector, character_matrix> delayed_character_reader;
 
 template<>
-inline std::unique_ptr<character_matrix> delayed_character_reader::generate_seed(Rcpp::RObject incoming) {
-    return create_character_matrix_internal(incoming, false);
+inline std::unique_ptr<character_matrix> delayed_character_reader::generate_seed(Rcpp::RObject incoming, bool delayed) {
+    return create_character_matrix_internal(incoming, delayed);
 }
 
 using delayed_character_matrix=general_character_matrix<delayed_character_reader>;
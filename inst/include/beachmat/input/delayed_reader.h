@@ -8,6 +8,7 @@
 #include "../utils/dim_checker.h"
 #include "../utils/copyable_vector.h"
 #include "../utils/raw_structure.h"
+#include "../utils/delayed_ops.h"
 
 #include <memory>
 #include <stdexcept>
@@ -59,9 +60,90 @@ private:
     template<class M, class Iter>
     void reallocate_col(M, size_t, size_t, size_t, Iter out);
 
-    size_t old_col_first=0, old_col_last=0, min_col_index=0, max_col_index=0;
-    size_t old_row_first=0, old_row_last=0, min_row_index=0, max_row_index=0;
-    static void prepare_reallocation(size_t, size_t, size_t&, size_t&, size_t&, size_t&, const std::vector<size_t>&, const char*);
+    /* Subset indices that are sparse relative to their span are extracted with
+     * the seed's indexed getters, using the sorted unique indices. 'position'
+     * then maps each requested index to its value in the extracted vector.
+     * Otherwise, we extract the entire span and gather from it.
+     */
+    struct reallocation_plan {
+        size_t old_first=0, old_last=0, min_index=0, max_index=0;
+        bool gather=false;
+        copyable_holder<Rcpp::IntegerVector> sorted;
+        std::vector<size_t> position;
+    };
+    reallocation_plan col_plan, row_plan;
+    static void prepare_reallocation(size_t, size_t, reallocation_plan&, const std::vector<size_t>&);
+};
+
+/* The 'delayed_abind' class dispatches requests to the individual matrices of
+ * a DelayedMatrix created by rbind() or cbind(), using a binary search on the
+ * cumulative number of rows or columns. Each matrix has its own reader, so 
+ * native access (e.g., for sparse matrices) is preserved for each matrix.
+ */
+
+template<typename T, class V, class base_mat>
+class delayed_abind {
+public:
+    delayed_abind() = default;
+
+    delayed_abind(std::vector<std::unique_ptr<base_mat> >, bool);
+
+    ~delayed_abind() = default;
+    delayed_abind(delayed_abind&&) = default;
+    delayed_abind& operator=(delayed_abind&&) = default;
+
+    delayed_abind(const delayed_abind& other) : byrow(other.byrow), cumulative(other.cumulative), 
+            nrow(other.nrow), ncol(other.ncol) {
+        for (const auto& child : other.children) {
+            children.push_back(child->clone());
+        }
+    }
+
+    delayed_abind& operator=(const delayed_abind& other) {
+        delayed_abind copy(other);
+        *this=std::move(copy);
+        return *this;
+    }
+
+    bool empty() const { return children.empty(); }
+
+    template<class Iter>
+    void get_row(size_t, Iter, size_t, size_t);
+    
+    template<class Iter>
+    void get_col(size_t, Iter, size_t, size_t);
+
+    T get(size_t, size_t);
+
+    template<class Iter>
+    void get_rows(Rcpp::IntegerVector::iterator, size_t, Iter, size_t, size_t);
+
+    size_t get_nrow() const { return nrow; }
+    size_t get_ncol() const { return ncol; }
+private:
+    std::vector<std::unique_ptr<base_mat> > children;
+    bool byrow=false; // whether the matrices are combined by row, i.e., rbind().
+    std::vector<size_t> cumulative; // first row/column of each matrix, with the total at the end.
+    size_t nrow=0, ncol=0;
+
+    size_t find_child(size_t i) const {
+        return std::upper_bound(cumulative.begin(), cumulative.end(), i) - cumulative.begin() - 1;
+    }
+
+    // Splits [first, last) along the combined dimension into stretches for each matrix.
+    template<class FUN>
+    void split(size_t first, size_t last, FUN fun) {
+        if (first==last) {
+            return;
+        }
+        for (size_t k=find_child(first); k < children.size() && cumulative[k] < last; ++k) {
+            const size_t lo=std::max(first, cumulative[k]), hi=std::min(last, cumulative[k+1]);
+            if (lo < hi) {
+                fun(k, lo - cumulative[k], hi - cumulative[k]);
+            }
+        }
+        return;
+    }
 };
 
 /* The 'delayed_reader' class, which wraps the coord_transformer class. */
@@ -79,18 +161,59 @@ public:
         const Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
         Rcpp::Function parser(beachenv["setupDelayedMatrix"]);
         Rcpp::List parse_out=parser(incoming);
-        if (parse_out.size()!=3) {
-            throw std::runtime_error("output of beachmat:::setupDelayedMatrix should be a list of length 3");
+        if (parse_out.size()!=5) {
+            throw std::runtime_error("output of beachmat:::setupDelayedMatrix should be a list of length 5");
+        }
+
+        /* Supported value-modifying operations are applied natively after extraction.
+         * This is only done if the values from the remaining matrix can be exactly
+         * represented in the output type; otherwise, the entire matrix is treated as unknown.
+         */
+        Rcpp::RObject parsed_mat=parse_out[2];
+        Rcpp::RObject parsed_ops=parse_out[3];
+        if (!parsed_ops.isNULL()) {
+            Rcpp::List op_info(parsed_ops);
+            const std::string input_type=make_to_string(op_info[0]);
+            const std::string output_type=translate_type(V().sexp_type());
+            if (output_type=="double" || input_type==output_type) {
+                Rcpp::List op_list=op_info[1];
+                ops=delayed_op_stack<T>(op_list);
+            } else {
+                parsed_mat=incoming;
+            }
+        }
+
+        /* Combined matrices are handled by dispatching to a reader for each matrix.
+         * Here, generate_seed is allowed to create delayed readers, as each 
+         * matrix is smaller than the DelayedMatrix so recursion must terminate.
+         */
+        Rcpp::RObject parsed_bind=parse_out[4];
+        if (!parsed_bind.isNULL() && (parsed_ops.isNULL() || !ops.empty())) {
+            Rcpp::List bind_info(parsed_bind);
+            Rcpp::IntegerVector along(bind_info[0]);
+            if (along.size()!=1) {
+                throw std::runtime_error("binding dimension should be an integer scalar");
+            }
+
+            Rcpp::List seeds(bind_info[1]);
+            std::vector<std::unique_ptr<base_mat> > children;
+            for (size_t i=0; i<seeds.size(); ++i) {
+                children.push_back(generate_seed(seeds[i], true));
+            }
+            binder=delayed_abind<T, V, base_mat>(std::move(children), along[0]==1);
+
+            nrow=binder.get_nrow();
+            ncol=binder.get_ncol();
+            return;
         }
 
-        /* Checking the matrix does not have value-operating delayed operations, 
+        /* Checking the matrix does not have other value-operating delayed operations, 
          * and thus we can use native methods for extraction. Otherwise,
          * parsed_mat would be a DelayedMatrix (note that generate_seed
          * will simply default to an unknown matrix in such cases, rather 
          * than infinitely recursing through the delayed_matrix constructors).
          */
-        Rcpp::RObject parsed_mat=parse_out[2];
-        seed_ptr=generate_seed(parsed_mat);
+        seed_ptr=generate_seed(parsed_mat, false);
 
         bool direct_extract=true;
         if (parsed_mat.isS4()) {
@@ -110,13 +233,16 @@ public:
         return;
     }
 
-    delayed_reader(const delayed_reader& other) : original(other.original), 
-            seed_ptr(other.seed_ptr->clone()), transformer(other.transformer) {}
+    delayed_reader(const delayed_reader& other) : dim_checker(other), original(other.original), 
+            seed_ptr(clone_seed(other.seed_ptr)), transformer(other.transformer), binder(other.binder), ops(other.ops) {}
 
     delayed_reader& operator=(const delayed_reader& other) {
+        dim_checker::operator=(other);
         original=other.original;
-        seed_ptr=other.seed_ptr->clone();
+        seed_ptr=clone_seed(other.seed_ptr);
         transformer=other.transformer;
+        binder=other.binder;
+        ops=other.ops;
         return *this;
     }
 
@@ -168,9 +294,15 @@ private:
     Rcpp::RObject original;
     std::unique_ptr<base_mat> seed_ptr;
     delayed_coord_transformer<T, V> transformer;
+    delayed_abind<T, V, base_mat> binder;
+    delayed_op_stack<T> ops;
 
     // Specialized function for each realized matrix type.
-    static std::unique_ptr<base_mat> generate_seed(Rcpp::RObject);
+    static std::unique_ptr<base_mat> generate_seed(Rcpp::RObject, bool);
+
+    static std::unique_ptr<base_mat> clone_seed(const std::unique_ptr<base_mat>& seed) {
+        return (seed ? seed->clone() : std::unique_ptr<base_mat>());
+    }
 };
 
 /******************************************************************
@@ -368,19 +500,38 @@ T delayed_coord_transformer<T, V>::get(M mat, size_t r, size_t c) {
 
 template<typename T, class V>
 void delayed_coord_transformer<T, V>::prepare_reallocation(size_t first, size_t last, 
-        size_t& old_first, size_t& old_last, size_t& min_index, size_t& max_index, 
-        const std::vector<size_t>& indices, const char* msg) {
-
-    if (old_first!=first || old_last!=last) {
-        old_first=first;
-        old_last=last;
-        if (first!=last) {
-            min_index=*std::min_element(indices.begin()+first, indices.begin()+last);
-            max_index=*std::max_element(indices.begin()+first, indices.begin()+last)+1;
-        } else {
-            // Avoid problems with max/min of zero-length vectors.
-            min_index=0;
-            max_index=0;
+        reallocation_plan& plan, const std::vector<size_t>& indices) {
+
+    if (plan.old_first==first && plan.old_last==last) {
+        return;
+    }
+    plan.old_first=first;
+    plan.old_last=last;
+    plan.gather=false;
+
+    if (first==last) {
+        // Avoid problems with max/min of zero-length vectors.
+        plan.min_index=0;
+        plan.max_index=0;
+        return;
+    }
+
+    std::vector<size_t> sorted(indices.begin()+first, indices.begin()+last);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    plan.min_index=sorted.front();
+    plan.max_index=sorted.back()+1;
+
+    // Switching to indexed extraction if less than half of the span is requested.
+    if (sorted.size()*2 < plan.max_index - plan.min_index) {
+        plan.gather=true;
+        plan.sorted.vec=Rcpp::IntegerVector(sorted.begin(), sorted.end());
+
+        plan.position.clear();
+        plan.position.reserve(last - first);
+        auto iIt=indices.begin()+first, end=indices.begin()+last;
+        for (; iIt!=end; ++iIt) {
+            plan.position.push_back(std::lower_bound(sorted.begin(), sorted.end(), *iIt) - sorted.begin());
         }
     }
 
@@ -390,16 +541,25 @@ void delayed_coord_transformer<T, V>::prepare_reallocation(size_t first, size_t
 template<typename T, class V>
 template<class M, class Iter>
 void delayed_coord_transformer<T, V>::reallocate_row(M mat, size_t r, size_t first, size_t last, Iter out) {
-    // Yes, the use of *_col_* variables for row reallocation is intentional!
+    // Yes, the use of col_* variables for row reallocation is intentional!
     // This is because we're talking about the columns in the extracted row.
-    prepare_reallocation(first, last, old_col_first, old_col_last, 
-            min_col_index, max_col_index, col_index, "column");
+    prepare_reallocation(first, last, col_plan, col_index);
 
     V& holding=tmp.vec;
-    mat->get_row(r, holding.begin(), min_col_index, max_col_index);
+    if (col_plan.gather) {
+        Rcpp::IntegerVector& sorted=col_plan.sorted.vec;
+        mat->get_cols(sorted.begin(), sorted.size(), holding.begin(), r, r+1);
+        for (auto p : col_plan.position) {
+            (*out)=holding[p];
+            ++out;
+        }
+        return;
+    }
+
+    mat->get_row(r, holding.begin(), col_plan.min_index, col_plan.max_index);
     auto cIt=col_index.begin()+first, end=col_index.begin()+last;
     while (cIt!=end) {
-        (*out)=holding[*cIt - min_col_index];
+        (*out)=holding[*cIt - col_plan.min_index];
         ++out;
         ++cIt;
     }
@@ -409,22 +569,145 @@ void delayed_coord_transformer<T, V>::reallocate_row(M mat, size_t r, size_t fir
 template<typename T, class V>
 template<class M, class Iter>
 void delayed_coord_transformer<T, V>::reallocate_col(M mat, size_t c, size_t first, size_t last, Iter out) {
-    // Yes, the use of *_row_* variables for column reallocation is intentional!
+    // Yes, the use of row_* variables for column reallocation is intentional!
     // This is because we're talking about the rows in the extracted column.
-    prepare_reallocation(first, last, old_row_first, old_row_last, 
-            min_row_index, max_row_index, row_index, "row");
+    prepare_reallocation(first, last, row_plan, row_index);
 
     V& holding=tmp.vec;
-    mat->get_col(c, holding.begin(), min_row_index, max_row_index);
+    if (row_plan.gather) {
+        Rcpp::IntegerVector& sorted=row_plan.sorted.vec;
+        mat->get_rows(sorted.begin(), sorted.size(), holding.begin(), c, c+1);
+        for (auto p : row_plan.position) {
+            (*out)=holding[p];
+            ++out;
+        }
+        return;
+    }
+
+    mat->get_col(c, holding.begin(), row_plan.min_index, row_plan.max_index);
     auto rIt=row_index.begin()+first, end=row_index.begin()+last;
     while (rIt!=end) {
-        (*out)=holding[*rIt - min_row_index];
+        (*out)=holding[*rIt - row_plan.min_index];
         ++out;
         ++rIt;
     }
     return;
 }
 
+/*****************************************************
+ * Implementing methods for the 'delayed_abind' class *
+ *****************************************************/
+
+template<typename T, class V, class base_mat>
+delayed_abind<T, V, base_mat>::delayed_abind(std::vector<std::unique_ptr<base_mat> > mats, bool r) : 
+        children(std::move(mats)), byrow(r), cumulative(1) {
+
+    if (children.empty()) {
+        throw std::runtime_error("no matrices to combine");
+    }
+    nrow=children.front()->get_nrow();
+    ncol=children.front()->get_ncol();
+
+    size_t total=0;
+    for (const auto& child : children) {
+        const size_t other=(byrow ? child->get_ncol() : child->get_nrow());
+        if (other!=(byrow ? ncol : nrow)) {
+            throw std::runtime_error("combined matrices should have the same number of rows or columns");
+        }
+        total+=(byrow ? child->get_nrow() : child->get_ncol());
+        cumulative.push_back(total);
+    }
+
+    if (byrow) {
+        nrow=total;
+    } else {
+        ncol=total;
+    }
+    return;
+}
+
+template<typename T, class V, class base_mat>
+template<class Iter>
+void delayed_abind<T, V, base_mat>::get_row(size_t r, Iter out, size_t first, size_t last) {
+    if (byrow) {
+        const size_t k=find_child(r);
+        children[k]->get_row(r - cumulative[k], out, first, last);
+    } else {
+        split(first, last, [&](size_t k, size_t lo, size_t hi) -> void {
+            children[k]->get_row(r, out, lo, hi);
+            out+=hi - lo;
+        });
+    }
+    return;
+}
+
+template<typename T, class V, class base_mat>
+template<class Iter>
+void delayed_abind<T, V, base_mat>::get_col(size_t c, Iter out, size_t first, size_t last) {
+    if (byrow) {
+        split(first, last, [&](size_t k, size_t lo, size_t hi) -> void {
+            children[k]->get_col(c, out, lo, hi);
+            out+=hi - lo;
+        });
+    } else {
+        const size_t k=find_child(c);
+        children[k]->get_col(c - cumulative[k], out, first, last);
+    }
+    return;
+}
+
+template<typename T, class V, class base_mat>
+T delayed_abind<T, V, base_mat>::get(size_t r, size_t c) {
+    if (byrow) {
+        const size_t k=find_child(r);
+        return children[k]->get(r - cumulative[k], c);
+    } else {
+        const size_t k=find_child(c);
+        return children[k]->get(r, c - cumulative[k]);
+    }
+}
+
+template<typename T, class V, class base_mat>
+template<class Iter>
+void delayed_abind<T, V, base_mat>::get_rows(Rcpp::IntegerVector::iterator rIt, size_t n, Iter out, size_t first, size_t last) {
+    if (!byrow) {
+        split(first, last, [&](size_t k, size_t lo, size_t hi) -> void {
+            children[k]->get_rows(rIt, n, out, lo, hi);
+            out+=n * (hi - lo);
+        });
+        return;
+    }
+
+    // Strictly increasing indices can be grouped by matrix, and each group is then scattered into the output.
+    const size_t ncols=last - first;
+    size_t i=0;
+    while (i < n) {
+        const size_t k=find_child(rIt[i]);
+        size_t j=i;
+        while (j < n && static_cast<size_t>(rIt[j]) < cumulative[k+1]) {
+            ++j;
+        }
+
+        const size_t ngroup=j - i;
+        Rcpp::IntegerVector shifted(rIt + i, rIt + j);
+        for (auto& s : shifted) {
+            s-=cumulative[k];
+        }
+        V holding(ngroup * ncols);
+        children[k]->get_rows(shifted.begin(), ngroup, holding.begin(), first, last);
+
+        auto hIt=holding.begin();
+        for (size_t c=0; c<ncols; ++c) {
+            auto current=out + c * n + i;
+            for (size_t g=0; g<ngroup; ++g, ++hIt, ++current) {
+                *current=*hIt;
+            }
+        }
+        i=j;
+    }
+    return;
+}
+
 /*******************************************************
  * Implementing methods for the 'delayed_reader' class *
  *******************************************************/
@@ -436,20 +719,46 @@ void delayed_coord_transformer<T, V>::reallocate_col(M mat, size_t c, size_t fir
 template<typename T, class V, class base_mat>
 template<class Iter>
 void delayed_reader<T, V, base_mat>::get_col(size_t c, Iter out, size_t first, size_t last) {
-    transformer.get_col(seed_ptr.get(), c, out, first, last);
+    if (!binder.empty()) {
+        check_colargs(c, first, last);
+        binder.get_col(c, out, first, last);
+    } else {
+        transformer.get_col(seed_ptr.get(), c, out, first, last);
+    }
+    if (!ops.empty()) {
+        ops.apply_col(c, out, first, last);
+    }
     return;
 }
 
 template<typename T, class V, class base_mat>
 template<class Iter>
 void delayed_reader<T, V, base_mat>::get_row(size_t r, Iter out, size_t first, size_t last) {
-    transformer.get_row(seed_ptr.get(), r, out, first, last);
+    if (!binder.empty()) {
+        check_rowargs(r, first, last);
+        binder.get_row(r, out, first, last);
+    } else {
+        transformer.get_row(seed_ptr.get(), r, out, first, last);
+    }
+    if (!ops.empty()) {
+        ops.apply_row(r, out, first, last);
+    }
     return;
 }
 
 template<typename T, class V, class base_mat>
 T delayed_reader<T, V, base_mat>::get(size_t r, size_t c) {
-    return transformer.get(seed_ptr.get(), r, c);
+    T val;
+    if (!binder.empty()) {
+        check_oneargs(r, c);
+        val=binder.get(r, c);
+    } else {
+        val=transformer.get(seed_ptr.get(), r, c);
+    }
+    if (!ops.empty()) {
+        val=ops.apply_one(r, c, val);
+    }
+    return val;
 }
 
 /*** Multi getter methods ***/
@@ -460,6 +769,11 @@ void delayed_reader<T, V, base_mat>::get_rows(Rcpp::IntegerVector::iterator rIt,
     check_rowargs(0, first, last);
     check_row_indices(rIt, n);
 
+    if (!binder.empty() && ops.empty()) {
+        binder.get_rows(rIt, n, out, first, last);
+        return;
+    }
+
     // No easy way to save memory or time, as we'd have to do a transposition if we use transformer.get_row().
     Rcpp::Environment beachenv(Rcpp::Environment::namespace_env("beachmat"));
     Rcpp::Function indexed_realizer(beachenv["realizeByIndexRange"]);
@@ -477,11 +791,11 @@ void delayed_reader<T, V, base_mat>::get_cols(Rcpp::IntegerVector::iterator cIt,
     check_colargs(0, first, last);
     check_col_indices(cIt, n);
 
-    if (seed_ptr->get_class()!="") { 
+    if (!binder.empty() || seed_ptr->get_class()!="") { 
         // Not unknown, so there are probably fast column access methods available.
         const size_t nrows=last - first;
         for (size_t i=0; i<n; ++i, ++cIt, out+=nrows) {
-            transformer.get_col(seed_ptr.get(), *cIt, out, first, last); 
+            get_col(*cIt, out, first, last); 
         }
     } else {
         // Unknown matrices use block realization for speed (single block realization).
@@ -8,6 +8,7 @@
 #include "../utils/raw_structure.h"
 
 #include <algorithm>
+#include <list>
 
 namespace beachmat {
 
@@ -15,6 +16,14 @@ namespace beachmat {
  * upon request from any calling function. This was designed for 
  * DelayedMatrix objects, to avoid reimplementing arbitrary delayed 
  * R operations in C++; however, it is also useful for unknown matrices.
+ *
+ * Realized chunks are held in a least-recently-used cache, capped by a
+ * memory budget in bytes. This avoids repeated calls to R when access 
+ * alternates between rows and columns or revisits a neighbouring chunk.
+ * Each chunk is keyed by its orientation, its range along the primary 
+ * dimension (defined by the chunk boundaries) and the range along the 
+ * secondary dimension; a request is served from any cached chunk of the
+ * same orientation that contains the requested range.
  */
 
 template<typename T, class V>
@@ -67,24 +76,39 @@ public:
     std::string get_class() const { return ""; }
 
     std::string get_package() const { return ""; }
+    // Cache-related methods.
+    void set_cache_size(size_t);
+
+    size_t get_cache_size() const { return cache_limit; }
+
+    size_t get_cache_hits() const { return cache_hits; }
+
+    size_t get_cache_misses() const { return cache_misses; }
+
+    void clear_cache();
 private:
     Rcpp::RObject original;
     Rcpp::Environment beachenv;
     Rcpp::Function realizer;
-    
-    V storage; // this does not need to be copyable, as the entire object is replaced when a new block is loaded.
-    void update_storage_by_row(size_t, size_t, size_t);
-    void update_storage_by_col(size_t, size_t, size_t);
-    
-    size_t storage_start_row, storage_end_row, storage_start_col, storage_end_col; 
-    bool oncol;
 
-    Rcpp::IntegerVector row_chunk_bounds, col_chunk_bounds; // Read-only, does not need to be copyable.
-    size_t chunk_index;
+    /* Each chunk stores values in column-major format if 'bycol=true',
+     * otherwise it is transposed and effectively stored in row-major format.
+     * The storage does not need to be copyable, as it is never modified after realization.
+     */
+    struct cached_chunk {
+        bool bycol;
+        size_t primary_start, primary_end, secondary_start, secondary_end;
+        V storage;
+    };
 
-    static bool reload_chunk (size_t primary_value, size_t& primary_start, size_t& primary_end, 
-        size_t& primary_bound_index, const Rcpp::IntegerVector& primary_bounds, 
-        size_t secondary_val_1, size_t secondary_val_2, size_t& secondary_start, size_t& secondary_end); 
+    std::list<cached_chunk> cache; // most recently used chunk at the front.
+    size_t cache_used, cache_limit, cache_floor, cache_hits, cache_misses;
+
+    const cached_chunk& update_storage_by_row(size_t, size_t, size_t);
+    const cached_chunk& update_storage_by_col(size_t, size_t, size_t);
+    const cached_chunk& find_chunk(bool, size_t, size_t, size_t, const Rcpp::IntegerVector&);
+
+    Rcpp::IntegerVector row_chunk_bounds, col_chunk_bounds; // Read-only, does not need to be copyable.
 
     // Values to be passed to R functions for realization - entries are modifiable and so this needs to be copiable.
     copyable_holder<Rcpp::IntegerVector> indices, slices;
@@ -96,9 +120,7 @@ private:
 template<typename T, class V>
 unknown_reader<T, V>::unknown_reader(const Rcpp::RObject& in) : original(in), 
         beachenv(Rcpp::Environment::namespace_env("beachmat")), realizer(beachenv["realizeByRange"]), 
-        storage_start_row(0), storage_end_row(0), storage_start_col(0), storage_end_col(0), 
-        oncol(false), 
-        chunk_index(0),
+        cache_used(0), cache_limit(0), cache_floor(0), cache_hits(0), cache_misses(0),
         indices(2), slices(2), do_transpose(1) { 
 
     Rcpp::Function getdims(beachenv["setupUnknownMatrix"]);
@@ -110,6 +132,22 @@ unknown_reader<T, V>::unknown_reader(const Rcpp::RObject& in) : original(in),
     row_chunk_bounds=Rcpp::IntegerVector(dimdata[1]);
     col_chunk_bounds=Rcpp::IntegerVector(dimdata[2]);
 
+    /* The budget defaults to the automatic block size, but is always large enough
+     * to hold the largest row chunk and the largest column chunk at the same time.
+     * This ensures that alternating row and column access never re-realizes a chunk.
+     */
+    size_t max_row_chunk=0, max_col_chunk=0;
+    for (size_t i=1; i<row_chunk_bounds.size(); ++i) {
+        max_row_chunk=std::max(max_row_chunk, static_cast<size_t>(row_chunk_bounds[i] - row_chunk_bounds[i-1]));
+    }
+    for (size_t i=1; i<col_chunk_bounds.size(); ++i) {
+        max_col_chunk=std::max(max_col_chunk, static_cast<size_t>(col_chunk_bounds[i] - col_chunk_bounds[i-1]));
+    }
+    cache_floor=(max_row_chunk * this->ncol + max_col_chunk * this->nrow) * sizeof(T);
+
+    Rcpp::NumericVector blocksize(dimdata[3]);
+    cache_limit=std::max(static_cast<size_t>(blocksize[0]), cache_floor);
+
     do_transpose.vec[0]=1;
     return;
 }
@@ -117,116 +155,102 @@ unknown_reader<T, V>::unknown_reader(const Rcpp::RObject& in) : original(in),
 /* Define storage-related methods. */
 
 template<typename T, class V>
-bool unknown_reader<T, V>::reload_chunk (size_t primary_value, size_t& primary_start, size_t& primary_end, 
-        size_t& primary_bound_index, const Rcpp::IntegerVector& primary_bounds, 
-        size_t secondary_val_1, size_t secondary_val_2, size_t& secondary_start, size_t& secondary_end) { 
-
+const typename unknown_reader<T, V>::cached_chunk& unknown_reader<T, V>::find_chunk(bool bycol, size_t primary_value, 
+        size_t secondary_first, size_t secondary_last, const Rcpp::IntegerVector& primary_bounds) 
+{
     // We assume that all inputs are valid, as check_* functions are called upstream.
-    const bool is_below = (primary_value < primary_start),
-        is_above = (primary_value >= primary_end);
-    const bool reobtain_primary=(is_below || is_above);
-
-    // Determining which chunks to obtain on the primary dimension.
-    if (reobtain_primary) {
-        const int pval=primary_value;
-
-        if (is_below) { 
-            /* primary_bound_index always points at the end boundary of the current chunk.
-             * In this scope, primary_bound_index CANNOT be less than 2, 
-             * as is_below cannot be true if we're at the first chunk.
-             */
-            --primary_bound_index;
-            if (primary_bounds[primary_bound_index-1] > pval) { 
-                primary_bound_index=std::upper_bound(primary_bounds.begin() + 1, primary_bounds.begin() + primary_bound_index, pval) - primary_bounds.begin();
-            }
-            
-        } else { 
-            /* Note that the first search always ends up here as 'primary_start=primary_end=0'.
-             * This means that 'is_below' must be false while 'is_above' must be true. 
-             * We then increment primary_bound_index from 0 to 1, getting us to the first chunk.
-             */
-            ++primary_bound_index;
-            if (primary_bounds[primary_bound_index] <= pval) {
-                primary_bound_index=std::upper_bound(primary_bounds.begin() + primary_bound_index + 1, primary_bounds.end(), pval) - primary_bounds.begin();
+    for (auto it=cache.begin(); it!=cache.end(); ++it) {
+        if (it->bycol==bycol && 
+                primary_value >= it->primary_start && primary_value < it->primary_end &&
+                secondary_first >= it->secondary_start && secondary_last <= it->secondary_end) 
+        {
+            if (it!=cache.begin()) {
+                cache.splice(cache.begin(), cache, it);
             }
+            ++cache_hits;
+            return cache.front();
         }
+    }
+    ++cache_misses;
+
+    // Identifying the chunk containing the requested value along the primary dimension.
+    const size_t bound_index=std::upper_bound(primary_bounds.begin(), primary_bounds.end(), static_cast<int>(primary_value)) - primary_bounds.begin();
+
+    cached_chunk current;
+    current.bycol=bycol;
+    current.primary_start=primary_bounds[bound_index-1];
+    current.primary_end=primary_bounds[bound_index];
+    current.secondary_start=secondary_first;
+    current.secondary_end=secondary_last;
+
+    indices.vec[0] = current.primary_start;
+    indices.vec[1] = current.primary_end - current.primary_start;
+    slices.vec[0] = current.secondary_start; 
+    slices.vec[1] = current.secondary_end - current.secondary_start;
+    if (bycol) {
+        current.storage = realizer(original, slices.vec, indices.vec);
+    } else {
+        current.storage = realizer(original, indices.vec, slices.vec, do_transpose.vec); // Transposed, so storage is effectively row-major!
+    }
 
-        primary_end=primary_bounds[primary_bound_index];
-        primary_start=primary_bounds[primary_bound_index-1];
-
-    } else if (secondary_val_1 >= secondary_start && secondary_val_2 <= secondary_end) {
-        // If the requested values are a subset of those already cached, there's no need to reload the chunk.
-        return false;
+    // Evicting the least recently used chunks to make space, but always keeping the new chunk.
+    const size_t required=current.storage.size() * sizeof(T);
+    while (!cache.empty() && cache_used + required > cache_limit) {
+        cache_used -= cache.back().storage.size() * sizeof(T);
+        cache.pop_back();
     }
 
-    secondary_start=secondary_val_1;
-    secondary_end=secondary_val_2;
-    return true;
+    cache.push_front(std::move(current));
+    cache_used += required;
+    return cache.front();
 }
 
 template<typename T, class V>
-void unknown_reader<T, V>::update_storage_by_row(size_t r, size_t first, size_t last) {
-    if (oncol) { // reset values to force 'reload_chunk' to give 'true'.
-        storage_start_row=0;
-        storage_end_row=0;
-        chunk_index=0;
-        oncol=false;
-    }
-        
-    if (reload_chunk(r, storage_start_row, storage_end_row,
-                chunk_index, row_chunk_bounds,
-                first, last, storage_start_col, storage_end_col)) {
-
-        indices.vec[0] = storage_start_row; 
-        indices.vec[1] = storage_end_row - storage_start_row;
-        slices.vec[0] = storage_start_col;
-        slices.vec[1] = storage_end_col - storage_start_col;
-        storage = realizer(original, indices.vec, slices.vec, do_transpose.vec); // Transposed, so storage is effectively row-major!
-    }
-    return;
+const typename unknown_reader<T, V>::cached_chunk& unknown_reader<T, V>::update_storage_by_row(size_t r, size_t first, size_t last) {
+    return find_chunk(false, r, first, last, row_chunk_bounds);
 }
 
 template<typename T, class V>
-void unknown_reader<T, V>::update_storage_by_col(size_t c, size_t first, size_t last) {
-    if (!oncol) { // reset values to force 'reload_chunk' to give 'true'.
-        storage_start_col=0;
-        storage_end_col=0;
-        chunk_index=0;
-        oncol=true;
-    }
-
-    if (reload_chunk(c, storage_start_col, storage_end_col,
-                chunk_index, col_chunk_bounds, 
-                first, last, storage_start_row, storage_end_row)) {
+const typename unknown_reader<T, V>::cached_chunk& unknown_reader<T, V>::update_storage_by_col(size_t c, size_t first, size_t last) {
+    return find_chunk(true, c, first, last, col_chunk_bounds);
+}
 
-        indices.vec[0] = storage_start_col;
-        indices.vec[1] = storage_end_col - storage_start_col;
-        slices.vec[0] = storage_start_row; 
-        slices.vec[1] = storage_end_row - storage_start_row;
-        storage = realizer(original, slices.vec, indices.vec);
+template<typename T, class V>
+void unknown_reader<T, V>::set_cache_size(size_t limit) {
+    cache_limit=std::max(limit, cache_floor); // same floor as in the constructor.
+    while (cache.size() > 1 && cache_used > cache_limit) {
+        cache_used -= cache.back().storage.size() * sizeof(T);
+        cache.pop_back();
     }
     return;
 }
 
+template<typename T, class V>
+void unknown_reader<T, V>::clear_cache() {
+    cache.clear();
+    cache_used=0;
+    return;
+}
+
 /*** Basic getter methods ***/
 
 template<typename T, class V>
 T unknown_reader<T, V>::get(size_t r, size_t c) {
     check_oneargs(r, c);
-    update_storage_by_col(c, 0, this->nrow); // keeps the whole block for further 'get()' queries.
-    return storage[(c - storage_start_col) * this->nrow + r];
+    const auto& chunk=update_storage_by_col(c, 0, this->nrow); // keeps the whole block for further 'get()' queries.
+    return chunk.storage[(c - chunk.primary_start) * this->nrow + r];
 }
 
 template<typename T, class V>
 template <class Iter>
 void unknown_reader<T, V>::get_row(size_t r, Iter out, size_t first, size_t last) {
     check_rowargs(r, first, last);
-    update_storage_by_row(r, first, last);
+    const auto& chunk=update_storage_by_row(r, first, last);
 
     // It's effectively row-major storage due the transposition.
-    auto src=storage.begin() + 
-        (r - storage_start_row) * (storage_end_col - storage_start_col) +
-        (first - storage_start_col);
+    auto src=chunk.storage.begin() + 
+        (r - chunk.primary_start) * (chunk.secondary_end - chunk.secondary_start) +
+        (first - chunk.secondary_start);
     std::copy(src, src + (last - first), out);
     return;
 }
@@ -235,32 +259,45 @@ template<typename T, class V>
 template <class Iter>
 void unknown_reader<T, V>::get_col(size_t c, Iter out, size_t first, size_t last) {
     check_colargs(c, first, last);
-    update_storage_by_col(c, first, last);
+    const auto& chunk=update_storage_by_col(c, first, last);
 
-    auto src=storage.begin() + 
-        (c - storage_start_col) * (storage_end_row - storage_start_row) + 
-        (first - storage_start_row);
+    auto src=chunk.storage.begin() + 
+        (c - chunk.primary_start) * (chunk.secondary_end - chunk.secondary_start) + 
+        (first - chunk.secondary_start);
     std::copy(src, src + (last - first), out);
     return;
 }
 
 /*** Multi getter methods ***/
 
+/* The requested indices are strictly increasing, so we can sweep through them
+ * and group them by the chunk boundaries. Each group is served from a single
+ * cached (or newly realized) chunk, avoiding a separate R-level realization of 
+ * an arbitrary index set for every call.
+ */
+
 template<typename T, class V>
 template<class Iter>
 void unknown_reader<T, V>::get_rows(Rcpp::IntegerVector::iterator rIt, size_t n, Iter out, size_t first, size_t last) {
     check_rowargs(0, first, last);
     check_row_indices(rIt, n);
 
-    // Need to make a copy of the indexed (1-indexed) to pass to the function.
-    Rcpp::IntegerVector cur_indices(rIt, rIt+n);
-    for (auto& i : cur_indices) { ++i; }
-    slices.vec[0]=first;
-    slices.vec[1]=last-first;
-    
-    Rcpp::Function indexed_realizer(beachenv["realizeByIndexRange"]);
-    V tmp_store=indexed_realizer(original, cur_indices, slices.vec);
-    std::copy(tmp_store.begin(), tmp_store.end(), out);
+    const size_t nvals=last - first;
+    size_t i=0;
+    while (i < n) {
+        const auto& chunk=update_storage_by_row(rIt[i], first, last);
+        const size_t width=chunk.secondary_end - chunk.secondary_start;
+        const size_t offset=first - chunk.secondary_start;
+
+        // Storage is effectively row-major, while the output is column-major with 'n' rows.
+        for (; i < n && static_cast<size_t>(rIt[i]) < chunk.primary_end; ++i) {
+            auto src=chunk.storage.begin() + (rIt[i] - chunk.primary_start) * width + offset;
+            auto dest=out + i;
+            for (size_t j=0; j<nvals; ++j, ++src, dest+=n) {
+                *dest=*src;
+            }
+        }
+    }
     return;
 }
 
@@ -270,16 +307,18 @@ void unknown_reader<T, V>::get_cols(Rcpp::IntegerVector::iterator cIt, size_t n,
     check_colargs(0, first, last);
     check_col_indices(cIt, n);
 
-    // Need to make a copy of the indices (1-indexed) to pass to the function.
-    // Don't use row_indices.vec, avoid bugs upon interaction with update_storage().
-    Rcpp::IntegerVector cur_indices(cIt, cIt+n);
-    for (auto& i : cur_indices) { ++i; }
-    slices.vec[0]=first;
-    slices.vec[1]=last-first;
+    const size_t nvals=last - first;
+    size_t i=0;
+    while (i < n) {
+        const auto& chunk=update_storage_by_col(cIt[i], first, last);
+        const size_t width=chunk.secondary_end - chunk.secondary_start;
+        const size_t offset=first - chunk.secondary_start;
 
-    Rcpp::Function indexed_realizer(beachenv["realizeByRangeIndex"]);
-    V tmp_store=indexed_realizer(original, slices.vec, cur_indices);
-    std::copy(tmp_store.begin(), tmp_store.end(), out);
+        for (; i < n && static_cast<size_t>(cIt[i]) < chunk.primary_end; ++i) {
+            auto src=chunk.storage.begin() + (cIt[i] - chunk.primary_start) * width + offset;
+            std::copy(src, src + nvals, out + i * nvals);
+        }
+    }
     return;
 }
 
@@ -27,8 +27,8 @@ typedef simple_lin_matrix<int, Rcpp::IntegerVector> simple_integer_matrix;
 /* DelayedMatrix */
 
 template<>
-inline std::unique_ptr<integer_matrix> delayed_lin_reader<int, Rcpp::IntegerVector>::generate_seed(Rcpp::RObject incoming) {
-    return create_integer_matrix_internal(incoming, false);
+inline std::unique_ptr<integer_matrix> delayed_lin_reader<int, Rcpp::IntegerVector>::generate_seed(Rcpp::RObject incoming, bool delayed) {
+    return create_integer_matrix_internal(incoming, delayed);
 }
 
 typedef delayed_lin_matrix<int, Rcpp::IntegerVector> delayed_integer_matrix;
@@ -81,6 +81,10 @@ typedef lin_output<int, Rcpp::IntegerVector> integer_output;
 
 typedef simple_lin_output<int, Rcpp::IntegerVector> simple_integer_output;
 
+/* Output integer matrix in a RealizationSink */
+
+typedef sink_lin_output<int, Rcpp::IntegerVector> sink_integer_output;
+
 /* External output integer matrix */
 
 template<>
@@ -93,6 +97,8 @@ typedef external_lin_output<int, Rcpp::IntegerVector> external_integer_output;
 inline std::unique_ptr<integer_output> create_integer_output(int nrow, int ncol, const output_param& param) {
     if (param.is_external_available("integer")) { 
         return std::unique_ptr<integer_output>(new external_integer_output(nrow, ncol, param.get_package(), param.get_class()));
+    } else if (param.is_realization_sink()) {
+        return std::unique_ptr<integer_output>(new sink_integer_output(nrow, ncol, param.get_class()));
     }
      
     return std::unique_ptr<integer_output>(new simple_integer_output(nrow, ncol));
@@ -44,8 +44,8 @@ typedef Csparse_lin_matrix<int, Rcpp::LogicalVector> Csparse_logical_matrix;
 /* DelayedMatrix */
 
 template<>
-inline std::unique_ptr<logical_matrix> delayed_lin_reader<int, Rcpp::LogicalVector>::generate_seed(Rcpp::RObject incoming) {
-    return create_logical_matrix_internal(incoming, false);
+inline std::unique_ptr<logical_matrix> delayed_lin_reader<int, Rcpp::LogicalVector>::generate_seed(Rcpp::RObject incoming, bool delayed) {
+    return create_logical_matrix_internal(incoming, delayed);
 }
 
 typedef delayed_lin_matrix<int, Rcpp::LogicalVector> delayed_logical_matrix;
@@ -112,6 +112,12 @@ inline std::string Csparse_writer<int, Rcpp::LogicalVector>::get_class() { retur
 
 typedef sparse_lin_output<int, Rcpp::LogicalVector> sparse_logical_output;
 
+typedef spill_lin_output<int, Rcpp::LogicalVector> spill_logical_output;
+
+/* Output logical matrix in a RealizationSink */
+
+typedef sink_lin_output<int, Rcpp::LogicalVector> sink_logical_output;
+
 /* Simple output logical matrix */
 
 template<>
@@ -128,6 +134,13 @@ inline std::unique_ptr<logical_output> create_logical_output(int nrow, int ncol,
         if (param.get_class()=="lgCMatrix") {
             return std::unique_ptr<logical_output>(new sparse_logical_output(nrow, ncol));
         }
+    } else if (pkg=="beachmat") {
+        if (param.get_class()=="CsparseFile") {
+            auto details=get_Csparse_spill_details();
+            return std::unique_ptr<logical_output>(new spill_logical_output(nrow, ncol, details.second, details.first, true));
+        }
+    } else if (param.is_realization_sink()) {
+        return std::unique_ptr<logical_output>(new sink_logical_output(nrow, ncol, param.get_class()));
     } else if (param.is_external_available("logical")) {
         return std::unique_ptr<logical_output>(new external_logical_output(nrow, ncol, pkg, param.get_class()));
     }
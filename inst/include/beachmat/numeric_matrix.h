@@ -44,8 +44,8 @@ typedef Csparse_lin_matrix<double, Rcpp::NumericVector> Csparse_numeric_matrix;
 /* DelayedMatrix */
 
 template<>
-inline std::unique_ptr<numeric_matrix> delayed_lin_reader<double, Rcpp::NumericVector>::generate_seed(Rcpp::RObject incoming) {
-    return create_numeric_matrix_internal(incoming, false);
+inline std::unique_ptr<numeric_matrix> delayed_lin_reader<double, Rcpp::NumericVector>::generate_seed(Rcpp::RObject incoming, bool delayed) {
+    return create_numeric_matrix_internal(incoming, delayed);
 }
 
 typedef delayed_lin_matrix<double, Rcpp::NumericVector> delayed_numeric_matrix;
@@ -112,6 +112,12 @@ inline std::string Csparse_writer<double, Rcpp::NumericVector>::get_class() { re
 
 typedef sparse_lin_output<double, Rcpp::NumericVector> sparse_numeric_output;
 
+typedef spill_lin_output<double, Rcpp::NumericVector> spill_numeric_output;
+
+/* Output numeric matrix in a RealizationSink */
+
+typedef sink_lin_output<double, Rcpp::NumericVector> sink_numeric_output;
+
 /* External output numeric matrix */
 
 template<>
@@ -128,6 +134,13 @@ inline std::unique_ptr<numeric_output> create_numeric_output(int nrow, int ncol,
         if (param.get_class()=="dgCMatrix") {
             return std::unique_ptr<numeric_output>(new sparse_numeric_output(nrow, ncol));
         }
+    } else if (pkg=="beachmat") {
+        if (param.get_class()=="CsparseFile") {
+            auto details=get_Csparse_spill_details();
+            return std::unique_ptr<numeric_output>(new spill_numeric_output(nrow, ncol, details.second, details.first, true));
+        }
+    } else if (param.is_realization_sink()) {
+        return std::unique_ptr<numeric_output>(new sink_numeric_output(nrow, ncol, param.get_class()));
     } else if (param.is_external_available("numeric")) {
         return std::unique_ptr<numeric_output>(new external_numeric_output(nrow, ncol, pkg, param.get_class()));
     }
@@ -0,0 +1,474 @@
+#ifndef BEACHMAT_CSPARSE_SPILL_WRITER_H
+#define BEACHMAT_CSPARSE_SPILL_WRITER_H
+
+#include "Rcpp.h"
+
+#include "../utils/utils.h"
+#include "../utils/dim_checker.h"
+#include "Csparse_writer.h"
+#include "../../beachmat3/Csparse_file_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace beachmat {
+
+/* The 'Csparse_spill_writer' class buffers non-zero entries in a Csparse_writer,
+ * but flushes completed columns to temporary files on disk once the buffered
+ * entries exceed a memory budget. This allows us to create sparse matrices
+ * that are larger than the available memory, provided that the producer fills
+ * the matrix in column order - at most one budget's worth of entries (plus the
+ * current column) are held in memory at any time.
+ *
+ * Columns are considered to be complete once a later column is written, and
+ * only complete columns are flushed. Attempting to modify a flushed column
+ * is an error. If the producer writes columns out of order (e.g., by row),
+ * the writer never flushes and simply behaves like a Csparse_writer.
+ *
+ * Upon yield(), the matrix is either assembled into a *gCMatrix, or written
+ * into a CSC file at 'path' and returned as a CsparseFile. The latter is created
+ * with the writer in beachmat3/Csparse_file_format.h, by transferring one column
+ * at a time from the temporary files so the full matrix is never held in memory.
+ * The temporary files are kept until destruction so that the writer can still
+ * be queried after yield(), as with the other output classes.
+ */
+
+/*** Setting up the output file ***/
+
+/* Gets the path to the CSC file and the memory budget in bytes from R, 
+ * which respectively default to a temporary file and the block size.
+ */
+inline std::pair<std::string, size_t> get_Csparse_spill_details() {
+    Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
+    Rcpp::Function setup(beachenv["setupCsparseOutput"]);
+    Rcpp::List details=setup();
+    if (details.size()!=2) {
+        throw std::runtime_error("output of beachmat:::setupCsparseOutput should be a list of length 2");
+    }
+
+    Rcpp::NumericVector budget(details[1]);
+    if (budget.size()!=1) {
+        throw std::runtime_error("memory budget should be a numeric scalar");
+    }
+    return std::make_pair(make_to_string(details[0]), static_cast<size_t>(budget[0]));
+}
+
+/*** Class definition ***/
+
+template<typename T, class V>
+class Csparse_spill_writer : public dim_checker {
+public:
+    Csparse_spill_writer(size_t, size_t, size_t, const std::string&, bool);
+    ~Csparse_spill_writer();
+
+    // Copying is only possible before anything is flushed, as the temporary files cannot be shared.
+    Csparse_spill_writer(const Csparse_spill_writer&);
+    Csparse_spill_writer& operator=(const Csparse_spill_writer&);
+    Csparse_spill_writer(Csparse_spill_writer&&) = default;
+    Csparse_spill_writer& operator=(Csparse_spill_writer&&);
+
+    // Setters:
+    template <class Iter>
+    void set_row(size_t, Iter, size_t, size_t);
+
+    template <class Iter>
+    void set_col(size_t, Iter, size_t, size_t);
+
+    void set(size_t, size_t, T);
+
+    template <class Iter>
+    void set_col_indexed(size_t, size_t, Rcpp::IntegerVector::iterator, Iter);
+
+    template <class Iter>
+    void set_row_indexed(size_t, size_t, Rcpp::IntegerVector::iterator, Iter);
+
+    // Getters:
+    template <class Iter>
+    void get_col(size_t, Iter, size_t, size_t);
+
+    template <class Iter>
+    void get_row(size_t, Iter, size_t, size_t);
+
+    T get(size_t, size_t);
+
+    // Other:
+    size_t get_nflushed() const { return nflushed; }
+
+    Rcpp::RObject yield();
+
+    std::string get_class() const { return (file_backed ? "CsparseFile" : Csparse_writer<T, V>::get_class()); }
+
+    std::string get_package() const { return (file_backed ? "beachmat" : Csparse_writer<T, V>::get_package()); }
+private:
+    Csparse_writer<T, V> buffer;
+    size_t budget;
+    std::string path;
+    bool file_backed;
+
+    // Tracking the order in which columns are written.
+    bool ordered=true;
+    size_t highest=0;
+
+    // Temporary files for the row indices and values of the flushed columns.
+    size_t nflushed=0;
+    std::vector<uint64_t> pointers;
+    std::unique_ptr<std::fstream> index_spill, value_spill;
+    std::vector<int> index_work;
+    std::vector<T> value_work;
+
+    // Dense row-major cache of flushed columns [cache_cfirst, cache_clast) for rows [cache_rstart, cache_rend).
+    size_t cache_rstart=0, cache_rend=0, cache_cfirst=0, cache_clast=0;
+    std::vector<T> row_cache;
+
+    std::string index_path() const { return path + ".i.tmp"; }
+    std::string value_path() const { return path + ".x.tmp"; }
+
+    static size_t entry_size() { return sizeof(int) + sizeof(T); }
+
+    void prepare_write(size_t, size_t);
+    void flush(size_t);
+    void read_flushed(size_t);
+    void fill_row_cache(size_t, size_t, size_t);
+    void remove_spills();
+    Rcpp::RObject yield_file();
+};
+
+/*** Constructor definitions ***/
+
+template<typename T, class V>
+Csparse_spill_writer<T, V>::Csparse_spill_writer(size_t nr, size_t nc, size_t b, const std::string& p, bool f) :
+    dim_checker(nr, nc), buffer(nr, nc), budget(b), path(p), file_backed(f), pointers(1)
+{
+    if (nr > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("number of rows should fit into a 32-bit signed integer");
+    }
+    return;
+}
+
+template<typename T, class V>
+Csparse_spill_writer<T, V>::~Csparse_spill_writer() {
+    remove_spills();
+}
+
+template<typename T, class V>
+Csparse_spill_writer<T, V>::Csparse_spill_writer(const Csparse_spill_writer& other) :
+    dim_checker(other), buffer(other.buffer), budget(other.budget), path(other.path), file_backed(other.file_backed),
+    ordered(other.ordered), highest(other.highest), pointers(other.pointers)
+{
+    if (other.index_spill) {
+        throw std::runtime_error("cannot copy a sparse writer after columns have been flushed to disk");
+    }
+    return;
+}
+
+template<typename T, class V>
+Csparse_spill_writer<T, V>& Csparse_spill_writer<T, V>::operator=(const Csparse_spill_writer& other) {
+    Csparse_spill_writer copy(other);
+    *this=std::move(copy);
+    return *this;
+}
+
+template<typename T, class V>
+Csparse_spill_writer<T, V>& Csparse_spill_writer<T, V>::operator=(Csparse_spill_writer&& other) {
+    if (this!=&other) {
+        remove_spills(); // otherwise, our temporary files would be left behind.
+        dim_checker::operator=(other);
+        buffer=std::move(other.buffer);
+        budget=other.budget;
+        path=std::move(other.path);
+        file_backed=other.file_backed;
+        ordered=other.ordered;
+        highest=other.highest;
+        nflushed=other.nflushed;
+        pointers=std::move(other.pointers);
+        index_spill=std::move(other.index_spill);
+        value_spill=std::move(other.value_spill);
+        cache_rstart=other.cache_rstart;
+        cache_rend=other.cache_rend;
+        cache_cfirst=other.cache_cfirst;
+        cache_clast=other.cache_clast;
+        row_cache=std::move(other.row_cache);
+    }
+    return *this;
+}
+
+/*** Spilling methods ***/
+
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::prepare_write(size_t lo, size_t hi) {
+    if (lo < nflushed) {
+        throw std::runtime_error("cannot modify columns that have already been flushed to disk");
+    }
+
+    if (lo < highest) {
+        ordered=false;
+    } else if (ordered && buffer.get_nentries() * entry_size() > budget) {
+        flush(lo);
+    }
+
+    highest=std::max(highest, hi);
+    return;
+}
+
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::flush(size_t end) {
+    if (end <= nflushed) {
+        return;
+    }
+
+    if (!index_spill) {
+        const auto mode=std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc;
+        index_spill.reset(new std::fstream(index_path(), mode));
+        value_spill.reset(new std::fstream(value_path(), mode));
+        if (!(*index_spill) || !(*value_spill)) {
+            throw std::runtime_error(std::string("failed to open temporary files for '") + path + "'");
+        }
+    }
+
+    index_spill->seekp(0, std::ios::end);
+    value_spill->seekp(0, std::ios::end);
+    for (; nflushed < end; ++nflushed) {
+        buffer.release_col(nflushed, index_work, value_work);
+        index_spill->write(reinterpret_cast<const char*>(index_work.data()), sizeof(int) * index_work.size());
+        value_spill->write(reinterpret_cast<const char*>(value_work.data()), sizeof(T) * value_work.size());
+        pointers.push_back(pointers.back() + index_work.size());
+    }
+
+    if (!(*index_spill) || !(*value_spill)) {
+        throw std::runtime_error(std::string("failed to write temporary files for '") + path + "'");
+    }
+
+    // Releasing the memory held by the workspaces.
+    std::vector<int>().swap(index_work);
+    std::vector<T>().swap(value_work);
+    return;
+}
+
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::read_flushed(size_t c) {
+    const size_t start=pointers[c], n=pointers[c+1] - start;
+    index_work.resize(n);
+    value_work.resize(n);
+    index_spill->seekg(sizeof(int) * start);
+    index_spill->read(reinterpret_cast<char*>(index_work.data()), sizeof(int) * n);
+    value_spill->seekg(sizeof(T) * start);
+    value_spill->read(reinterpret_cast<char*>(value_work.data()), sizeof(T) * n);
+    if (!(*index_spill) || !(*value_spill)) {
+        throw std::runtime_error(std::string("failed to read temporary files for '") + path + "'");
+    }
+    return;
+}
+
+/* Reading each flushed column once for a block of rows, rather than once per
+ * requested row. The number of rows is chosen so that the cache fits in the
+ * memory budget; flushed columns cannot be modified, so the cache never needs
+ * to be invalidated. 
+ */
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::fill_row_cache(size_t r, size_t first, size_t last) {
+    if (r >= cache_rstart && r < cache_rend && first >= cache_cfirst && last <= cache_clast) {
+        return;
+    }
+
+    const size_t width=last - first;
+    const size_t nrows=std::min(this->nrow - r, std::max(static_cast<size_t>(1), budget / (sizeof(T) * width)));
+    cache_rstart=r;
+    cache_rend=r + nrows;
+    cache_cfirst=first;
+    cache_clast=last;
+    row_cache.assign(nrows * width, Csparse_writer<T, V>::get_empty());
+
+    for (size_t c=first; c<last; ++c) {
+        read_flushed(c);
+        auto start=std::lower_bound(index_work.begin(), index_work.end(), static_cast<int>(cache_rstart));
+        for (auto iIt=start; iIt!=index_work.end() && static_cast<size_t>(*iIt) < cache_rend; ++iIt) {
+            row_cache[(*iIt - cache_rstart) * width + (c - first)]=value_work[iIt - index_work.begin()];
+        }
+    }
+    return;
+}
+
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::remove_spills() {
+    if (index_spill) {
+        index_spill.reset();
+        value_spill.reset();
+        std::remove(index_path().c_str());
+        std::remove(value_path().c_str());
+    }
+    return;
+}
+
+/*** Setter methods ***/
+
+template<typename T, class V>
+template<class Iter>
+void Csparse_spill_writer<T, V>::set_col(size_t c, Iter in, size_t first, size_t last) {
+    check_colargs(c, first, last);
+    prepare_write(c, c);
+    buffer.set_col(c, in, first, last);
+    return;
+}
+
+template<typename T, class V>
+template<class Iter>
+void Csparse_spill_writer<T, V>::set_row(size_t r, Iter in, size_t first, size_t last) {
+    check_rowargs(r, first, last);
+    if (first < last) {
+        prepare_write(first, last - 1);
+        buffer.set_row(r, in, first, last);
+    }
+    return;
+}
+
+template<typename T, class V>
+void Csparse_spill_writer<T, V>::set(size_t r, size_t c, T in) {
+    check_oneargs(r, c);
+    prepare_write(c, c);
+    buffer.set(r, c, in);
+    return;
+}
+
+template<typename T, class V>
+template <class Iter>
+void Csparse_spill_writer<T, V>::set_col_indexed(size_t c, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
+    check_colargs(c);
+    prepare_write(c, c);
+    buffer.set_col_indexed(c, n, idx, in);
+    return;
+}
+
+template<typename T, class V>
+template <class Iter>
+void Csparse_spill_writer<T, V>::set_row_indexed(size_t r, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
+    check_rowargs(r);
+    if (n) {
+        auto range=std::minmax_element(idx, idx + n);
+        check_colargs(*range.first);
+        check_colargs(*range.second);
+        prepare_write(*range.first, *range.second);
+        buffer.set_row_indexed(r, n, idx, in);
+    }
+    return;
+}
+
+/*** Getter methods ***/
+
+template<typename T, class V>
+template<class Iter>
+void Csparse_spill_writer<T, V>::get_col(size_t c, Iter out, size_t first, size_t last) {
+    if (c >= nflushed) {
+        buffer.get_col(c, out, first, last);
+        return;
+    }
+
+    check_colargs(c, first, last);
+    std::fill(out, out + (last - first), Csparse_writer<T, V>::get_empty());
+    read_flushed(c);
+    auto start=std::lower_bound(index_work.begin(), index_work.end(), static_cast<int>(first));
+    for (auto iIt=start; iIt!=index_work.end() && static_cast<size_t>(*iIt) < last; ++iIt) {
+        *(out + (*iIt - first))=value_work[iIt - index_work.begin()];
+    }
+    return;
+}
+
+template<typename T, class V>
+template<class Iter>
+void Csparse_spill_writer<T, V>::get_row(size_t r, Iter out, size_t first, size_t last) {
+    check_rowargs(r, first, last);
+    const size_t split=std::max(first, std::min(last, nflushed));
+    if (first < split) {
+        fill_row_cache(r, first, split);
+        auto src=row_cache.begin() + (r - cache_rstart) * (cache_clast - cache_cfirst) + (first - cache_cfirst);
+        out=std::copy(src, src + (split - first), out);
+    }
+    if (split < last) {
+        buffer.get_row(r, out, split, last);
+    }
+    return;
+}
+
+template<typename T, class V>
+T Csparse_spill_writer<T, V>::get(size_t r, size_t c) {
+    if (c >= nflushed) {
+        return buffer.get(r, c);
+    }
+
+    check_oneargs(r, c);
+    read_flushed(c);
+    auto loc=std::lower_bound(index_work.begin(), index_work.end(), static_cast<int>(r));
+    if (loc!=index_work.end() && *loc==static_cast<int>(r)) {
+        return value_work[loc - index_work.begin()];
+    }
+    return Csparse_writer<T, V>::get_empty();
+}
+
+/*** Output functions ***/
+
+template<typename T, class V>
+Rcpp::RObject Csparse_spill_writer<T, V>::yield() {
+    if (file_backed) {
+        return yield_file();
+    }
+    if (!index_spill) {
+        return buffer.yield();
+    }
+
+    flush(this->ncol);
+    const size_t total=pointers.back();
+    if (total > static_cast<size_t>(std::numeric_limits<int>::max())) {
+        throw std::runtime_error("number of non-zero elements exceeds the capacity of a *gCMatrix");
+    }
+
+    std::string classname=Csparse_writer<T, V>::get_class();
+    Rcpp::S4 mat(classname);
+    for (auto slotname : { "Dim", "p", "i", "x" }) {
+        if (!mat.hasSlot(slotname)) {
+            throw std::runtime_error(std::string("missing '") + slotname + "' slot in " + classname + " object");
+        }
+    }
+    mat.slot("Dim")=Rcpp::IntegerVector::create(this->nrow, this->ncol);
+    mat.slot("p")=Rcpp::IntegerVector(pointers.begin(), pointers.end());
+
+    std::vector<int> indices(total);
+    std::vector<T> values(total);
+    index_spill->seekg(0);
+    index_spill->read(reinterpret_cast<char*>(indices.data()), sizeof(int) * total);
+    value_spill->seekg(0);
+    value_spill->read(reinterpret_cast<char*>(values.data()), sizeof(T) * total);
+    if (!(*index_spill) || !(*value_spill)) {
+        throw std::runtime_error(std::string("failed to read temporary files for '") + path + "'");
+    }
+    mat.slot("i")=Rcpp::IntegerVector(indices.begin(), indices.end());
+    mat.slot("x")=V(values.begin(), values.end());
+    return SEXP(mat);
+}
+
+template<typename T, class V>
+Rcpp::RObject Csparse_spill_writer<T, V>::yield_file() {
+    flush(this->ncol);
+
+    // Transferring each column from the temporary files, so the full matrix is never held in memory.
+    Csparse_file_writer out(path, this->nrow, this->ncol, pointers.back(), V().sexp_type());
+    for (size_t c=0; c<this->ncol; ++c) {
+        read_flushed(c);
+        out.add_column(index_work.data(), value_work.data(), index_work.size());
+    }
+    out.finish();
+
+    Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
+    Rcpp::Function constructor(beachenv["CsparseFile"]);
+    return constructor(Rcpp::StringVector::create(path), Rcpp::LogicalVector::create(false)); // no need to validate our own file.
+}
+
+}
+
+#endif
@@ -8,13 +8,19 @@
 
 #include <utility>
 #include <vector>
-#include <deque>
 #include <algorithm>
 
 namespace beachmat { 
 
 /*** Class definition ***/
 
+/* Each column is stored as a pair of compact vectors of row indices and values.
+ * New entries are appended to the end of each column, without any attempt to 
+ * keep the column sorted. Columns are only sorted and deduplicated (with 
+ * last-write-wins) when values are requested from that column, when compact()
+ * is called or when the final matrix is yielded.
+ */
+
 template<typename T, class V>
 class Csparse_writer : public dim_checker {
 public:
@@ -50,26 +56,55 @@ public:
     T get(size_t, size_t);
 
     // Other:
+    void compact();
+
+    // Number of stored entries, including overwritten entries that have not yet been compacted.
+    size_t get_nentries() const { return nentries; }
+
+    // Moves the compacted contents of a column into 'index' and 'value', leaving the column empty.
+    void release_col(size_t, std::vector<int>&, std::vector<T>&);
+
     Rcpp::RObject yield();
 
     static std::string get_class();
 
     static std::string get_package() { return "Matrix"; }
-private:
-    typedef std::pair<size_t, T> data_pair;
-    std::vector<std::deque<data_pair> > data;
 
     // What is an empty value?
     static T get_empty();
+private:
+    struct column {
+        std::vector<int> index;
+        std::vector<T> value;
+        size_t nsorted=0; // length of the sorted and deduplicated prefix.
+
+        // Returns the number of new entries.
+        size_t append(int r, T val) {
+            const bool in_order=(nsorted==index.size());
+            if (in_order && !index.empty() && index.back()==r) {
+                value.back()=val;
+                return 0;
+            }
+            if (in_order && (index.empty() || index.back() < r)) {
+                ++nsorted;
+            }
+            index.push_back(r);
+            value.push_back(val);
+            return 1;
+        }
+    };
 
-    // Only comparing the first value.
-    static bool only_first_less(const data_pair& lhs, const data_pair& rhs) { return lhs.first < rhs.first; }
+    std::vector<column> data;
+    std::vector<size_t> order;
+    size_t nentries=0;
 
-    template <class Iter>
-    static Iter find_matching_row(Iter, Iter, const data_pair&);
+    // Sorts and deduplicates the unsorted entries of a column, with later entries taking precedence.
+    void compact_column(column&);
 
-    // General column insertions.
-    static void insert_into_column(std::deque<data_pair>&, size_t, T);
+    // Position of the first entry with row index not less than 'r', in a compacted column.
+    static size_t find_matching_row(const column& current, size_t r) {
+        return std::lower_bound(current.index.begin(), current.index.end(), static_cast<int>(r)) - current.index.begin();
+    }
 };
 
 /*** Constructor definition ***/
@@ -77,73 +112,122 @@ private:
 template<typename T, class V>
 Csparse_writer<T, V>::Csparse_writer(size_t nr, size_t nc) : dim_checker(nr, nc), data(nc) {}
 
-/*** Setter methods ***/
+/*** Compaction methods ***/
 
 template<typename T, class V>
-template<class Iter>
-void Csparse_writer<T, V>::set_col(size_t c, Iter in, size_t first, size_t last) {
-    check_colargs(c, first, last);
-    std::deque<data_pair>& current=data[c];
-    std::deque<data_pair> new_set;
-
-    // Filling in all elements before start.
-    auto cIt=current.begin(); 
-    while (cIt!=current.end() && cIt->first < first) {
-        new_set.push_back(*cIt);
-        ++cIt;
+void Csparse_writer<T, V>::compact_column(column& current) {
+    const size_t ntotal=current.index.size(), nsorted=current.nsorted;
+    if (nsorted==ntotal) {
+        return;
     }
-   
-    // Filling in all non-empty elements. 
-    for (size_t index=first; index<last; ++index, ++in) {
-        if ((*in)!=get_empty()) { 
-            new_set.push_back(data_pair(index, *in));
-        }
-    } 
 
-    // Jumping to the end.
-    while (cIt!=current.end() && cIt->first < last) {
-        ++cIt;
+    // Stable sorting retains the order of writes, so the last entry of each run of identical indices wins.
+    order.resize(ntotal - nsorted);
+    for (size_t i=0; i<order.size(); ++i) {
+        order[i]=nsorted + i;
+    }
+    const auto& index=current.index;
+    std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) -> bool { return index[left] < index[right]; });
+
+    size_t nunique=0;
+    for (size_t i=0; i<order.size(); ++i) {
+        if (i+1 < order.size() && index[order[i]]==index[order[i+1]]) {
+            continue;
+        }
+        order[nunique]=order[i];
+        ++nunique;
     }
 
-    // Filling in remaining elements.
-    while (cIt!=current.end()) {
-        new_set.push_back(*cIt);
-        ++cIt;
+    // Merging with the sorted prefix, where unsorted entries were written later and take precedence.
+    std::vector<int> new_index;
+    std::vector<T> new_value;
+    new_index.reserve(nsorted + nunique);
+    new_value.reserve(nsorted + nunique);
+
+    size_t s=0, u=0;
+    while (s < nsorted || u < nunique) {
+        if (u==nunique || (s < nsorted && index[s] < index[order[u]])) {
+            new_index.push_back(index[s]);
+            new_value.push_back(current.value[s]);
+            ++s;
+        } else {
+            if (s < nsorted && index[s]==index[order[u]]) {
+                ++s;
+            }
+            new_index.push_back(index[order[u]]);
+            new_value.push_back(current.value[order[u]]);
+            ++u;
+        }
     }
 
-    current.swap(new_set);
+    nentries-=ntotal - new_index.size();
+    current.index.swap(new_index);
+    current.value.swap(new_value);
+    current.nsorted=current.index.size();
     return;
 }
 
 template<typename T, class V>
-template <class Iter>
-Iter Csparse_writer<T, V>::find_matching_row(Iter begin, Iter end, const data_pair& incoming) {
-    return std::lower_bound(begin, end, incoming, only_first_less);
+void Csparse_writer<T, V>::compact() {
+    for (auto& current : data) {
+        compact_column(current);
+    }
+    return;
 }
 
 template<typename T, class V>
-void Csparse_writer<T, V>::insert_into_column(std::deque<data_pair>& column, size_t r, T val) {
-    if (column.size()) {
-        if (r < column.front().first) {
-            column.push_front(data_pair(r, val));
-        } else if (r==column.front().first) {
-            column.front().second=val;
-        } else if (r > column.back().first) {
-            column.push_back(data_pair(r, val));
-        } else if (r==column.back().first) {
-            column.back().second=val;
-        } else {
-            data_pair incoming(r, val);
-            auto insert_loc=find_matching_row(column.begin(), column.end(), incoming);
-            if (insert_loc!=column.end() && insert_loc->first==r) { 
-                insert_loc->second=val;
-            } else {
-                column.insert(insert_loc, incoming);
+void Csparse_writer<T, V>::release_col(size_t c, std::vector<int>& index, std::vector<T>& value) {
+    check_colargs(c);
+    column& current=data[c];
+    compact_column(current);
+    nentries-=current.index.size();
+
+    index.clear();
+    value.clear();
+    index.swap(current.index);
+    value.swap(current.value);
+    current.nsorted=0;
+    return;
+}
+
+/*** Setter methods ***/
+
+template<typename T, class V>
+template<class Iter>
+void Csparse_writer<T, V>::set_col(size_t c, Iter in, size_t first, size_t last) {
+    check_colargs(c, first, last);
+    column& current=data[c];
+
+    // Fast path when the column is being filled in order.
+    if (current.nsorted==current.index.size() && (current.index.empty() || static_cast<size_t>(current.index.back()) < first)) {
+        for (size_t index=first; index<last; ++index, ++in) {
+            if ((*in)!=get_empty()) { 
+                nentries+=current.append(index, *in);
             }
         }
-    } else {
-        column.push_back(data_pair(r, val));
+        return;
     }
+
+    // Otherwise, replacing all existing entries in [first, last).
+    compact_column(current);
+    const size_t start=find_matching_row(current, first), end=find_matching_row(current, last);
+
+    std::vector<int> new_index(current.index.begin(), current.index.begin() + start);
+    std::vector<T> new_value(current.value.begin(), current.value.begin() + start);
+    for (size_t index=first; index<last; ++index, ++in) {
+        if ((*in)!=get_empty()) { 
+            new_index.push_back(index);
+            new_value.push_back(*in);
+        }
+    } 
+    new_index.insert(new_index.end(), current.index.begin() + end, current.index.end());
+    new_value.insert(new_value.end(), current.value.begin() + end, current.value.end());
+
+    nentries+=new_index.size();
+    nentries-=current.index.size();
+    current.index.swap(new_index);
+    current.value.swap(new_value);
+    current.nsorted=current.index.size();
     return;
 }
 
@@ -153,7 +237,7 @@ void Csparse_writer<T, V>::set_row(size_t r, Iter in, size_t first, size_t last)
     check_rowargs(r, first, last);
     for (size_t c=first; c<last; ++c, ++in) {
         if ((*in)==get_empty()) { continue; }
-        insert_into_column(data[c], r, *in);
+        nentries+=data[c].append(r, *in);
     }
     return;
 }
@@ -169,22 +253,10 @@ template<typename T, class V>
 template <class Iter>
 void Csparse_writer<T, V>::set_col_indexed(size_t c, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
     check_colargs(c);
-    std::deque<data_pair>& current=data[c];
+    column& current=data[c];
     for (size_t i=0; i<n; ++i, ++idx, ++in) { 
-        current.push_back(data_pair(*idx, *in));
-    }
-
-    std::stable_sort(current.begin(), current.end(), only_first_less);
-    std::deque<data_pair> survivors;
-    auto cIt=current.begin();
-    while (cIt!=current.end()) { 
-        auto first=cIt->first; 
-        ++cIt;
-        while (cIt!=current.end() && cIt->first==first) { ++cIt; }
-        survivors.push_back(*(cIt-1));
+        nentries+=current.append(*idx, *in);
     }
-
-    current.swap(survivors);
     return;
 }
 
@@ -193,7 +265,7 @@ template <class Iter>
 void Csparse_writer<T, V>::set_row_indexed(size_t r, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
     check_rowargs(r);
     for (size_t i=0; i<n; ++i, ++idx, ++in) { 
-        insert_into_column(data[*idx], r, *in);
+        nentries+=data[*idx].append(r, *in);
     }
     return;
 }
@@ -209,21 +281,14 @@ void Csparse_writer<T, V>::get_row(size_t r, Iter out, size_t first, size_t last
     std::fill(out, out+last-first, get_empty());
 
     for (size_t col=first; col<last; ++col, ++out) {
-        const std::deque<data_pair>& current=data[col];
-        if (current.empty() || r>current.back().first || r<current.front().first) {
+        column& current=data[col];
+        compact_column(current);
+        if (current.index.empty() || static_cast<int>(r) > current.index.back() || static_cast<int>(r) < current.index.front()) {
             continue; 
         }
-        if (r==current.back().first) { 
-            (*out)=current.back().second;
-        } else if (r==current.front().first) {
-            (*out)=current.front().second;
-        } else {
-            // (*out) is equivalent to get_empty(), due to fill; not that it matters, 
-            // as find_matching_row() will only use the first value anyway.
-            auto loc=find_matching_row(current.begin(), current.end(), data_pair(r, *out)); 
-            if (loc!=current.end() && loc->first==r) { 
-                (*out)=loc->second;
-            }
+        auto loc=find_matching_row(current, r);
+        if (current.index[loc]==static_cast<int>(r)) { 
+            (*out)=current.value[loc];
         }
     }
     return;
@@ -233,18 +298,12 @@ template<typename T, class V>
 template<class Iter>
 void Csparse_writer<T, V>::get_col(size_t c, Iter out, size_t first, size_t last) {
     check_colargs(c, first, last);
-    const std::deque<data_pair>& current=data[c];
+    column& current=data[c];
+    compact_column(current);
 
-    // Jumping forwards.
-    auto cIt=current.begin();
-    if (first) {
-        cIt=find_matching_row(current.begin(), current.end(), data_pair(first, get_empty()));
-    }
-    
     std::fill(out, out+last-first, get_empty());
-    while (cIt!=current.end() && cIt->first < last) { 
-        *(out + (cIt->first - first)) = cIt->second;
-        ++cIt;
+    for (size_t i=find_matching_row(current, first); i<current.index.size() && static_cast<size_t>(current.index[i]) < last; ++i) {
+        *(out + (current.index[i] - first)) = current.value[i];
     }
     return;
 }
@@ -252,10 +311,11 @@ void Csparse_writer<T, V>::get_col(size_t c, Iter out, size_t first, size_t last
 template<typename T, class V>
 T Csparse_writer<T, V>::get(size_t r, size_t c) {
     check_oneargs(r, c);
-    const std::deque<data_pair>& current=data[c];
-    auto cIt=find_matching_row(current.begin(), current.end(), data_pair(r, get_empty()));
-    if (cIt!=current.end() && cIt->first==r) {
-        return cIt->second;
+    column& current=data[c];
+    compact_column(current);
+    auto loc=find_matching_row(current, r);
+    if (loc!=current.index.size() && current.index[loc]==static_cast<int>(r)) {
+        return current.value[loc];
     } else {
         return get_empty();
     }
@@ -278,11 +338,12 @@ Rcpp::RObject Csparse_writer<T, V>::yield() {
     if (!mat.hasSlot("p")) {
         throw std::runtime_error(std::string("missing 'p' slot in ") + classname + " object");
     }
+    compact();
     Rcpp::IntegerVector p(this->ncol+1, 0);
     auto pIt=p.begin()+1;
     size_t total_size=0;
     for (auto dIt=data.begin(); dIt!=data.end(); ++dIt, ++pIt) { 
-        total_size+=dIt->size();
+        total_size+=dIt->index.size();
         (*pIt)=total_size;
     }
     mat.slot("p")=p;
@@ -298,12 +359,9 @@ Rcpp::RObject Csparse_writer<T, V>::yield() {
     }
     auto xIt=x.begin();
     auto iIt=i.begin();
-    for (size_t c=0; c<this->ncol; ++c) {
-        auto current=data[c];
-        for (auto cIt=current.begin(); cIt!=current.end(); ++cIt, ++xIt, ++iIt) {
-            (*iIt)=cIt->first;
-            (*xIt)=cIt->second;
-        }
+    for (const auto& current : data) {
+        iIt=std::copy(current.index.begin(), current.index.end(), iIt);
+        xIt=std::copy(current.value.begin(), current.value.end(), xIt);
     }
     mat.slot("i")=i;
     mat.slot("x")=x;
@@ -5,11 +5,14 @@
 
 #include "simple_writer.h"
 #include "Csparse_writer.h"
+#include "Csparse_spill_writer.h"
+#include "sink_writer.h"
 #include "external_writer.h"
 #include "output_param.h"
 #include "../utils/utils.h"
 
 #include <memory>
+#include <utility>
 
 namespace beachmat { 
 
@@ -131,7 +134,7 @@ public:
 
     std::string get_package() const { return writer.get_package(); }
 protected:
-    general_lin_output(WTR&& w) : writer(w) {}
+    general_lin_output(WTR&& w) : writer(std::move(w)) {}
     WTR writer;
 };
 
@@ -145,6 +148,34 @@ using simple_lin_output=general_lin_output<T, V, simple_writer<T, V> >;
 template<typename T, class V>
 using sparse_lin_output=general_lin_output<T, V, Csparse_writer<T, V> >;
 
+/* Sparse LIN output with spilling to disk */
+
+template<typename T, class V>
+class spill_lin_output : public general_lin_output<T, V, Csparse_spill_writer<T, V> > {
+public:
+    spill_lin_output(size_t nr, size_t nc, size_t budget, const std::string& path, bool file_backed) :
+        general_lin_output<T, V, Csparse_spill_writer<T, V> >(Csparse_spill_writer<T, V>(nr, nc, budget, path, file_backed)) {}
+    ~spill_lin_output() = default;
+    spill_lin_output(const spill_lin_output&) = default;
+    spill_lin_output& operator=(const spill_lin_output&) = default;
+    spill_lin_output(spill_lin_output&&) = default;
+    spill_lin_output& operator=(spill_lin_output&&) = default;
+};
+
+/* LIN output into a RealizationSink */
+
+template<typename T, class V>
+class sink_lin_output : public general_lin_output<T, V, sink_writer<T, V> > {
+public:
+    sink_lin_output(size_t nr, size_t nc, const std::string& backend) :
+        general_lin_output<T, V, sink_writer<T, V> >(sink_writer<T, V>(nr, nc, backend)) {}
+    ~sink_lin_output() = default;
+    sink_lin_output(const sink_lin_output&) = default;
+    sink_lin_output& operator=(const sink_lin_output&) = default;
+    sink_lin_output(sink_lin_output&&) = default;
+    sink_lin_output& operator=(sink_lin_output&&) = default;
+};
+
 /* External LIN output */
 
 template<typename T, class V>
@@ -9,7 +9,18 @@ namespace beachmat {
 
 class output_param {
 public:
-    output_param() {} // TODO: add option to fetch getRealizationBackend().
+    // Respecting any realization backend that has been set in DelayedArray.
+    output_param() {
+        Rcpp::Environment delayenv=Rcpp::Environment::namespace_env("DelayedArray");
+        Rcpp::Function getter(delayenv["getAutoRealizationBackend"]);
+        Rcpp::RObject backend=getter();
+        if (!backend.isNULL()) {
+            cls=make_to_string(backend);
+            pkg="DelayedArray";
+            sink=true;
+        }
+        return;
+    }
 
     output_param(const std::string& m, const std::string& p) : cls(m), pkg(p) {}
 
@@ -34,11 +45,14 @@ public:
         return has_external_support(type, cls, pkg, "output");
     }
 
+    bool is_realization_sink() const { return sink; }
+
     std::string get_class() const { return cls; }
     std::string get_package() const { return pkg; }
 private:
     std::string cls="matrix";
     std::string pkg="base";
+    bool sink=false;
 };
 
 }
@@ -0,0 +1,327 @@
+#ifndef BEACHMAT_SINK_WRITER_H
+#define BEACHMAT_SINK_WRITER_H
+
+#include "Rcpp.h"
+
+#include "../utils/utils.h"
+#include "../utils/dim_checker.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace beachmat {
+
+/* The 'sink_writer' class writes into a RealizationSink for the requested
+ * realization backend (e.g., HDF5Array, TileDBArray). Values are buffered
+ * in a window of consecutive columns, and complete blocks of columns are
+ * passed to write_block() in a single R call per block. The block width is
+ * chosen in R to be a multiple of the sink's chunk width that fits in the
+ * current block size, so each write covers whole chunks of the backend.
+ *
+ * A block is considered to be complete once a column past its end is written,
+ * at which point it is flushed and removed from memory. Attempting to modify
+ * or read a flushed column is an error. If the producer writes out of column
+ * order (e.g., by row), the window simply grows to hold the affected columns,
+ * and everything is flushed upon yield().
+ *
+ * Upon yield(), the sink is closed and returned as a DelayedMatrix. Further
+ * calls to yield() return the same object but no further writes are allowed.
+ */
+
+/*** Class definition ***/
+
+template<typename T, class V>
+class sink_writer : public dim_checker {
+public:
+    sink_writer(size_t, size_t, const std::string&);
+    ~sink_writer() = default;
+
+    // Copying (e.g., via clone()) creates a new sink with the same buffered contents.
+    // This is only possible before anything is flushed, as the flushed columns cannot be shared.
+    sink_writer(const sink_writer&);
+    sink_writer& operator=(const sink_writer&);
+    sink_writer(sink_writer&&) = default;
+    sink_writer& operator=(sink_writer&&) = default;
+
+    // Setters:
+    template <class Iter>
+    void set_row(size_t, Iter, size_t, size_t);
+
+    template <class Iter>
+    void set_col(size_t, Iter, size_t, size_t);
+
+    void set(size_t, size_t, T);
+
+    template <class Iter>
+    void set_col_indexed(size_t, size_t, Rcpp::IntegerVector::iterator, Iter);
+
+    template <class Iter>
+    void set_row_indexed(size_t, size_t, Rcpp::IntegerVector::iterator, Iter);
+
+    // Getters:
+    template <class Iter>
+    void get_col(size_t, Iter, size_t, size_t);
+
+    template <class Iter>
+    void get_row(size_t, Iter, size_t, size_t);
+
+    T get(size_t, size_t);
+
+    // Other:
+    size_t get_nflushed() const { return start; }
+
+    size_t get_block_ncol() const { return block_ncol; }
+
+    Rcpp::RObject yield();
+
+    std::string get_class() const { return backend; }
+
+    std::string get_package() const { return "DelayedArray"; }
+private:
+    std::string backend;
+    Rcpp::RObject sink, grid;
+    size_t block_ncol=1;
+
+    // Tracking the order in which columns are written.
+    bool ordered=true;
+    size_t highest=0;
+
+    // Column-major buffer for columns in [start, end).
+    size_t start=0, end=0;
+    std::vector<T> window;
+
+    bool closed=false;
+    Rcpp::RObject result;
+
+    void prepare_write(size_t, size_t);
+    void prepare_read(size_t) const;
+    void extend(size_t);
+    void flush_block();
+};
+
+/*** Constructor definitions ***/
+
+template<typename T, class V>
+sink_writer<T, V>::sink_writer(size_t nr, size_t nc, const std::string& b) : dim_checker(nr, nc), backend(b) {
+    Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
+    Rcpp::Function setup(beachenv["setupRealizationSink"]);
+    Rcpp::List details=setup(static_cast<int>(nr), static_cast<int>(nc), translate_type(V().sexp_type()), backend);
+    if (details.size()!=3) {
+        throw std::runtime_error("output of beachmat:::setupRealizationSink should be a list of length 3");
+    }
+
+    sink=details[0];
+    grid=details[1];
+    Rcpp::IntegerVector width(details[2]);
+    if (width.size()!=1 || width[0] < 1) {
+        throw std::runtime_error("block width should be a positive integer scalar");
+    }
+    block_ncol=width[0];
+    return;
+}
+
+template<typename T, class V>
+sink_writer<T, V>::sink_writer(const sink_writer& other) : sink_writer(other.nrow, other.ncol, other.backend) {
+    if (other.start || other.closed) {
+        throw std::runtime_error("cannot copy a sink writer after columns have been written to the sink");
+    }
+    ordered=other.ordered;
+    highest=other.highest;
+    end=other.end;
+    window=other.window;
+    return;
+}
+
+template<typename T, class V>
+sink_writer<T, V>& sink_writer<T, V>::operator=(const sink_writer& other) {
+    sink_writer copy(other);
+    *this=std::move(copy);
+    return *this;
+}
+
+/*** Buffering methods ***/
+
+template<typename T, class V>
+void sink_writer<T, V>::prepare_write(size_t lo, size_t hi) {
+    if (closed) {
+        throw std::runtime_error("cannot modify the sink after yield()");
+    }
+    if (lo < start) {
+        throw std::runtime_error("cannot modify columns that have already been written to the sink");
+    }
+
+    // Flushing all blocks that lie before the lowest column to be written,
+    // but only if the producer has been writing in column order so far.
+    if (lo < highest) {
+        ordered=false;
+    } else if (ordered) {
+        while (start + block_ncol <= lo) {
+            flush_block();
+        }
+    }
+
+    highest=std::max(highest, hi);
+    extend(hi + 1);
+    return;
+}
+
+template<typename T, class V>
+void sink_writer<T, V>::prepare_read(size_t lo) const {
+    if (lo < start) {
+        throw std::runtime_error("cannot read columns that have already been written to the sink");
+    }
+    return;
+}
+
+template<typename T, class V>
+void sink_writer<T, V>::extend(size_t new_end) {
+    if (new_end > end) {
+        window.resize((new_end - start) * this->nrow);
+        end=new_end;
+    }
+    return;
+}
+
+template<typename T, class V>
+void sink_writer<T, V>::flush_block() {
+    const size_t ncols=std::min(block_ncol, this->ncol - start);
+    extend(start + ncols);
+
+    const size_t nvals=ncols * this->nrow;
+    V block(window.begin(), window.begin() + nvals);
+    block.attr("dim")=Rcpp::IntegerVector::create(this->nrow, ncols);
+
+    Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
+    Rcpp::Function writer(beachenv["writeSinkBlock"]);
+    writer(sink, grid, static_cast<int>(start / block_ncol + 1), block);
+
+    window.erase(window.begin(), window.begin() + nvals);
+    start+=ncols;
+    return;
+}
+
+/*** Setter methods ***/
+
+template<typename T, class V>
+template<class Iter>
+void sink_writer<T, V>::set_col(size_t c, Iter in, size_t first, size_t last) {
+    check_colargs(c, first, last);
+    prepare_write(c, c);
+    std::copy(in, in + (last - first), window.begin() + (c - start) * this->nrow + first);
+    return;
+}
+
+template<typename T, class V>
+template<class Iter>
+void sink_writer<T, V>::set_row(size_t r, Iter in, size_t first, size_t last) {
+    check_rowargs(r, first, last);
+    if (first < last) {
+        prepare_write(first, last - 1);
+        for (size_t c=first; c<last; ++c, ++in) {
+            window[(c - start) * this->nrow + r]=*in;
+        }
+    }
+    return;
+}
+
+template<typename T, class V>
+void sink_writer<T, V>::set(size_t r, size_t c, T in) {
+    check_oneargs(r, c);
+    prepare_write(c, c);
+    window[(c - start) * this->nrow + r]=in;
+    return;
+}
+
+template<typename T, class V>
+template <class Iter>
+void sink_writer<T, V>::set_col_indexed(size_t c, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
+    check_colargs(c);
+    prepare_write(c, c);
+    auto wIt=window.begin() + (c - start) * this->nrow;
+    for (size_t i=0; i<n; ++i, ++idx, ++in) {
+        *(wIt + *idx)=*in;
+    }
+    return;
+}
+
+template<typename T, class V>
+template <class Iter>
+void sink_writer<T, V>::set_row_indexed(size_t r, size_t n, Rcpp::IntegerVector::iterator idx, Iter in) {
+    check_rowargs(r);
+    if (n) {
+        auto range=std::minmax_element(idx, idx + n);
+        check_colargs(*range.first);
+        check_colargs(*range.second);
+        prepare_write(*range.first, *range.second);
+        auto wIt=window.begin() + r;
+        for (size_t i=0; i<n; ++i, ++idx, ++in) {
+            *(wIt + (*idx - start) * this->nrow)=*in;
+        }
+    }
+    return;
+}
+
+/*** Getter methods ***/
+
+template<typename T, class V>
+template<class Iter>
+void sink_writer<T, V>::get_col(size_t c, Iter out, size_t first, size_t last) {
+    check_colargs(c, first, last);
+    prepare_read(c);
+    if (c >= end) {
+        std::fill(out, out + (last - first), 0);
+    } else {
+        auto wIt=window.begin() + (c - start) * this->nrow;
+        std::copy(wIt + first, wIt + last, out);
+    }
+    return;
+}
+
+template<typename T, class V>
+template<class Iter>
+void sink_writer<T, V>::get_row(size_t r, Iter out, size_t first, size_t last) {
+    check_rowargs(r, first, last);
+    if (first < last) {
+        prepare_read(first);
+    }
+    const size_t split=std::max(first, std::min(last, end));
+    for (size_t c=first; c<split; ++c, ++out) {
+        (*out)=window[(c - start) * this->nrow + r];
+    }
+    std::fill(out, out + (last - split), 0);
+    return;
+}
+
+template<typename T, class V>
+T sink_writer<T, V>::get(size_t r, size_t c) {
+    check_oneargs(r, c);
+    prepare_read(c);
+    if (c >= end) {
+        return 0;
+    }
+    return window[(c - start) * this->nrow + r];
+}
+
+/*** Output functions ***/
+
+template<typename T, class V>
+Rcpp::RObject sink_writer<T, V>::yield() {
+    if (!closed) {
+        while (start < this->ncol) {
+            flush_block();
+        }
+        std::vector<T>().swap(window);
+
+        Rcpp::Environment beachenv=Rcpp::Environment::namespace_env("beachmat");
+        Rcpp::Function closer(beachenv["closeRealizationSink"]);
+        result=closer(sink);
+        closed=true;
+    }
+    return result;
+}
+
+}
+
+#endif
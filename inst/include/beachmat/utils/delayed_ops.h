@@ -0,0 +1,94 @@
+#ifndef BEACHMAT_DELAYED_OP_STACK_H
+#define BEACHMAT_DELAYED_OP_STACK_H
+
+#include "Rcpp.h"
+#include "../../beachmat3/delayed_op.h"
+
+#include <vector>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace beachmat {
+
+/* The 'delayed_op_stack' class applies a series of delayed operations to
+ * values extracted from a row or column of the seed matrix, converting
+ * to and from double precision as required. The individual operations are
+ * shared with the version 3 API, see beachmat3/delayed_op.h. All operations
+ * are performed in double precision to mimic R's semantics for missing values.
+ */
+
+template<typename T>
+class delayed_op_stack {
+public:
+    delayed_op_stack() = default;
+
+    delayed_op_stack(const Rcpp::List& info) {
+        for (size_t i=0; i<info.size(); ++i) {
+            Rcpp::List current=info[i];
+            ops.push_back(delayed_op(current));
+        }
+        return;
+    }
+
+    bool empty() const { return ops.empty(); }
+
+    template<class Iter>
+    void apply_col(size_t c, Iter out, size_t first, size_t last) {
+        apply(out, last - first, false, c, first, std::is_arithmetic<T>());
+        return;
+    }
+
+    template<class Iter>
+    void apply_row(size_t r, Iter out, size_t first, size_t last) {
+        apply(out, last - first, true, r, first, std::is_arithmetic<T>());
+        return;
+    }
+
+    T apply_one(size_t r, size_t c, T val) {
+        apply(&val, 1, false, c, r, std::is_arithmetic<T>());
+        return val;
+    }
+private:
+    std::vector<delayed_op> ops;
+    std::vector<double> work;
+
+    static double to_double(double x) { return x; }
+    static double to_double(int x) { return (x==NA_INTEGER ? NA_REAL : x); }
+
+    static void from_double(double x, double& out) { out=x; }
+    static void from_double(double x, int& out) { 
+        // Non-finite or out-of-range values become NA, consistent with R's integer overflow.
+        const bool valid=std::isfinite(x) && x > -2147483647.5 && x < 2147483647.5;
+        out=(valid ? static_cast<int>(x) : NA_INTEGER); 
+    }
+
+    template<class Iter>
+    void apply(Iter out, size_t n, bool by_row, size_t index, size_t first, std::true_type) {
+        work.resize(n);
+        auto copy=out;
+        for (size_t i=0; i<n; ++i, ++copy) {
+            work[i]=to_double(static_cast<T>(*copy));
+        }
+
+        for (const auto& op : ops) {
+            op.transform(work.data(), n, by_row, index, first);
+        }
+
+        for (size_t i=0; i<n; ++i, ++out) {
+            T tmp;
+            from_double(work[i], tmp);
+            *out=tmp;
+        }
+        return;
+    }
+
+    template<class Iter>
+    void apply(Iter out, size_t n, bool by_row, size_t index, size_t first, std::false_type) {
+        throw std::runtime_error("delayed operations are not supported for non-numeric matrices");
+    }
+};
+
+}
+
+#endif
@@ -89,10 +89,11 @@ protected:
     static void check_indices(Rcpp::IntegerVector::iterator it, size_t n, size_t dim, const std::string& msg) {
         if (n==0) { return; }
 
-        int last=*(it++);
-        for (size_t i=1; i<n; ++i, ++it) {
+        // Negative indices become very large after conversion to size_t, so
+        // they are also caught by check_dimension().
+        for (size_t i=0; i<n; ++i, ++it) {
             dim_checker::check_dimension(*it, dim, msg);
-            if (*it <= last) {
+            if (i && *it <= *(it - 1)) {
                 throw std::runtime_error(msg + " indices are not strictly increasing");
             }
         }
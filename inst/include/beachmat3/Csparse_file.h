@@ -0,0 +1,293 @@
+#ifndef BEACHMAT_CSPARSE_FILE_H
+#define BEACHMAT_CSPARSE_FILE_H
+
+/**
+ * @file Csparse_file.h
+ *
+ * Reading of compressed sparse column (CSC) matrices from memory-mapped files.
+ * See `Csparse_file_format.h` for a description of the file format.
+ */
+
+#include "Rcpp.h"
+#include "Csparse_file_format.h"
+#include "Csparse_reader.h"
+#include "dim_checker.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace beachmat {
+/**
+ * @brief Read-only memory mapping of an entire file.
+ *
+ * The file is mapped with `MAP_SHARED`, so multiple processes reading the same file will share the same pages in the page cache.
+ * The mapping is released upon destruction, and this class cannot be copied;
+ * shared ownership should be achieved with a `std::shared_ptr`.
+ *
+ * @note This is an internal class and should not be constructed directly by **beachmat** users.
+ * Memory mapping is not currently supported on Windows.
+ */
+class Csparse_file_mapping {
+public:
+    /**
+     * @param path Path to the file.
+     */
+    Csparse_file_mapping(const std::string& path) {
+#ifdef _WIN32
+        throw std::runtime_error("memory-mapped CSC files are not supported on Windows");
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw std::runtime_error(std::string("failed to open '") + path + "'");
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) == -1) {
+            ::close(fd);
+            throw std::runtime_error(std::string("failed to query the size of '") + path + "'");
+        }
+        len = info.st_size;
+
+        if (len) {
+            void* ptr = ::mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+            if (ptr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error(std::string("failed to map '") + path + "' into memory");
+            }
+            contents = static_cast<const unsigned char*>(ptr);
+        }
+
+        ::close(fd); // the mapping remains valid after the descriptor is closed.
+#endif
+    }
+
+    ~Csparse_file_mapping() {
+#ifndef _WIN32
+        if (contents) {
+            ::munmap(const_cast<unsigned char*>(contents), len);
+        }
+#endif
+    }
+
+    Csparse_file_mapping(const Csparse_file_mapping&) = delete;
+    Csparse_file_mapping& operator=(const Csparse_file_mapping&) = delete;
+
+    /**
+     * @return Pointer to the start of the mapped file.
+     */
+    const unsigned char* data() const { return contents; }
+
+    /**
+     * @return Size of the file in bytes.
+     */
+    size_t size() const { return len; }
+private:
+    const unsigned char* contents = NULL;
+    size_t len = 0;
+};
+
+/**
+ * @brief Reader for a memory-mapped CSC file.
+ *
+ * This provides checks for the file contents prior to the internal construction of a `Csparse_core` object.
+ * All non-zero values and row indices are used directly from the mapping without copying.
+ * Copies of this reader share the same mapping, and neither copying nor destruction involves the R API.
+ *
+ * @note This is an internal class and should not be constructed directly by **beachmat** users.
+ *
+ * @tparam V The type of the `Rcpp::Vector` corresponding to the type of the non-zero values.
+ * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
+ */
+template <class V, typename TIT = const typename V::stored_type*>
+class Csparse_file_reader : public dim_checker {
+private:
+    typedef typename V::stored_type T;
+public:
+    ~Csparse_file_reader() = default;
+    Csparse_file_reader(const Csparse_file_reader&) = default;
+    Csparse_file_reader& operator=(const Csparse_file_reader&) = default;
+    Csparse_file_reader(Csparse_file_reader&&) = default;
+    Csparse_file_reader& operator=(Csparse_file_reader&&) = default;
+
+    /**
+     * Constructor from a path to a CSC file.
+     *
+     * @param path Path to the file.
+     * @param check Whether to check the row indices of all non-zero elements.
+     *
+     * @details
+     * The header and column pointers are always checked, which takes time proportional to the number of columns.
+     * If `check = false`, the row indices are assumed to be valid, as is guaranteed for files created by `Csparse_file_writer`;
+     * this avoids touching all pages of the file upon construction.
+     * Files from other sources should be validated once with `check = true`, as is done by the `CsparseFile()` constructor in R,
+     * given that out-of-range indices would otherwise be used to write into the caller's workspace.
+     */
+    Csparse_file_reader(const std::string& path, bool check = false) : mapping(std::make_shared<const Csparse_file_mapping>(path)) {
+        if (mapping->size() < Csparse_file_header_size) {
+            throw std::runtime_error(std::string("'") + path + "' is too small to be a CSC file");
+        }
+
+        auto header = parse_Csparse_file_header(mapping->data(), path);
+        if (header.type != get_Csparse_file_type<V>()) {
+            throw std::runtime_error(std::string("'") + path + "' contains " + translate_type(header.type) + " values");
+        }
+        this->nrow = header.nrow;
+        this->ncol = header.ncol;
+        const size_t& NC=this->ncol;
+        const size_t& NR=this->nrow;
+        nnz = header.nnzero;
+
+        Csparse_file_layout layout(header);
+        if (mapping->size() < layout.total) {
+            throw std::runtime_error(std::string("'") + path + "' is truncated");
+        }
+        p = reinterpret_cast<const uint64_t*>(mapping->data() + layout.p_offset);
+        i = reinterpret_cast<const int*>(mapping->data() + layout.i_offset);
+        x = reinterpret_cast<const T*>(mapping->data() + layout.x_offset);
+
+        if (p[0] != 0) {
+            throw std::runtime_error(std::string("first column pointer in '") + path + "' should be 0");
+        }
+        if (p[NC] != nnz) {
+            throw std::runtime_error(std::string("last column pointer in '") + path + "' should be equal to the number of non-zero elements");
+        }
+        for (size_t c = 0; c < NC; ++c) {
+            if (p[c] > p[c + 1]) {
+                throw std::runtime_error(std::string("column pointers in '") + path + "' should be sorted");
+            }
+        }
+
+        if (check) {
+            for (size_t c = 0; c < NC; ++c) {
+                for (uint64_t px = p[c]; px < p[c + 1]; ++px) {
+                    if (i[px] < 0 || static_cast<size_t>(i[px]) >= NR) {
+                        throw std::runtime_error(std::string("row indices in '") + path + "' should be in [0, nrow)");
+                    }
+                    if (px > p[c] && i[px] <= i[px - 1]) {
+                        throw std::runtime_error(std::string("row indices in each column of '") + path + "' should be strictly increasing");
+                    }
+                }
+            }
+        }
+
+        core = Csparse_core<TIT, int, uint64_t>(nnz, x, i, NR, NC, p);
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_col(size_t, size_t, size_t)
+     */
+    sparse_index<TIT, int> get_col(size_t c, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        return core.get_col(c, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_row(size_t, ALT, I*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_index<OUT, int> get_row(size_t r, ALT work_x, int* work_i, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        return core.template get_row<OUT>(r, work_x, work_i, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_row(size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT = TIT>
+    ALT get_row(size_t r, ALT work, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        core.get_row(r, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_col(size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT = TIT>
+    ALT get_col(size_t c, ALT work, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        core.get_col(c, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT = TIT>
+    ALT get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        core.get_cols(first_col, last_col, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, size_t*)
+     */
+    sparse_block<TIT, int> get_cols(size_t first_col, size_t last_col, size_t* work_p) {
+        this->check_colsargs(first_col, last_col, 0, this->nrow);
+        return core.get_cols(first_col, last_col, work_p);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_block<OUT, int> get_cols(size_t first_col, size_t last_col, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        return core.template get_cols<OUT>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_rows(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_row_block<OUT, int> get_rows(size_t first_row, size_t last_row, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_rowsargs(first_row, last_row, first, last);
+        return core.template get_rows<OUT>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::set_row_index()
+     */
+    void set_row_index(bool use, size_t limit) {
+        core.set_row_index(use, limit);
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::has_row_index()
+     */
+    bool has_row_index() const {
+        return core.has_row_index();
+    }
+
+    /**
+     * Get the number of non-zero elements in the file.
+     */
+    size_t get_nnzero () const { return nnz; }
+
+private:
+    std::shared_ptr<const Csparse_file_mapping> mapping;
+    size_t nnz = 0;
+    const uint64_t* p = NULL;
+    const int* i = NULL;
+    const T* x = NULL;
+    Csparse_core<TIT, int, uint64_t> core;
+};
+
+}
+
+#endif
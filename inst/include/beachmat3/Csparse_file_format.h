@@ -0,0 +1,314 @@
+#ifndef BEACHMAT_CSPARSE_FILE_FORMAT_H
+#define BEACHMAT_CSPARSE_FILE_FORMAT_H
+
+/**
+ * @file Csparse_file_format.h
+ *
+ * Layout of the binary file format for compressed sparse column (CSC) matrices, along with a writer for such files.
+ *
+ * Each file starts with a 64-byte header containing:
+ *
+ * - Bytes 0-7: the magic string `BMCSPRS` followed by a null terminator.
+ * - Bytes 8-11: the format version, as a 32-bit unsigned integer.
+ *   This is currently 1.
+ * - Bytes 12-15: the type of the non-zero values, as a 32-bit unsigned integer containing R's `SEXPTYPE` code,
+ *   i.e., `LGLSXP` for logical, `INTSXP` for integer and `REALSXP` for double-precision values.
+ * - Bytes 16-23, 24-31 and 32-39: the number of rows, columns and non-zero elements, respectively, as 64-bit unsigned integers.
+ * - Bytes 40-63: padding, filled with zeroes.
+ *
+ * This is followed by the column pointers as `ncol + 1` 64-bit unsigned integers;
+ * the zero-based row indices of the non-zero elements as 32-bit signed integers, sorted within each column;
+ * padding to the next multiple of 8 bytes;
+ * and the non-zero values, as 32-bit signed integers for logical and integer types or as doubles otherwise.
+ * Missing values are represented in the same manner as R, i.e., `NA_INTEGER`, `NA_LOGICAL` or `NA_REAL`.
+ *
+ * All fields are stored in the native byte order of the machine that wrote the file.
+ * This allows the arrays to be used directly from a memory-mapped file,
+ * such that non-zero elements can be accessed without any parsing or copying.
+ */
+
+#include "Rcpp.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+/* This header only depends on Rcpp, so that it can also be used by the 
+ * output classes of the version 2 API to create CSC files.
+ */
+
+namespace beachmat {
+
+/**
+ * Get the type code for a CSC file containing values of the type of `V`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam V An `Rcpp::Vector` class.
+ * Only `Rcpp::LogicalVector`, `Rcpp::IntegerVector` and `Rcpp::NumericVector` are supported.
+ *
+ * @return R's `SEXPTYPE` code for `V`.
+ * All other choices of `V` will trigger a compile-time error.
+ */
+template <class V>
+inline uint32_t get_Csparse_file_type() {
+    static_assert(sizeof(V)==0, "unsupported specialization of get_Csparse_file_type");
+    return 0;
+}
+
+template <>
+inline uint32_t get_Csparse_file_type<Rcpp::LogicalVector>() { return LGLSXP; }
+
+template <>
+inline uint32_t get_Csparse_file_type<Rcpp::IntegerVector>() { return INTSXP; }
+
+template <>
+inline uint32_t get_Csparse_file_type<Rcpp::NumericVector>() { return REALSXP; }
+
+/**
+ * @brief Contents of the header of a CSC file.
+ */
+struct Csparse_file_header {
+    /**
+     * R's `SEXPTYPE` code for the type of the non-zero values.
+     */
+    uint32_t type = 0;
+
+    /**
+     * Number of rows.
+     */
+    uint64_t nrow = 0;
+
+    /**
+     * Number of columns.
+     */
+    uint64_t ncol = 0;
+
+    /**
+     * Number of non-zero elements.
+     */
+    uint64_t nnzero = 0;
+};
+
+/**
+ * @cond
+ */
+const size_t Csparse_file_header_size = 64;
+
+const char Csparse_file_magic[8] = { 'B', 'M', 'C', 'S', 'P', 'R', 'S', '\0' };
+
+const uint32_t Csparse_file_version = 1;
+
+inline size_t Csparse_file_value_size(uint32_t type) {
+    return (type == REALSXP ? sizeof(double) : sizeof(int32_t));
+}
+
+/* Offsets of each array from the start of the file, along with the expected total size.
+ * The row indices are padded so that the values are always aligned to 8 bytes.
+ */
+struct Csparse_file_layout {
+    Csparse_file_layout(const Csparse_file_header& header) {
+        p_offset = Csparse_file_header_size;
+        i_offset = p_offset + sizeof(uint64_t) * (header.ncol + 1);
+        x_offset = i_offset + sizeof(int32_t) * header.nnzero;
+        x_offset += (8 - x_offset % 8) % 8;
+        total = x_offset + Csparse_file_value_size(header.type) * header.nnzero;
+    }
+    size_t p_offset, i_offset, x_offset, total;
+};
+
+inline Csparse_file_header parse_Csparse_file_header(const unsigned char* buffer, const std::string& path) {
+    if (std::memcmp(buffer, Csparse_file_magic, sizeof(Csparse_file_magic)) != 0) {
+        throw std::runtime_error(std::string("'") + path + "' is not a CSC file");
+    }
+
+    uint32_t version;
+    std::memcpy(&version, buffer + 8, sizeof(version));
+    if (version != Csparse_file_version) {
+        if (version == (Csparse_file_version << 24)) {
+            throw std::runtime_error(std::string("'") + path + "' was written with a different byte order");
+        }
+        throw std::runtime_error(std::string("unsupported version of the CSC file format in '") + path + "'");
+    }
+
+    Csparse_file_header header;
+    std::memcpy(&header.type, buffer + 12, sizeof(header.type));
+    if (header.type != LGLSXP && header.type != INTSXP && header.type != REALSXP) {
+        throw std::runtime_error(std::string("unsupported type of non-zero values in '") + path + "'");
+    }
+
+    std::memcpy(&header.nrow, buffer + 16, sizeof(header.nrow));
+    std::memcpy(&header.ncol, buffer + 24, sizeof(header.ncol));
+    std::memcpy(&header.nnzero, buffer + 32, sizeof(header.nnzero));
+    return header;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Read the header of a CSC file.
+ *
+ * @param path Path to the file.
+ *
+ * @return A `Csparse_file_header` containing the type and dimensions of the matrix.
+ * An error is raised if the file is not a valid CSC file.
+ */
+inline Csparse_file_header read_Csparse_file_header(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(std::string("failed to open '") + path + "'");
+    }
+
+    unsigned char buffer[Csparse_file_header_size];
+    in.read(reinterpret_cast<char*>(buffer), Csparse_file_header_size);
+    if (in.gcount() != static_cast<std::streamsize>(Csparse_file_header_size)) {
+        throw std::runtime_error(std::string("'") + path + "' is too small to be a CSC file");
+    }
+
+    return parse_Csparse_file_header(buffer, path);
+}
+
+/**
+ * @brief Writer for a CSC file.
+ *
+ * Columns should be added in order with `add_column()`, after which `finish()` should be called to complete the file.
+ * Only the column pointers are held in memory, so files can be created for matrices that are much larger than the available memory.
+ */
+class Csparse_file_writer {
+public:
+    /**
+     * @param path Path to the output file.
+     * Any existing file is overwritten.
+     * @param nr Number of rows.
+     * @param nc Number of columns.
+     * @param nnz Total number of non-zero elements across all columns.
+     * @param type R's `SEXPTYPE` code for the type of the non-zero values, i.e., `LGLSXP`, `INTSXP` or `REALSXP`.
+     */
+    Csparse_file_writer(const std::string& path, size_t nr, size_t nc, size_t nnz, uint32_t type) :
+        out(path, std::ios::binary | std::ios::trunc), fname(path), p(nc + 1)
+    {
+        if (!out) {
+            throw std::runtime_error(std::string("failed to open '") + path + "' for writing");
+        }
+        if (type != LGLSXP && type != INTSXP && type != REALSXP) {
+            throw std::runtime_error("unsupported type of non-zero values");
+        }
+        if (nr > static_cast<size_t>(std::numeric_limits<int>::max())) {
+            throw std::runtime_error("number of rows should fit into a 32-bit signed integer");
+        }
+
+        header.type = type;
+        header.nrow = nr;
+        header.ncol = nc;
+        header.nnzero = nnz;
+
+        unsigned char buffer[Csparse_file_header_size];
+        std::fill(buffer, buffer + Csparse_file_header_size, 0);
+        std::memcpy(buffer, Csparse_file_magic, sizeof(Csparse_file_magic));
+        std::memcpy(buffer + 8, &Csparse_file_version, sizeof(Csparse_file_version));
+        std::memcpy(buffer + 12, &header.type, sizeof(header.type));
+        std::memcpy(buffer + 16, &header.nrow, sizeof(header.nrow));
+        std::memcpy(buffer + 24, &header.ncol, sizeof(header.ncol));
+        std::memcpy(buffer + 32, &header.nnzero, sizeof(header.nnzero));
+        out.write(reinterpret_cast<const char*>(buffer), Csparse_file_header_size);
+        return;
+    }
+
+    /**
+     * Add the next column to the file.
+     *
+     * @tparam TIT Iterator to the non-zero values, possibly of a different type from that in the file.
+     *
+     * @param idx Pointer to an array of zero-based row indices of the non-zero elements.
+     * These should be strictly increasing.
+     * @param x Iterator to the start of the values of the non-zero elements.
+     * @param n Number of non-zero elements in this column.
+     *
+     * @details
+     * This can be directly used with the output of `lin_sparse_matrix::get_col()`.
+     */
+    template <typename TIT>
+    void add_column(const int* idx, TIT x, size_t n) {
+        if (column == header.ncol) {
+            throw std::runtime_error("all columns have already been added");
+        }
+        if (counter + n > header.nnzero) {
+            throw std::runtime_error("more non-zero elements than specified in the constructor");
+        }
+        for (size_t v = 0; v < n; ++v) {
+            if (idx[v] < 0 || static_cast<size_t>(idx[v]) >= header.nrow) {
+                throw std::runtime_error("row index out of range");
+            }
+            if (v && idx[v] <= idx[v - 1]) {
+                throw std::runtime_error("row indices should be strictly increasing");
+            }
+        }
+
+        Csparse_file_layout layout(header);
+        out.seekp(layout.i_offset + sizeof(int32_t) * counter);
+        out.write(reinterpret_cast<const char*>(idx), sizeof(int32_t) * n);
+
+        out.seekp(layout.x_offset + Csparse_file_value_size(header.type) * counter);
+        if (header.type == REALSXP) {
+            dbuffer.assign(x, x + n);
+            out.write(reinterpret_cast<const char*>(dbuffer.data()), sizeof(double) * n);
+        } else {
+            ibuffer.assign(x, x + n);
+            out.write(reinterpret_cast<const char*>(ibuffer.data()), sizeof(int32_t) * n);
+        }
+
+        counter += n;
+        ++column;
+        p[column] = counter;
+        return;
+    }
+
+    /**
+     * Finish writing the file by adding the column pointers.
+     * This should be called after all columns have been added.
+     */
+    void finish() {
+        if (column != header.ncol) {
+            throw std::runtime_error("not all columns have been added");
+        }
+        if (counter != header.nnzero) {
+            throw std::runtime_error("fewer non-zero elements than specified in the constructor");
+        }
+
+        Csparse_file_layout layout(header);
+        out.seekp(layout.p_offset);
+        out.write(reinterpret_cast<const char*>(p.data()), sizeof(uint64_t) * p.size());
+
+        // Making sure that the file is padded to its full size, even if the last values are empty.
+        out.seekp(0, std::ios::end);
+        size_t current = out.tellp();
+        if (current < layout.total) {
+            std::vector<char> padding(layout.total - current);
+            out.write(padding.data(), padding.size());
+        }
+
+        out.close();
+        if (!out) {
+            throw std::runtime_error(std::string("failed to write '") + fname + "'");
+        }
+        return;
+    }
+private:
+    std::ofstream out;
+    std::string fname;
+    Csparse_file_header header;
+    std::vector<uint64_t> p;
+    size_t counter = 0, column = 0;
+    std::vector<double> dbuffer;
+    std::vector<int32_t> ibuffer;
+};
+
+}
+
+#endif
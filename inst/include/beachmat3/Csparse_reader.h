@@ -11,14 +11,23 @@
 
 #include "dim_checker.h"
 #include "utils.h"
+#include "kernels.h"
 
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <string>
 #include <vector>
+#include <memory>
+#include <iterator>
 
 namespace beachmat {
 
+/**
+ * Default limit on the memory usage of a row index in bytes (1 GiB), see `Csparse_core::set_row_index()`.
+ */
+const size_t default_row_index_limit = 1073741824;
+
 /**
  * @brief Sparse index container, holding the number of non-zero elements extracted from a single row/column 
  * along with pointers to arrays containing their indices and values.
@@ -59,6 +68,98 @@ struct sparse_index {
     const I* i;
 };
 
+/**
+ * @brief Sparse block container, holding the non-zero elements extracted from a contiguous block of columns
+ * in the compressed sparse column (CSC) format.
+ *
+ * The non-zero elements of the `k`-th column of the block are stored in `[p[k], p[k+1])` of `x` and `i`,
+ * where `p[0]` is always zero.
+ * Row indices are zero-indexed and sorted within each column.
+ *
+ * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
+ * @tparam I The integer type of the index.
+ */
+template <typename TIT, typename I>
+struct sparse_block {
+    /**
+     * Constructor for the `sparse_block`, setting its data members directly to the supplied values.
+     *
+     * @param _ncol See `ncol`.
+     * @param _x See `x`.
+     * @param _i See `i`.
+     * @param _p See `p`.
+     */
+    sparse_block(size_t _ncol, TIT _x, const I* _i, const size_t* _p) : ncol(_ncol), x(_x), i(_i), p(_p) {}
+
+    /**
+     * Number of columns in the block.
+     */
+    size_t ncol;
+
+    /**
+     * Iterator to a sequence of non-zero values.
+     * This should be random-access and incrementable up to `p[ncol]`.
+     */
+    TIT x;
+
+    /**
+     * Pointer to an array of row indices of the non-zero values.
+     * This should be incrementable up to `p[ncol]`.
+     */
+    const I* i;
+
+    /**
+     * Pointer to an array of column pointers, of length `ncol + 1`.
+     */
+    const size_t* p;
+};
+
+/**
+ * @brief Sparse block container, holding the non-zero elements extracted from a contiguous block of rows
+ * in the compressed sparse row (CSR) format.
+ *
+ * The non-zero elements of the `k`-th row of the block are stored in `[p[k], p[k+1])` of `x` and `i`,
+ * where `p[0]` is always zero.
+ * Column indices are zero-indexed and sorted within each row.
+ *
+ * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
+ * @tparam I The integer type of the index.
+ */
+template <typename TIT, typename I>
+struct sparse_row_block {
+    /**
+     * Constructor for the `sparse_row_block`, setting its data members directly to the supplied values.
+     *
+     * @param _nrow See `nrow`.
+     * @param _x See `x`.
+     * @param _i See `i`.
+     * @param _p See `p`.
+     */
+    sparse_row_block(size_t _nrow, TIT _x, const I* _i, const size_t* _p) : nrow(_nrow), x(_x), i(_i), p(_p) {}
+
+    /**
+     * Number of rows in the block.
+     */
+    size_t nrow;
+
+    /**
+     * Iterator to a sequence of non-zero values.
+     * This should be random-access and incrementable up to `p[nrow]`.
+     */
+    TIT x;
+
+    /**
+     * Pointer to an array of column indices of the non-zero values.
+     * This should be incrementable up to `p[nrow]`.
+     */
+    const I* i;
+
+    /**
+     * Pointer to an array of row pointers, of length `nrow + 1`.
+     */
+    const size_t* p;
+};
+
 /**
  * Transplant indices and values into their respective workspaces and use them to construct a new `sparse_index` object.
  * This is necessary for type conversions between the stored and expected types of non-zero values.
@@ -81,8 +182,10 @@ struct sparse_index {
  */
 template<typename OUT, typename TIT, typename ALT, typename I>
 inline sparse_index<OUT, int> transplant(sparse_index<TIT, I> ref, ALT work_x, I* work_i) {
-    std::copy(ref.x, ref.x + ref.n, work_x);
-    std::copy(ref.i, ref.i + ref.n, work_i);
+    copy_n_values(ref.x, ref.n, work_x);
+    if (ref.i != work_i) {
+        copy_n_values(ref.i, ref.n, work_i);
+    }
     return sparse_index<OUT, int>(ref.n, work_x, work_i);
 }
 
@@ -122,9 +225,16 @@ public:
      * @param _nc Number of columns in the CSC matrix.
      * @param _p Pointer to the array of column pointers.
      * This should have at least `nc + 1` addressable elements.
+     * @param _base Base of the row indices in `_i`, e.g., 1 for 1-based indices.
+     * This allows the class to directly use row indices from R without copying.
+     */
+    Csparse_core(const size_t _n, TIT _x, const I* _i, const size_t _nr, const size_t _nc, const P* _p, I _base = 0) : 
+        n(_n), nr(_nr), nc(_nc), x(_x), i(_i), p(_p), base(_base), currow(0), curstart(0), curend(nc) {}
+
+    /**
+     * @return Base of the row indices, see the constructor for details.
      */
-    Csparse_core(const size_t _n, TIT _x, const I* _i, const size_t _nr, const size_t _nc, const P* _p) : 
-        n(_n), nr(_nr), nc(_nc), x(_x), i(_i), p(_p), currow(0), curstart(0), curend(nc) {}
+    I get_base() const { return base; }
    
     /**
      * Get all non-zero elements from a column of a CSC matrix, possibly restricted to contiguous subset of rows.
@@ -136,6 +246,7 @@ public:
      *
      * @return A `sparse_index` containing pointers to the first non-zero element in `c` with row index no less than `first`.
      * The number of non-zero elements is that with row indices in `[first, last)`. 
+     * Note that the row indices are reported as stored, i.e., they are offset by the base (see `get_base()`).
      */
     sparse_index<TIT, I> get_col(size_t c, size_t first, size_t last) {
         const auto pstart=p[c]; 
@@ -144,13 +255,13 @@ public:
         auto xIt = x + pstart;
 
         if (first) { // Jumping ahead if non-zero.
-            auto new_iIt=std::lower_bound(iIt, eIt, first);
+            auto new_iIt=std::lower_bound(iIt, eIt, first + base);
             xIt+=(new_iIt-iIt);
             iIt=new_iIt;
         } 
 
         if (last!=nr) { // Jumping to last element.
-            eIt=std::lower_bound(iIt, eIt, last);
+            eIt=std::lower_bound(iIt, eIt, last + base);
         }
 
         return sparse_index<TIT, I>(eIt - iIt, xIt, iIt); 
@@ -181,12 +292,95 @@ public:
     void get_col(size_t c, ALT work, size_t first, size_t last, T empty) {
         auto out = this->get_col(c, first, last);
         std::fill(work, work + last - first, empty);
-        for (size_t v = 0; v < out.n; ++v, ++out.i, ++out.x) {
-            *(work + *out.i - first) = *out.x;
-        }
+        scatter_values(out.x, out.i, out.n, work, first + base);
         return;       
     }
 
+    /**
+     * Get all values from a contiguous block of columns of the CSC matrix, possibly restricted to a contiguous subset of rows.
+     * Zeroes are explicitly filled in.
+     *
+     * @tparam ALT Iterator class for the workspace.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work A pointer or iterator to the workspace in which the column values are to be stored.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     * @param empty Value corresponding to zero, almost always `0`.
+     *
+     * @return `work` is filled in with the contents of columns `[first_col, last_col)` from rows `[first, last)` in column-major format.
+     * If no non-zero element exists, the corresponding entry of `work` is set to `empty`.
+     */
+    template <typename ALT = TIT>
+    void get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last, T empty) {
+        const size_t len = last - first;
+        std::fill(work, work + len * (last_col - first_col), empty);
+        for (size_t c = first_col; c < last_col; ++c, work += len) {
+            auto out = this->get_col(c, first, last);
+            scatter_values(out.x, out.i, out.n, work, first + base);
+        }
+        return;
+    }
+
+    /**
+     * Get all non-zero elements from a contiguous block of columns of a CSC matrix.
+     * This is guaranteed to be a no-copy operation for the values and indices.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_p Pointer to a workspace for the column pointers of the block.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     *
+     * @return A `sparse_block` containing pointers into the underlying arrays of non-zero values and row indices,
+     * along with the rebased column pointers in `work_p`.
+     * Note that the row indices are reported as stored, i.e., they are offset by the base (see `get_base()`).
+     */
+    sparse_block<TIT, I> get_cols(size_t first_col, size_t last_col, size_t* work_p) {
+        const auto start = p[first_col];
+        work_p[0] = 0;
+        for (size_t c = first_col; c < last_col; ++c) {
+            work_p[c - first_col + 1] = p[c + 1] - start;
+        }
+        return sparse_block<TIT, I>(last_col - first_col, x + start, i + start, work_p);
+    }
+
+    /**
+     * Get all non-zero elements from a contiguous block of columns of a CSC matrix, possibly restricted to a contiguous subset of rows.
+     * Values and indices will be copied into their respective workspaces.
+     *
+     * @tparam OUT Iterator class for the data values in the output `sparse_block`,
+     * expected to correspond to a `const`-type counterpart to `ALT`.
+     * @tparam ALT Iterator class for the workspace.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_x A pointer or iterator to the workspace in which the non-zero values are to be stored.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_i A pointer or iterator to the workspace in which the non-zero row indices are to be stored.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_p Pointer to a workspace for the column pointers of the block.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @return A `sparse_block` containing pointers to the workspaces.
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_block<OUT, I> get_cols(size_t first_col, size_t last_col, ALT work_x, I* work_i, size_t* work_p, size_t first, size_t last) {
+        size_t counter = 0;
+        work_p[0] = 0;
+        for (size_t c = first_col; c < last_col; ++c) {
+            auto out = this->get_col(c, first, last);
+            copy_n_values(out.x, out.n, work_x + counter);
+            copy_indices(out.i, out.n, work_i + counter);
+            counter += out.n;
+            work_p[c - first_col + 1] = counter;
+        }
+        return sparse_block<OUT, I>(last_col - first_col, work_x, work_i, work_p);
+    }
+
     /**
      * Get all values from a row of a CSC matrix, possibly restricted to a contiguous subset of columns.
      * Zeroes are explicitly filled in.
@@ -205,14 +399,23 @@ public:
      */
     template <typename ALT = TIT>
     void get_row(size_t r, ALT work, size_t first, size_t last, T empty) {
+        if (use_row_index(r)) {
+            std::fill(work, work + last - first, empty);
+            auto range = search_row_index(r, first, last);
+            for (auto cIt = range.first; cIt != range.second; ++cIt) {
+                *(work + *cIt - first) = convert_value<typename std::iterator_traits<ALT>::value_type>(*(x + row_index->perm[cIt - row_index->cols.begin()]));
+            }
+            return;
+        }
+
         update_indices(r, first, last);
         std::fill(work, work + last - first, empty);
 
         auto pIt = p + first + 1; // Points to first-past-the-end for each 'c'.
         for (size_t c = first; c < last; ++c, ++pIt, ++work) { 
-            const int idex = indices[c];
-            if (static_cast<P>(idex) != *pIt && static_cast<size_t>(i[idex]) == r) { 
-                (*work) = *(x + idex); 
+            const P idex = indices[c];
+            if (idex != *pIt && static_cast<size_t>(i[idex]) == r + base) { 
+                (*work) = convert_value<typename std::iterator_traits<ALT>::value_type>(*(x + idex));
             }
         } 
         return;  
@@ -240,31 +443,247 @@ public:
      */
     template <typename OUT, typename ALT = TIT>
     sparse_index<OUT, I> get_row(size_t r, ALT work_x, I* work_i, size_t first, size_t last) {
+        if (use_row_index(r)) {
+            auto range = search_row_index(r, first, last);
+            size_t counter = 0;
+            for (auto cIt = range.first; cIt != range.second; ++cIt, ++counter) {
+                work_i[counter] = *cIt;
+                *(work_x + counter) = convert_value<typename std::iterator_traits<ALT>::value_type>(*(x + row_index->perm[cIt - row_index->cols.begin()]));
+            }
+            return sparse_index<OUT, I>(counter, work_x, work_i);
+        }
+
         update_indices(r, first, last);
 
         auto pIt = p + first + 1; // Points to first-past-the-end for each 'c'.
         size_t counter = 0;
 
         for (size_t c = first; c < last; ++c, ++pIt) { 
-            const int& idex = indices[c];
-            if (idex != *pIt && static_cast<size_t>(i[idex]) == r) { 
+            const P& idex = indices[c];
+            if (idex != *pIt && static_cast<size_t>(i[idex]) == r + base) { 
                 work_i[counter] = c;
-                *(work_x + counter) = *(x + idex);
+                *(work_x + counter) = convert_value<typename std::iterator_traits<ALT>::value_type>(*(x + idex));
                 ++counter;
             }
         }
 
         return sparse_index<OUT, I>(counter, work_x, work_i);
     }
+
+    /**
+     * Get all non-zero elements from a contiguous block of rows of a CSC matrix, possibly restricted to a contiguous subset of columns.
+     * Values and column indices will be copied into their respective workspaces in the compressed sparse row format.
+     *
+     * @tparam OUT Iterator class for the data values in the output `sparse_row_block`,
+     * expected to correspond to a `const`-type counterpart to `ALT`.
+     * @tparam ALT Iterator class for the workspace.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param work_x A pointer or iterator to the workspace in which the non-zero values are to be stored.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_i A pointer or iterator to the workspace in which the non-zero column indices are to be stored.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_p Pointer to a workspace for the row pointers of the block.
+     * This should have at least `last_row - first_row + 1` addressable elements.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return A `sparse_row_block` containing pointers to the workspaces.
+     *
+     * @details
+     * This makes a single sweep over the columns in `[first, last)`,
+     * using a binary search to find the non-zero elements with row indices in `[first_row, last_row)` for each column.
+     * The column ranges are cached so that the values can be scattered into their rows without repeating the search.
+     * This is much faster than calling `get_row()` for each row, and does not disturb the cursors used by `get_row()`.
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_row_block<OUT, I> get_rows(size_t first_row, size_t last_row, ALT work_x, I* work_i, size_t* work_p, size_t first, size_t last) {
+        const size_t nrows = last_row - first_row;
+        std::fill(work_p, work_p + nrows + 1, 0);
+
+        block_bounds.resize(2 * (last - first));
+        auto bIt = block_bounds.begin();
+        for (size_t c = first; c < last; ++c) {
+            auto start = std::lower_bound(i + p[c], i + p[c + 1], static_cast<I>(first_row) + base);
+            auto end = std::lower_bound(start, i + p[c + 1], static_cast<I>(last_row) + base);
+            *(bIt++) = start - i;
+            *(bIt++) = end - i;
+
+            for (; start != end; ++start) {
+                ++work_p[*start - base - first_row + 1];
+            }
+        }
+
+        for (size_t r = 0; r < nrows; ++r) {
+            work_p[r + 1] += work_p[r];
+        }
+
+        /* Using work_p[r] as the insertion position for row 'r', and shifting it back afterwards.
+         * Column indices are naturally sorted within each row as we visit the columns in order.
+         */
+        bIt = block_bounds.begin();
+        for (size_t c = first; c < last; ++c, bIt += 2) {
+            for (P pos = *bIt; pos < *(bIt + 1); ++pos) {
+                auto& dest = work_p[i[pos] - base - first_row];
+                *(work_x + dest) = convert_value<typename std::iterator_traits<ALT>::value_type>(*(x + pos));
+                work_i[dest] = c;
+                ++dest;
+            }
+        }
+
+        for (size_t r = nrows; r > 0; --r) {
+            work_p[r] = work_p[r - 1];
+        }
+        work_p[0] = 0;
+
+        return sparse_row_block<OUT, I>(nrows, work_x, work_i, work_p);
+    }
+
+    /**
+     * Specify whether a row index should be constructed to accelerate random row access.
+     *
+     * If enabled, the row index is lazily built upon the first row request that is not adjacent to the previously requested row.
+     * This contains the column indices of the non-zero elements in each row, along with their positions in the CSC arrays;
+     * it allows subsequent row requests to be satisfied in time proportional to the number of non-zero elements in that row.
+     * The index is only constructed if its memory usage is no greater than `limit`, 
+     * otherwise we fall back to the usual search of each column.
+     *
+     * @param use Whether to use a row index.
+     * @param limit Maximum size of the row index in bytes.
+     *
+     * @return The row index is enabled or disabled.
+     * Any existing index is discarded when disabled or if it is larger than `limit`.
+     */
+    void set_row_index(bool use, size_t limit) {
+        row_index_enabled = use;
+        row_index_limit = limit;
+        if (!use || (row_index && row_index_size() > limit)) {
+            row_index.reset();
+        }
+        return;
+    }
+
+    /**
+     * @return Whether a row index has been constructed, see `set_row_index()`.
+     */
+    bool has_row_index() const {
+        return static_cast<bool>(row_index);
+    }
 private:
     size_t n, nr, nc;
 
     TIT x;
     const I* i;
     const P* p;
+    I base = 0;
 
     size_t currow, curstart, curend;
     std::vector<P> indices; 
+    std::vector<P> block_bounds;
+
+    /**
+     * Copy row indices into a workspace, removing the base.
+     */
+    void copy_indices(const I* src, size_t len, I* dest) const {
+        if (base) {
+            for (size_t v = 0; v < len; ++v) {
+                dest[v] = src[v] - base;
+            }
+        } else {
+            std::copy(src, src + len, dest);
+        }
+        return;
+    }
+
+    /**
+     * @brief Compressed sparse row index, containing the column index and position in `x` for each non-zero element.
+     */
+    struct row_index_store {
+        std::vector<size_t> ptr;
+        std::vector<I> cols;
+        std::vector<P> perm;
+    };
+
+    bool row_index_enabled = false;
+    size_t row_index_limit = 0;
+    std::shared_ptr<const row_index_store> row_index; // shared among copies, as it is never modified after construction.
+
+    /**
+     * @return Expected size of the row index in bytes.
+     */
+    size_t row_index_size() const {
+        return (nr + 1) * sizeof(size_t) + n * (sizeof(I) + sizeof(P));
+    }
+
+    /**
+     * Determine whether the row index should be used for the requested row, building it if necessary.
+     *
+     * @param r The requested row.
+     *
+     * @return Whether the row index is available. 
+     */
+    bool use_row_index(size_t r) {
+        if (row_index) {
+            return true;
+        }
+        if (!row_index_enabled || r == currow || r == currow + 1 || r + 1 == currow) {
+            return false;
+        }
+        if (row_index_size() > row_index_limit) {
+            return false;
+        }
+
+        auto store = std::make_shared<row_index_store>();
+        auto& ptr = store->ptr;
+        ptr.resize(nr + 1);
+        for (size_t v = 0; v < n; ++v) {
+            ++ptr[i[v] - base + 1];
+        }
+        for (size_t j = 0; j < nr; ++j) {
+            ptr[j + 1] += ptr[j];
+        }
+
+        // Using 'ptr' to hold the insertion position for each row, and then shifting it back.
+        store->cols.resize(n);
+        store->perm.resize(n);
+        for (size_t c = 0; c < nc; ++c) {
+            for (P v = p[c]; v < p[c + 1]; ++v) {
+                auto& pos = ptr[i[v] - base];
+                store->cols[pos] = c;
+                store->perm[pos] = v;
+                ++pos;
+            }
+        }
+        for (size_t j = nr; j > 0; --j) {
+            ptr[j] = ptr[j - 1];
+        }
+        ptr[0] = 0;
+
+        row_index = store;
+        return true;
+    }
+
+    /**
+     * Find the range of non-zero elements for a requested row in the row index.
+     *
+     * @param r The requested row.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return A pair of iterators to the column indices of the first and one-past-the-last non-zero element of `r` in `[first, last)`.
+     */
+    std::pair<typename std::vector<I>::const_iterator, typename std::vector<I>::const_iterator> search_row_index(size_t r, size_t first, size_t last) const {
+        auto start = row_index->cols.begin() + row_index->ptr[r];
+        auto end = row_index->cols.begin() + row_index->ptr[r + 1];
+        if (first) {
+            start = std::lower_bound(start, end, first);
+        }
+        if (last != nc) {
+            end = std::lower_bound(start, end, last);
+        }
+        return std::make_pair(start, end);
+    }
 
     /**
      * Update the index to the last requested non-zero element in each column.
@@ -313,14 +732,14 @@ private:
             ++pIt; // points to the first-past-the-end element, at any given 'c'.
             for (size_t c=first; c<last; ++c, ++pIt) {
                 P& curdex = indices[c];
-                if (curdex != *pIt && static_cast<size_t>(i[curdex]) < r) { 
+                if (curdex != *pIt && static_cast<size_t>(i[curdex]) < r + base) { 
                     ++curdex;
                 }
             }
         } else if (r+1 == currow) {
             for (size_t c=first; c<last; ++c, ++pIt) {
                 P& curdex = indices[c];
-                if (curdex != *pIt && static_cast<size_t>(i[curdex-1]) >= r) { 
+                if (curdex != *pIt && static_cast<size_t>(i[curdex-1]) >= r + base) { 
                     --curdex;
                 }
             }
@@ -329,11 +748,11 @@ private:
             if (r > currow) {
                 ++pIt; // points to the first-past-the-end element, at any given 'c'.
                 for (size_t c = first; c < last; ++c, ++pIt) { 
-                    indices[c] = std::lower_bound(i + indices[c], i + *pIt, r) - i;
+                    indices[c] = std::lower_bound(i + indices[c], i + *pIt, r + base) - i;
                 }
             } else { 
                 for (size_t c = first; c < last; ++c, ++pIt) {
-                    indices[c] = std::lower_bound(i + *pIt, i + indices[c], r) - i;
+                    indices[c] = std::lower_bound(i + *pIt, i + indices[c], r + base) - i;
                 }
             }
         }
@@ -357,7 +776,7 @@ private:
  * @tparam V The type of the `Rcpp::Vector` containing the data values.
  * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
  */
-template <class V, typename TIT = typename V::iterator>
+template <class V, typename TIT = const typename V::stored_type*>
 class gCMatrix_reader : public dim_checker {
 public:
     ~gCMatrix_reader() = default;
@@ -371,8 +790,13 @@ public:
      * This implements a series of checks for the validity of the slots for the compressed sparse column (CSC) format.
      *
      * @param mat An R object containing a `*gCMatrix` instance.
+     * @param detached Whether to detach the reader from `mat`, see `make_anchor()` for details.
      */
-    gCMatrix_reader(Rcpp::RObject mat) : i(mat.slot("i")), p(mat.slot("p")), x(mat.slot("x")) { 
+    gCMatrix_reader(Rcpp::RObject mat, bool detached = false) : 
+        i(make_raw_vector<Rcpp::IntegerVector>(mat.slot("i"))), 
+        x(make_raw_vector<V>(mat.slot("x"))),
+        anchor(make_anchor(mat, detached))
+    { 
         this->fill_dims(mat.slot("Dim"));
         const size_t& NC=this->ncol;
         const size_t& NR=this->nrow;
@@ -381,58 +805,35 @@ public:
             auto ctype = get_class_name(mat);
             throw std::runtime_error(std::string("'x' and 'i' slots in a ") + ctype + " object should have the same length"); 
         }
-        if (NC+1!=static_cast<size_t>(p.size())) { 
-            auto ctype = get_class_name(mat);
-            throw std::runtime_error(std::string("length of 'p' slot in a ") + ctype + " object should be equal to 'ncol+1'"); 
-        }
-        if (p[0]!=0) { 
-            auto ctype = get_class_name(mat);
-            throw std::runtime_error(std::string("first element of 'p' in a ") + ctype + " object should be 0"); 
-        }
-        if (p[NC]!=x.size()) { 
-            auto ctype = get_class_name(mat);
-            throw std::runtime_error(std::string("last element of 'p' in a ") + ctype + " object should be 'length(x)'"); 
-        }
-
-        // Checking all the indices.
-        auto pIt=p.begin();
-        for (size_t px=0; px<NC; ++px) {
-            int left = *pIt; // Integers as that's R's storage type. 
-            if (left < 0) { 
-                auto ctype = get_class_name(mat);
-                throw std::runtime_error(std::string("'p' slot in a ") + ctype + " object should contain non-negative values"); 
-            }
-
-            int right = *(++pIt);
-            if (left > right) { 
-                auto ctype = get_class_name(mat);
-                throw std::runtime_error(std::string("'p' slot in a ") + ctype + " object should be sorted"); 
-            }
-
-            --right; // Not checking the last element, as this is the start of the next column.
 
-            auto iIt=i.begin()+left;
-            for (int ix=left; ix<right; ++ix) {
-                const int& current=*iIt;
-                if (current > *(++iIt)) {
-                    auto ctype = get_class_name(mat);
-                    throw std::runtime_error(std::string("'i' in each column of a ") + ctype + " object should be sorted");
-                }
-                if (current < 0 || static_cast<size_t>(current) >= NR) {
+        Rcpp::RObject temp_p(mat.slot("p"));
+        if (temp_p.sexp_type() == REALSXP) {
+            /* Double-precision column pointers are used for matrices with more than 2^31 - 1 non-zero elements.
+             * These are converted into 64-bit integers, which only requires a copy of length 'ncol + 1'.
+             */
+            Rcpp::NumericVector dbl_p(temp_p);
+            std::vector<size_t> new_p(dbl_p.size());
+            auto npIt = new_p.begin();
+            for (auto current : dbl_p) {
+                if (!(current >= 0) || current != std::floor(current)) {
                     auto ctype = get_class_name(mat);
-                    throw std::runtime_error(std::string("'i' slot in a ") + ctype + " object should have entries in [0, nrow)");
+                    throw std::runtime_error(std::string("'p' slot in a ") + ctype + " object should contain non-negative integer values"); 
                 }
+                *npIt = current;
+                ++npIt;
             }
 
-            if (right >= left) {
-                if (*iIt < 0 || static_cast<size_t>(*iIt) >= NR) {
-                    auto ctype = get_class_name(mat);
-                    throw std::runtime_error(std::string("'i' slot in a ") + ctype + " object should have entries in [0, nrow)");
-                }
-            }
+            wide_p = raw_vector<size_t>(std::move(new_p));
+            check_pointers(mat, wide_p);
+            wide_core = Csparse_core<TIT, int, size_t>(i.size(), x.begin(), i.begin(), NR, NC, wide_p.begin());
+            wide = true;
+
+        } else {
+            p = make_raw_vector<Rcpp::IntegerVector>(temp_p);
+            check_pointers(mat, p);
+            core = Csparse_core<TIT, int, int>(i.size(), x.begin(), i.begin(), NR, NC, p.begin());
         }
 
-        core=Csparse_core<TIT, int, int>(i.size(), x.begin(), i.begin(), NR, NC, p.begin());
         return;                
     }
 
@@ -441,6 +842,9 @@ public:
      */
     sparse_index<TIT, int> get_col(size_t c, size_t first, size_t last) {
         this->check_colargs(c, first, last);
+        if (wide) {
+            return wide_core.get_col(c, first, last);
+        }
         return core.get_col(c, first, last);
     }
 
@@ -450,6 +854,9 @@ public:
     template <typename OUT, typename ALT = TIT>
     sparse_index<OUT, int> get_row(size_t r, ALT work_x, int* work_i, size_t first, size_t last) {
         this->check_rowargs(r, first, last);
+        if (wide) {
+            return wide_core.template get_row<OUT>(r, work_x, work_i, first, last);
+        }
         return core.template get_row<OUT>(r, work_x, work_i, first, last);
     }
 
@@ -459,7 +866,11 @@ public:
     template <typename ALT = TIT>
     ALT get_row(size_t r, ALT work, size_t first, size_t last) {
         this->check_rowargs(r, first, last);
-        core.get_row(r, work, first, last, 0);
+        if (wide) {
+            wide_core.get_row(r, work, first, last, 0);
+        } else {
+            core.get_row(r, work, first, last, 0);
+        }
         return work;
     }
 
@@ -469,19 +880,166 @@ public:
     template <typename ALT = TIT>
     ALT get_col(size_t c, ALT work, size_t first, size_t last) {
         this->check_colargs(c, first, last);
-        core.get_col(c, work, first, last, 0);
+        if (wide) {
+            wide_core.get_col(c, work, first, last, 0);
+        } else {
+            core.get_col(c, work, first, last, 0);
+        }
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT = TIT>
+    ALT get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        if (wide) {
+            wide_core.get_cols(first_col, last_col, work, first, last, 0);
+        } else {
+            core.get_cols(first_col, last_col, work, first, last, 0);
+        }
         return work;
     }
 
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, size_t*)
+     */
+    sparse_block<TIT, int> get_cols(size_t first_col, size_t last_col, size_t* work_p) {
+        this->check_colsargs(first_col, last_col, 0, this->nrow);
+        if (wide) {
+            return wide_core.get_cols(first_col, last_col, work_p);
+        }
+        return core.get_cols(first_col, last_col, work_p);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_block<OUT, int> get_cols(size_t first_col, size_t last_col, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        if (wide) {
+            return wide_core.template get_cols<OUT>(first_col, last_col, work_x, work_i, work_p, first, last);
+        }
+        return core.template get_cols<OUT>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_rows(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_row_block<OUT, int> get_rows(size_t first_row, size_t last_row, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_rowsargs(first_row, last_row, first, last);
+        if (wide) {
+            return wide_core.template get_rows<OUT>(first_row, last_row, work_x, work_i, work_p, first, last);
+        }
+        return core.template get_rows<OUT>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::set_row_index()
+     */
+    void set_row_index(bool use, size_t limit) {
+        if (wide) {
+            wide_core.set_row_index(use, limit);
+        } else {
+            core.set_row_index(use, limit);
+        }
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::has_row_index()
+     */
+    bool has_row_index() const {
+        return (wide ? wide_core.has_row_index() : core.has_row_index());
+    }
+
     /**
      * Get the number of non-zero elements in the object.
      */
     size_t get_nnzero () const { return x.size(); }
 
+    /**
+     * @return Whether the column pointers are stored as 64-bit integers,
+     * i.e., the `p` slot of the `*gCMatrix` was double-precision.
+     */
+    bool has_wide_pointers() const { return wide; }
+
 private:
-    Rcpp::IntegerVector i, p;
-    V x;
+    raw_vector<int> i, p;
+    raw_vector<size_t> wide_p;
+    raw_vector<typename V::stored_type> x;
+    std::shared_ptr<const Rcpp::RObject> anchor;
+
+    /* The usual integer column pointers are handled by 'core', while 'wide_core' is only used for double-precision pointers.
+     * This keeps the common case identical to the specialized 32-bit code, at the cost of a (predictable) branch per call.
+     */
+    bool wide = false;
     Csparse_core<TIT, int, int> core;
+    Csparse_core<TIT, int, size_t> wide_core;
+
+    template <typename PP>
+    void check_pointers(const Rcpp::RObject& mat, const raw_vector<PP>& ptrs) const {
+        const size_t& NC=this->ncol;
+        const size_t& NR=this->nrow;
+
+        if (NC+1!=ptrs.size()) { 
+            auto ctype = get_class_name(mat);
+            throw std::runtime_error(std::string("length of 'p' slot in a ") + ctype + " object should be equal to 'ncol+1'"); 
+        }
+        if (ptrs[0]!=0) { 
+            auto ctype = get_class_name(mat);
+            throw std::runtime_error(std::string("first element of 'p' in a ") + ctype + " object should be 0"); 
+        }
+        if (static_cast<size_t>(ptrs[NC])!=x.size()) { 
+            auto ctype = get_class_name(mat);
+            throw std::runtime_error(std::string("last element of 'p' in a ") + ctype + " object should be 'length(x)'"); 
+        }
+
+        /* Checking that the pointers are sorted before using any differences between them.
+         * Given the first and last elements, this also ensures that all pointers lie in [0, length(x)];
+         * no separate check for negative values is needed, which would be meaningless for unsigned 'PP'.
+         */
+        for (size_t px=1; px<=NC; ++px) {
+            if (ptrs[px] < ptrs[px-1]) {
+                auto ctype = get_class_name(mat);
+                throw std::runtime_error(std::string("'p' slot in a ") + ctype + " object should be sorted"); 
+            }
+        }
+
+        // Checking all the indices.
+        auto pIt=ptrs.begin();
+        for (size_t px=0; px<NC; ++px) {
+            PP left = *pIt; 
+            PP right = *(++pIt);
+            if (left == right) {
+                continue;
+            }
+
+            --right; // Not checking the last element, as this is the start of the next column.
+
+            auto iIt=i.begin()+left;
+            for (PP ix=left; ix<right; ++ix) {
+                const int& current=*iIt;
+                if (current > *(++iIt)) {
+                    auto ctype = get_class_name(mat);
+                    throw std::runtime_error(std::string("'i' in each column of a ") + ctype + " object should be sorted");
+                }
+                if (current < 0 || static_cast<size_t>(current) >= NR) {
+                    auto ctype = get_class_name(mat);
+                    throw std::runtime_error(std::string("'i' slot in a ") + ctype + " object should have entries in [0, nrow)");
+                }
+            }
+
+            if (*iIt < 0 || static_cast<size_t>(*iIt) >= NR) {
+                auto ctype = get_class_name(mat);
+                throw std::runtime_error(std::string("'i' slot in a ") + ctype + " object should have entries in [0, nrow)");
+            }
+        }
+        return;
+    }
 };
 
 /**
@@ -495,15 +1053,10 @@ private:
  * @tparam V The type of the `Rcpp::Vector` containing the data values.
  * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
  */
-template <class V, typename TIT = typename V::iterator>
+template <class V, typename TIT = const typename V::stored_type*>
 class SparseArraySeed_reader : public dim_checker {
 private:
-    struct sparse_triplet {
-        sparse_triplet(int _i, int _j, size_t _ptr) : i(_i), j(_j), ptr(_ptr) {}
-        int i;
-        int j;
-        size_t ptr;
-    };
+    typedef typename V::stored_type T;
 public:
     ~SparseArraySeed_reader() = default;
     SparseArraySeed_reader(const SparseArraySeed_reader&) = default;
@@ -514,18 +1067,26 @@ public:
     /**
      * Constructor from an R object containing a `SparseArraySeed` instance.
      * This implements a series of checks for the consistency of the slots.
-     * It will copy the row and column indices to make them zero-based,
-     * and if necessary, sort them to create a compressed sparse column (CSC) format.
+     * If the non-zero elements are already sorted by column and row, the row indices are used directly from `nzindex`
+     * and the 1-based offset is removed upon extraction.
+     * Otherwise, the elements are sorted to create a compressed sparse column (CSC) format with zero-based row indices.
      *
-     * @param mat An R object containing a `SparseArraySeed` instance.
+     * @param seed An R object containing a `SparseArraySeed` instance.
+     * @param detached Whether to detach the reader from `seed`, see `make_anchor()` for details.
      */
-    SparseArraySeed_reader(Rcpp::RObject seed) : x(seed.slot("nzdata")), i(x.size()) {
+    SparseArraySeed_reader(Rcpp::RObject seed, bool detached = false) : 
+        x(make_raw_vector<V>(seed.slot("nzdata"))), 
+        anchor(make_anchor(seed, detached))
+    {
         this->fill_dims(seed.slot("dim"));
         const size_t& NC=this->ncol;
         const size_t& NR=this->nrow;
-        p.resize(NC + 1);
+        std::vector<size_t> new_p(NC + 1);
+        std::vector<int> new_i;
+        int base = 0;
 
-        Rcpp::IntegerMatrix temp_i(Rcpp::RObject(seed.slot("nzindex")));
+        Rcpp::RObject nzindex(seed.slot("nzindex"));
+        Rcpp::IntegerMatrix temp_i(nzindex);
         if (temp_i.ncol() != 2) {
             auto ctype = get_class_name(seed);
             throw std::runtime_error(std::string("'nzindex' slot in a ") + ctype + " object should have two columns"); 
@@ -573,72 +1134,95 @@ public:
                     while (colIt != col_indices.end() && *colIt <= c) { 
                         ++colIt;
                     }
-                    p[c] = colIt - colStart;
+                    new_p[c] = colIt - colStart;
                 }
 
-                auto iIt = i.begin();
-                for (const auto& subi : row_indices) { 
-                    *iIt = subi - 1;
-                    ++iIt;
+                if (static_cast<SEXP>(temp_i) == static_cast<SEXP>(nzindex)) {
+                    // Pointing directly into 'nzindex', which is protected by 'seed' (or the caller, if detached).
+                    i = raw_vector<int>(static_cast<const int*>(temp_i.begin()), nnz);
+                    base = 1;
+                } else {
+                    new_i.resize(nnz);
+                    auto iIt = new_i.begin();
+                    for (const auto& subi : row_indices) { 
+                        *iIt = subi - 1;
+                        ++iIt;
+                    }
                 }
 
             } else {
-                std::vector<sparse_triplet> everything;
-                everything.reserve(nnz);
-
-                auto rowIt=row_indices.begin();
-                auto colIt=col_indices.begin();
-                auto xIt=x.begin();
-
-                for (int v = 0; v < nnz; ++v, ++rowIt, ++colIt, ++xIt) {
-                    everything.push_back(sparse_triplet(*rowIt, *colIt, v));
+                /* Two passes of a counting sort, first by row and then by column.
+                 * Both passes are stable, so ties are still broken by the original position,
+                 * and we only need one nnz-length buffer for the permutation from the first pass.
+                 */
+                std::vector<size_t> by_row(NR + 1);
+                for (auto r : row_indices) {
+                    ++by_row[r]; // 1-based, so this is already shifted for the cumulative sum.
+                }
+                for (size_t r = 1; r < NR; ++r) {
+                    by_row[r] += by_row[r - 1];
                 }
 
-                std::sort(everything.begin(), everything.end(), 
-                    [] (const sparse_triplet& left, const sparse_triplet& right) -> bool {
-                    if (left.j < right.j) {
-                        return true;
-                    } else if (left.j > right.j) {
-                        return false;
-                    } else if (left.i < right.i) {
-                        return true;
-                    } else if (left.i > right.i) {
-                        return false;
-                    } else if (left.ptr < right.ptr) {
-                        return true;
-                    } else {
-                        return false;
+                std::vector<size_t> order(nnz);
+                {
+                    auto rowIt=row_indices.begin();
+                    for (size_t v = 0; v < nnz; ++v, ++rowIt) {
+                        order[by_row[*rowIt - 1]++] = v;
                     }
-                });
+                }
 
-                V new_x(nnz);
-                for (size_t v = 0; v < nnz; ++v) {
-                    i[v] = everything[v].i - 1;
-                    new_x[v] = x[everything[v].ptr];
+                for (auto c : col_indices) {
+                    ++new_p[c];
+                }
+                for (size_t c = 1; c <= NC; ++c) {
+                    new_p[c] += new_p[c - 1];
                 }
-                x = new_x;
 
-                auto eIt = everything.begin();
-                auto eStart = eIt;
-                for (int c = 1; c <= static_cast<int>(NC); ++c) {
-                    while (eIt != everything.end() && eIt->j <= c) { // see above comments.
-                        ++eIt;
-                    }
-                    p[c] = eIt - eStart;
+                std::vector<size_t> by_col(new_p.begin(), new_p.end() - 1);
+                new_i.resize(nnz);
+                std::vector<T> new_x(nnz);
+                for (auto v : order) {
+                    auto& pos = by_col[col_indices[v] - 1];
+                    new_i[pos] = row_indices[v] - 1;
+                    new_x[pos] = x[v];
+                    ++pos;
                 }
+                x = raw_vector<T>(std::move(new_x));
             }
         }
 
-        core=Csparse_core<TIT, int, size_t>(nnz, x.begin(), i.begin(), NR, NC, p.data());
+        if (!base) {
+            i = raw_vector<int>(std::move(new_i));
+        }
+        p = raw_vector<size_t>(std::move(new_p));
+        core=Csparse_core<TIT, int, size_t>(nnz, x.begin(), i.begin(), NR, NC, p.begin(), base);
         return;
     }
 
     /**
-     * @copydoc Csparse_core::get_col(size_t, size_t, size_t)
+     * Get all non-zero elements from a column, possibly restricted to contiguous subset of rows.
+     * This is a no-copy operation for the values.
+     *
+     * @param c The index of the column to extract.
+     * @param work_i Pointer to a workspace for the row indices.
+     * This should have at least `last - first` addressable elements.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @return A `sparse_index` containing pointers to the non-zero elements in `c` with row indices in `[first, last)`.
+     * Zero-based row indices are copied into `work_i` if they are stored with a non-zero base, see `Csparse_core::get_base()`;
+     * otherwise, the operation is no-copy for the indices as well.
      */
-    sparse_index<TIT, int> get_col(size_t c, size_t first, size_t last) {
+    sparse_index<TIT, int> get_col(size_t c, int* work_i, size_t first, size_t last) {
         this->check_colargs(c, first, last);
-        return core.get_col(c, first, last);
+        auto out = core.get_col(c, first, last);
+        if (core.get_base()) {
+            for (size_t v = 0; v < out.n; ++v) {
+                work_i[v] = out.i[v] - 1;
+            }
+            out.i = work_i;
+        }
+        return out;
     }
 
     /**
@@ -670,18 +1254,232 @@ public:
         return work;
     }
 
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT = TIT>
+    ALT get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        core.get_cols(first_col, last_col, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * Get all non-zero elements from a contiguous block of columns.
+     * This is a no-copy operation for the values.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_i Pointer to a workspace for the row indices.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     * @param work_p Pointer to a workspace for the column pointers of the block.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     *
+     * @return A `sparse_block` containing pointers to the non-zero values and row indices,
+     * along with the rebased column pointers in `work_p`.
+     * Zero-based row indices are copied into `work_i` if they are stored with a non-zero base, see `Csparse_core::get_base()`;
+     * otherwise, the operation is no-copy for the indices as well.
+     */
+    sparse_block<TIT, int> get_cols(size_t first_col, size_t last_col, int* work_i, size_t* work_p) {
+        this->check_colsargs(first_col, last_col, 0, this->nrow);
+        auto out = core.get_cols(first_col, last_col, work_p);
+        if (core.get_base()) {
+            const size_t total = work_p[out.ncol];
+            for (size_t v = 0; v < total; ++v) {
+                work_i[v] = out.i[v] - 1;
+            }
+            out.i = work_i;
+        }
+        return out;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_block<OUT, int> get_cols(size_t first_col, size_t last_col, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        return core.template get_cols<OUT>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_rows(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT = TIT>
+    sparse_row_block<OUT, int> get_rows(size_t first_row, size_t last_row, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_rowsargs(first_row, last_row, first, last);
+        return core.template get_rows<OUT>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::set_row_index()
+     */
+    void set_row_index(bool use, size_t limit) {
+        core.set_row_index(use, limit);
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::has_row_index()
+     */
+    bool has_row_index() const {
+        return core.has_row_index();
+    }
+
     /**
      * Get the number of non-zero elements in the object.
      */
     size_t get_nnzero () const { return x.size(); }
 
 private:
-    V x;
-    Rcpp::IntegerVector i;
-    std::vector<size_t> p;
+    raw_vector<T> x;
+    raw_vector<int> i;
+    raw_vector<size_t> p;
+    std::shared_ptr<const Rcpp::RObject> anchor;
     Csparse_core<TIT, int, size_t> core;
 };
 
+/**
+ * @brief Reader for a compressed sparse column (CSC) matrix with single-precision values, stored in memory.
+ *
+ * The non-zero elements are held in vectors that are shared between copies of the reader,
+ * such that copying (and using) a reader never involves any allocations proportional to the number of non-zero elements.
+ */
+class float_Csparse_reader : public dim_checker {
+public:
+    ~float_Csparse_reader() = default;
+    float_Csparse_reader(const float_Csparse_reader&) = default;
+    float_Csparse_reader& operator=(const float_Csparse_reader&) = default;
+    float_Csparse_reader(float_Csparse_reader&&) = default;
+    float_Csparse_reader& operator=(float_Csparse_reader&&) = default;
+
+    /**
+     * Constructor from the usual CSC arrays.
+     *
+     * @param nr Number of rows.
+     * @param nc Number of columns.
+     * @param _x Vector of non-zero values.
+     * @param _i Vector of zero-based row indices for the non-zero values, sorted within each column.
+     * This should be of the same length as `_x`.
+     * @param _p Vector of column pointers, of length equal to `nc + 1`.
+     *
+     * @details
+     * All arguments are moved into the reader.
+     * The row indices are assumed to be valid, as this class is only constructed from the output of another reader.
+     */
+    float_Csparse_reader(size_t nr, size_t nc, std::vector<float> _x, std::vector<int> _i, std::vector<size_t> _p) : 
+        store(std::make_shared<contents>(std::move(_x), std::move(_i), std::move(_p))) 
+    {
+        this->nrow = nr;
+        this->ncol = nc;
+        const auto& cur = *store;
+        if (cur.p.size() != nc + 1) {
+            throw std::runtime_error("length of column pointers should be equal to the number of columns plus 1");
+        }
+        if (cur.p[0] != 0 || cur.p[nc] != cur.x.size() || cur.i.size() != cur.x.size()) {
+            throw std::runtime_error("column pointers are not consistent with the number of non-zero elements");
+        }
+        core = Csparse_core<const float*, int, size_t>(cur.x.size(), cur.x.data(), cur.i.data(), nr, nc, cur.p.data());
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_col(size_t, size_t, size_t)
+     */
+    sparse_index<const float*, int> get_col(size_t c, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        return core.get_col(c, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_row(size_t, ALT, I*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT>
+    sparse_index<OUT, int> get_row(size_t r, ALT work_x, int* work_i, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        return core.template get_row<OUT>(r, work_x, work_i, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_row(size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT>
+    ALT get_row(size_t r, ALT work, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        core.get_row(r, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_col(size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT>
+    ALT get_col(size_t c, ALT work, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        core.get_col(c, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, size_t, size_t, T)
+     */
+    template <typename ALT>
+    ALT get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        core.get_cols(first_col, last_col, work, first, last, 0);
+        return work;
+    }
+
+    /**
+     * @copydoc Csparse_core::get_cols(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT>
+    sparse_block<OUT, int> get_cols(size_t first_col, size_t last_col, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        return core.template get_cols<OUT>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::get_rows(size_t, size_t, ALT, I*, size_t*, size_t, size_t)
+     */
+    template <typename OUT, typename ALT>
+    sparse_row_block<OUT, int> get_rows(size_t first_row, size_t last_row, ALT work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        this->check_rowsargs(first_row, last_row, first, last);
+        return core.template get_rows<OUT>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * @copydoc Csparse_core::set_row_index()
+     */
+    void set_row_index(bool use, size_t limit) {
+        core.set_row_index(use, limit);
+        return;
+    }
+
+    /**
+     * @copydoc Csparse_core::has_row_index()
+     */
+    bool has_row_index() const {
+        return core.has_row_index();
+    }
+
+    /**
+     * Get the number of non-zero elements in the object.
+     */
+    size_t get_nnzero () const { return store->x.size(); }
+
+private:
+    struct contents {
+        contents(std::vector<float> _x, std::vector<int> _i, std::vector<size_t> _p) : x(std::move(_x)), i(std::move(_i)), p(std::move(_p)) {}
+        std::vector<float> x;
+        std::vector<int> i;
+        std::vector<size_t> p;
+    };
+
+    std::shared_ptr<const contents> store;
+    Csparse_core<const float*, int, size_t> core;
+};
+
 }
 
 #endif
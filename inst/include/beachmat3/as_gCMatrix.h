@@ -9,6 +9,8 @@
 
 #include "Rcpp.h"
 #include <map>
+#include <vector>
+#include <limits>
 
 namespace beachmat {
 
@@ -40,6 +42,25 @@ inline Rcpp::S4 generate_gCMatrix<Rcpp::NumericVector> () {
     return Rcpp::S4("dgCMatrix");
 }
 
+/**
+ * Create the column pointers for a `*gCMatrix`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param ptrs Vector of column pointers, of length equal to the number of columns plus 1.
+ *
+ * @return An integer vector containing the column pointers.
+ * If the total number of non-zero elements exceeds the range of R's integers,
+ * a double-precision vector is returned instead.
+ */
+inline Rcpp::RObject create_pointers(const std::vector<size_t>& ptrs) {
+    if (ptrs.back() <= static_cast<size_t>(std::numeric_limits<int>::max())) {
+        return Rcpp::IntegerVector(ptrs.begin(), ptrs.end());
+    } else {
+        return Rcpp::NumericVector(ptrs.begin(), ptrs.end());
+    }
+}
+
 /**
  * Create a `*gCMatrix` from a triplet-formatted store of non-zero entries.
  * Best used when the number of non-zero entries is not known in advance.
@@ -60,8 +81,10 @@ inline Rcpp::S4 generate_gCMatrix<Rcpp::NumericVector> () {
  * (If multiple elements have the same row/column indices, the last element in the store is used.)
  * One can naturally obtain an appropriate store with a `std::map<std::pair<int, int>, double>`, which sorts for us as well.
  * Alternatively, we can create a store manually with `std::deque<std::pair<std::pair<int, int>, double> >`.
+ * For large matrices, consider using a `gCMatrix_builder` instead, which avoids the per-entry overhead of a `std::map`.
  *
  * @return A `dgCMatrix` or `lgCMatrix` instance (depending on `V`) containing all entries in `store`.
+ * The `p` slot is double-precision if the number of entries is greater than the largest integer in R.
  */
 template <class V, class S>
 inline Rcpp::RObject as_gCMatrix (int nr, int nc, const S& store) {
@@ -71,13 +94,13 @@ inline Rcpp::RObject as_gCMatrix (int nr, int nc, const S& store) {
     const size_t nnzero = store.size();
     Rcpp::IntegerVector i(nnzero);
     V x(nnzero);
-    Rcpp::IntegerVector p(nc + 1, 0);
+    std::vector<size_t> p(nc + 1);
 
     auto xIt=x.begin();
     auto iIt=i.begin();
     auto sIt = store.begin();
 
-    int counter = 0;
+    size_t counter = 0;
     int lastcol = 0, lastrow = 0;
 
     for (int c = 1; c <= nc; ++c) {
@@ -108,11 +131,11 @@ inline Rcpp::RObject as_gCMatrix (int nr, int nc, const S& store) {
         p[c] = counter;
     }
     
-    if (static_cast<size_t>(counter) != store.size()) {
+    if (counter != store.size()) {
         throw std::runtime_error("entries in 'store' refer to out-of-range columns");
     }
 
-    mat.slot("p")=p;
+    mat.slot("p")=create_pointers(p);
     mat.slot("i")=i;
     mat.slot("x")=x;
 
@@ -23,6 +23,8 @@
 #include "Rcpp.h"
 #include "read_lin_block.h"
 #include "as_gCMatrix.h"
+#include "gCMatrix_builder.h"
+#include "dense_output.h"
 #include <stdexcept>
 #include <memory>
 
@@ -0,0 +1,272 @@
+#ifndef BEACHMAT_DELAYED_OP_H
+#define BEACHMAT_DELAYED_OP_H
+
+/**
+ * @file delayed_op.h
+ *
+ * Native evaluation of common value-modifying operations in a `DelayedMatrix`.
+ *
+ * These operations are parsed from the `DelayedUnaryIsoOpStack` and `DelayedUnaryIsoOpWithArgs` nodes
+ * at the top of the delayed operation tree by `beachmat:::setupDelayedMatrix()`.
+ * Each operation is either a unary math function (`log`, `log1p`, `log2`, `log10`, `sqrt`, `exp`, `expm1`, `abs`)
+ * or an arithmetic or comparison operator involving a scalar or a vector that is recycled along the rows or columns.
+ *
+ * This header only depends on Rcpp, so that it can be shared by the delayed readers of both the version 2 and 3 APIs.
+ */
+
+#include "Rcpp.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace beachmat {
+
+/**
+ * @brief A single delayed operation to be applied to double-precision values.
+ *
+ * @note This is an internal class and should not be used directly by **beachmat** users.
+ */
+class delayed_op {
+public:
+    /**
+     * Constructor from the R-level description of the operation.
+     *
+     * @param info A list of length 4, containing the name of the operation as a string;
+     * a double-precision vector containing the argument (possibly of length zero for unary functions);
+     * an integer scalar specifying the dimension along which the argument is recycled, i.e., 0 for scalars, 1 for rows and 2 for columns;
+     * and a logical scalar specifying whether the argument is on the left-hand side of the operator.
+     */
+    delayed_op(const Rcpp::List& info) {
+        if (info.size()!=4) {
+            throw std::runtime_error("delayed operation should be described by a list of length 4");
+        }
+
+        Rcpp::StringVector nm(info[0]);
+        if (nm.size()!=1) {
+            throw std::runtime_error("name of the delayed operation should be a string");
+        }
+        const std::string name = Rcpp::as<std::string>(nm[0]);
+        static const char* names[] = { "+", "-", "*", "/", "^", "%%", "%/%", "==", "!=", "<", ">", "<=", ">=",
+            "log", "log1p", "log2", "log10", "sqrt", "exp", "expm1", "abs" };
+        auto it = std::find(std::begin(names), std::end(names), name);
+        if (it == std::end(names)) {
+            throw std::runtime_error("unsupported delayed operation '" + name + "'");
+        }
+        code = static_cast<code_type>(it - std::begin(names));
+
+        Rcpp::NumericVector val(info[1]);
+        value.insert(value.end(), val.begin(), val.end());
+
+        Rcpp::IntegerVector al(info[2]);
+        Rcpp::LogicalVector lft(info[3]);
+        if (al.size()!=1 || lft.size()!=1) {
+            throw std::runtime_error("'along' and 'left' should be of length 1");
+        }
+        along = al[0];
+        left = lft[0];
+
+        bool okay = true;
+        if (code < LOG) {
+            okay = (along==0 && value.size()==1) || along==1 || along==2;
+        } else {
+            okay = along==0 && value.size() <= static_cast<size_t>(code==LOG);
+        }
+        if (!okay) {
+            throw std::runtime_error("invalid argument for delayed operation '" + name + "'");
+        }
+        return;
+    }
+
+    /**
+     * Apply the operation to an array of values.
+     *
+     * @tparam ARG A callable that accepts an index `i` and returns the argument for the `i`-th value.
+     *
+     * @param vals Pointer to an array of values, to be modified in place.
+     * @param n Number of values.
+     * @param arg The callable for the arguments, ignored for unary functions.
+     */
+    template<class ARG>
+    void transform(double* vals, size_t n, ARG arg) const {
+        switch (code) {
+            case ADD:
+                binary(vals, n, arg, [](double x, double y) -> double { return x + y; });
+                break;
+            case SUBTRACT:
+                binary(vals, n, arg, [](double x, double y) -> double { return x - y; });
+                break;
+            case MULTIPLY:
+                binary(vals, n, arg, [](double x, double y) -> double { return x * y; });
+                break;
+            case DIVIDE:
+                binary(vals, n, arg, [](double x, double y) -> double { return x / y; });
+                break;
+            case POWER:
+                binary(vals, n, arg, [](double x, double y) -> double { return std::pow(x, y); });
+                break;
+            case MODULO:
+                binary(vals, n, arg, [](double x, double y) -> double { return x - std::floor(x / y) * y; });
+                break;
+            case INT_DIVIDE:
+                binary(vals, n, arg, [](double x, double y) -> double { return std::floor(x / y); });
+                break;
+            case EQUAL:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x == y); });
+                break;
+            case NOT_EQUAL:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x != y); });
+                break;
+            case LESS:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x < y); });
+                break;
+            case GREATER:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x > y); });
+                break;
+            case LESS_EQUAL:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x <= y); });
+                break;
+            case GREATER_EQUAL:
+                binary(vals, n, arg, [](double x, double y) -> double { return compare(x, y, x >= y); });
+                break;
+            case LOG:
+                if (value.empty()) {
+                    unary(vals, n, [](double x) -> double { return std::log(x); });
+                } else {
+                    const double base = std::log(value[0]);
+                    unary(vals, n, [=](double x) -> double { return std::log(x) / base; });
+                }
+                break;
+            case LOG1P:
+                unary(vals, n, [](double x) -> double { return std::log1p(x); });
+                break;
+            case LOG2:
+                unary(vals, n, [](double x) -> double { return std::log2(x); });
+                break;
+            case LOG10:
+                unary(vals, n, [](double x) -> double { return std::log10(x); });
+                break;
+            case SQRT:
+                unary(vals, n, [](double x) -> double { return std::sqrt(x); });
+                break;
+            case EXP:
+                unary(vals, n, [](double x) -> double { return std::exp(x); });
+                break;
+            case EXPM1:
+                unary(vals, n, [](double x) -> double { return std::expm1(x); });
+                break;
+            case ABS:
+                unary(vals, n, [](double x) -> double { return std::abs(x); });
+                break;
+        }
+        return;
+    }
+
+    /**
+     * Apply the operation to a contiguous stretch of values in a row or column.
+     *
+     * @param vals Pointer to an array of values, to be modified in place.
+     * @param n Number of values.
+     * @param by_row Whether the values belong to a row.
+     * @param index Index of the row (if `by_row = true`) or column (otherwise).
+     * @param first Index of the column (if `by_row = true`) or row (otherwise) corresponding to the first value.
+     */
+    void transform(double* vals, size_t n, bool by_row, size_t index, size_t first) const {
+        if (along == 0) {
+            const double* ptr = value.data();
+            transform(vals, n, [=](size_t) -> double { return *ptr; });
+        } else if ((along == 1) == by_row) {
+            const double cur = value[index];
+            transform(vals, n, [=](size_t) -> double { return cur; });
+        } else {
+            const double* ptr = value.data() + first;
+            transform(vals, n, [=](size_t i) -> double { return ptr[i]; });
+        }
+        return;
+    }
+
+    /**
+     * Apply the operation to the non-zero values in a row or column.
+     *
+     * @param vals Pointer to an array of non-zero values, to be modified in place.
+     * @param idx Pointer to an array of column (if `by_row = true`) or row indices (otherwise) for the non-zero values.
+     * @param n Number of non-zero values.
+     * @param by_row Whether the values belong to a row.
+     * @param index Index of the row (if `by_row = true`) or column (otherwise).
+     */
+    void transform(double* vals, const int* idx, size_t n, bool by_row, size_t index) const {
+        if (along == 0) {
+            const double* ptr = value.data();
+            transform(vals, n, [=](size_t) -> double { return *ptr; });
+        } else if ((along == 1) == by_row) {
+            const double cur = value[index];
+            transform(vals, n, [=](size_t) -> double { return cur; });
+        } else {
+            const double* ptr = value.data();
+            transform(vals, n, [=](size_t i) -> double { return ptr[idx[i]]; });
+        }
+        return;
+    }
+
+    /**
+     * @return Whether the operation maps a zero to a zero for all possible arguments.
+     */
+    bool preserves_zero() const {
+        const size_t n = std::max(value.size(), static_cast<size_t>(1));
+        std::vector<double> zeroes(n);
+        const double* ptr = value.data();
+        transform(zeroes.data(), n, [=](size_t i) -> double { return ptr[i]; });
+        for (auto z : zeroes) {
+            if (z != 0) { // also false for NaN.
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    enum code_type { ADD, SUBTRACT, MULTIPLY, DIVIDE, POWER, MODULO, INT_DIVIDE,
+        EQUAL, NOT_EQUAL, LESS, GREATER, LESS_EQUAL, GREATER_EQUAL,
+        LOG, LOG1P, LOG2, LOG10, SQRT, EXP, EXPM1, ABS };
+
+    code_type code;
+    std::vector<double> value;
+    int along;
+    bool left;
+
+    static double compare(double x, double y, bool result) {
+        if (std::isnan(x) || std::isnan(y)) {
+            return NA_REAL;
+        }
+        return result;
+    }
+
+    template<class ARG, class F>
+    void binary(double* vals, size_t n, ARG arg, F fun) const {
+        if (left) {
+            for (size_t i = 0; i < n; ++i) {
+                vals[i] = fun(arg(i), vals[i]);
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                vals[i] = fun(vals[i], arg(i));
+            }
+        }
+        return;
+    }
+
+    template<class F>
+    static void unary(double* vals, size_t n, F fun) {
+        for (size_t i = 0; i < n; ++i) {
+            vals[i] = fun(vals[i]);
+        }
+        return;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef BEACHMAT_DELAYED_OPS_H
+#define BEACHMAT_DELAYED_OPS_H
+
+/**
+ * @file delayed_ops.h
+ *
+ * Application of a series of delayed operations to values extracted from a seed matrix.
+ * See `delayed_op.h` for the individual operations.
+ */
+
+#include "Rcpp.h"
+#include "delayed_op.h"
+#include "Csparse_reader.h"
+#include "utils.h"
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace beachmat {
+
+/**
+ * @brief A series of delayed operations, applied to values extracted from a seed matrix.
+ *
+ * All operations are performed in double precision, mimicking R's treatment of missing values.
+ * Integer or logical values from the seed are converted to doubles (with `NA_INTEGER` becoming `NA_REAL`) before any operation is applied,
+ * while requests for integer results will convert non-finite or out-of-range values to `NA_INTEGER`.
+ *
+ * @note This is an internal class and should not be used directly by **beachmat** users.
+ */
+class delayed_op_stack {
+public:
+    /**
+     * Default constructor, for an empty stack.
+     */
+    delayed_op_stack() = default;
+
+    /**
+     * Constructor from the R-level description of the operations.
+     *
+     * @param info A list of operations in the order of application, where each entry is as described in the `delayed_op` constructor.
+     * @param integer_seed Whether the seed contains integer or logical values.
+     */
+    delayed_op_stack(const Rcpp::List& info, bool integer_seed) : integer_seed(integer_seed) {
+        for (size_t i = 0; i < info.size(); ++i) {
+            Rcpp::List current = info[i];
+            ops.push_back(delayed_op(current));
+        }
+        return;
+    }
+
+    /**
+     * @return Whether all operations map a zero to a zero, such that the sparsity of the seed is preserved.
+     */
+    bool preserves_zero() const {
+        for (const auto& op : ops) {
+            if (!op.preserves_zero()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Extract a row or column from the seed and apply the operations.
+     *
+     * @tparam M Class of the seed matrix, typically a `lin_matrix`.
+     *
+     * @param seed The seed matrix.
+     * @param by_row Whether to extract a row.
+     * @param index Index of the row (if `by_row = true`) or column (otherwise).
+     * @param work Workspace of length at least `last - first`, in which the results are stored.
+     * @param first Index of the first column (if `by_row = true`) or row (otherwise) of interest.
+     * @param last Index of one-past-the-last column (if `by_row = true`) or row (otherwise) of interest.
+     *
+     * @return Pointer to `work`.
+     */
+    template<class M>
+    const double* fetch(M& seed, bool by_row, size_t index, double* work, size_t first, size_t last) {
+        const size_t n = last - first;
+        if (integer_seed) {
+            ibuffer.resize(n);
+            const int* ptr = (by_row ? seed.get_row(index, ibuffer.data(), first, last) : seed.get_col(index, ibuffer.data(), first, last));
+            convert(ptr, n, work);
+        } else {
+            const double* ptr = (by_row ? seed.get_row(index, work, first, last) : seed.get_col(index, work, first, last));
+            if (ptr != work) {
+                std::copy(ptr, ptr + n, work);
+            }
+        }
+
+        for (const auto& op : ops) {
+            op.transform(work, n, by_row, index, first);
+        }
+        return work;
+    }
+
+    /**
+     * Extract a row or column from the seed and apply the operations, returning integer results.
+     * Arguments are as described for the double-precision overload.
+     */
+    template<class M>
+    const int* fetch(M& seed, bool by_row, size_t index, int* work, size_t first, size_t last) {
+        const size_t n = last - first;
+        dbuffer.resize(n);
+        fetch(seed, by_row, index, dbuffer.data(), first, last);
+        convert(dbuffer.data(), n, work);
+        return work;
+    }
+
+    /**
+     * Extract the non-zero values of a row or column from a sparse seed and apply the operations.
+     * This should only be used if `preserves_zero()` is true.
+     *
+     * @tparam M Class of the seed matrix, typically a `lin_sparse_matrix`.
+     *
+     * @param seed The seed matrix.
+     * @param by_row Whether to extract a row.
+     * @param index Index of the row (if `by_row = true`) or column (otherwise).
+     * @param work_x Workspace of length at least `last - first`, in which the values are stored.
+     * @param work_i Workspace of length at least `last - first`, in which the indices are stored.
+     * @param first Index of the first column (if `by_row = true`) or row (otherwise) of interest.
+     * @param last Index of one-past-the-last column (if `by_row = true`) or row (otherwise) of interest.
+     *
+     * @return A `sparse_index` containing pointers to `work_x` and `work_i`.
+     */
+    template<class M>
+    sparse_index<const double*, int> fetch(M& seed, bool by_row, size_t index, double* work_x, int* work_i, size_t first, size_t last) {
+        size_t n = 0;
+        if (integer_seed) {
+            ibuffer.resize(last - first);
+            auto out = (by_row ? seed.get_row(index, ibuffer.data(), work_i, first, last) : seed.get_col(index, ibuffer.data(), work_i, first, last));
+            n = out.n;
+            convert(out.x, n, work_x);
+            copy_indices(out.i, n, work_i);
+        } else {
+            auto out = (by_row ? seed.get_row(index, work_x, work_i, first, last) : seed.get_col(index, work_x, work_i, first, last));
+            n = out.n;
+            if (out.x != work_x) {
+                std::copy(out.x, out.x + n, work_x);
+            }
+            copy_indices(out.i, n, work_i);
+        }
+
+        for (const auto& op : ops) {
+            op.transform(work_x, work_i, n, by_row, index);
+        }
+        return sparse_index<const double*, int>(n, work_x, work_i);
+    }
+
+    /**
+     * Extract the non-zero values of a row or column from a sparse seed and apply the operations, returning integer results.
+     * Arguments are as described for the double-precision overload.
+     */
+    template<class M>
+    sparse_index<const int*, int> fetch(M& seed, bool by_row, size_t index, int* work_x, int* work_i, size_t first, size_t last) {
+        dbuffer.resize(last - first);
+        auto out = fetch(seed, by_row, index, dbuffer.data(), work_i, first, last);
+        convert(out.x, out.n, work_x);
+        return sparse_index<const int*, int>(out.n, work_x, work_i);
+    }
+
+private:
+    std::vector<delayed_op> ops;
+    bool integer_seed = false;
+    std::vector<int> ibuffer;
+    std::vector<double> dbuffer;
+
+    static void convert(const int* in, size_t n, double* out) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (in[i] == NA_INTEGER ? NA_REAL : in[i]);
+        }
+    }
+
+    static void convert(const double* in, size_t n, int* out) {
+        for (size_t i = 0; i < n; ++i) {
+            const double x = in[i];
+            const bool valid = std::isfinite(x) && x > -2147483647.5 && x < 2147483647.5;
+            out[i] = (valid ? static_cast<int>(x) : NA_INTEGER);
+        }
+    }
+
+    static void copy_indices(const int* in, size_t n, int* out) {
+        if (in != out) {
+            std::copy(in, in + n, out);
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef BEACHMAT_DENSE_OUTPUT_H
+#define BEACHMAT_DENSE_OUTPUT_H
+
+/**
+ * @file dense_output.h
+ *
+ * Class to fill an ordinary R matrix through raw pointers.
+ */
+
+#include "Rcpp.h"
+#include "dim_checker.h"
+#include "Csparse_reader.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace beachmat {
+
+/**
+ * @brief Dense output matrix that is allocated once and filled through raw pointers.
+ *
+ * The R matrix is allocated (and zero-initialized) in the constructor,
+ * after which each column can be accessed as a contiguous array of `int`s or `double`s.
+ * `yield()` then returns the same R object without any copying.
+ *
+ * None of the methods other than the constructor and `yield()` involve the R API.
+ * Thus, different columns can be filled concurrently from different threads, e.g., by assigning a disjoint range of columns to each thread.
+ * However, concurrent writes to the same column are not safe, and the constructor and `yield()` must be called from the main thread.
+ *
+ * @tparam V An `Rcpp::Vector` class, to be used as the storage of the output matrix.
+ * This can be any of `Rcpp::LogicalVector`, `Rcpp::IntegerVector` or `Rcpp::NumericVector`.
+ */
+template <class V>
+class dense_output : public dim_checker {
+private:
+    typedef typename V::stored_type T;
+public:
+    /**
+     * Constructor for an all-zero matrix.
+     *
+     * @param _nr Number of rows.
+     * @param _nc Number of columns.
+     */
+    dense_output(int _nr, int _nc) {
+        this->fill_dims(Rcpp::IntegerVector::create(_nr, _nc));
+        mat = V(static_cast<R_xlen_t>(this->nrow) * static_cast<R_xlen_t>(this->ncol));
+        mat.attr("dim") = Rcpp::IntegerVector::create(_nr, _nc);
+        ptr = static_cast<T*>(mat.begin());
+    }
+
+    /**
+     * @return Pointer to the start of the matrix contents, stored in column-major format.
+     */
+    T* data() { return ptr; }
+
+    /**
+     * Get a pointer to a column of the matrix.
+     *
+     * @param c Index of the column.
+     *
+     * @return Pointer to the start of column `c`, with `get_nrow()` addressable elements.
+     */
+    T* get_col(size_t c) {
+        this->check_colargs(c);
+        return ptr + c * this->nrow;
+    }
+
+    /**
+     * Fill a contiguous block of rows in a column of the matrix.
+     *
+     * @tparam TIT Iterator to the input values, possibly of a different type from the storage type of `V`.
+     *
+     * @param c Index of the column.
+     * @param x Iterator to the start of the input values for rows in `[first, last)`.
+     * @param first Index of the first row to fill.
+     * @param last Index of one past the last row to fill.
+     *
+     * @details
+     * This can be directly used with the output of `lin_matrix::get_col()`,
+     * where `int`-to-`double` conversions are vectorized.
+     */
+    template <typename TIT>
+    void set_col(size_t c, TIT x, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        copy_n_values(x, last - first, get_col(c) + first);
+        return;
+    }
+
+    /**
+     * Fill a column of the matrix.
+     *
+     * @tparam TIT Iterator to the input values, possibly of a different type from the storage type of `V`.
+     *
+     * @param c Index of the column.
+     * @param x Iterator to the start of the input values, of length equal to `get_nrow()`.
+     */
+    template <typename TIT>
+    void set_col(size_t c, TIT x) {
+        set_col(c, x, 0, this->nrow);
+        return;
+    }
+
+    /**
+     * Fill a column of the matrix with non-zero entries, setting all other entries to zero.
+     *
+     * @tparam TIT Iterator to the non-zero values, possibly of a different type from the storage type of `V`.
+     * @tparam I Integer type of the row indices.
+     *
+     * @param c Index of the column.
+     * @param entries A `sparse_index` containing the row indices and values of the non-zero entries in column `c`,
+     * e.g., as returned by `lin_sparse_matrix::get_col()`.
+     */
+    template <typename TIT, typename I>
+    void set_col(size_t c, const sparse_index<TIT, I>& entries) {
+        auto curcol = get_col(c);
+        for (size_t v = 0; v < entries.n; ++v) {
+            dim_checker::check_dimension(entries.i[v], this->nrow, "row");
+        }
+        std::fill(curcol, curcol + this->nrow, 0);
+        scatter_values(entries.x, entries.i, entries.n, curcol, 0);
+        return;
+    }
+
+    /**
+     * @return The R matrix containing all values that have been filled.
+     * This shares memory with the `dense_output`, so further modifications will be reflected in the returned object.
+     */
+    Rcpp::RObject yield() const {
+        return mat;
+    }
+private:
+    V mat;
+    T* ptr;
+};
+
+}
+
+#endif
@@ -153,6 +153,38 @@ protected:
         dim_checker::check_subset(first, last, nrow, "row");
         return;
     }
+
+    /**
+     * Check that the requested column range and row subsets are compatible with the stored dimensions.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @return An error is raised for invalid indices, see `check_subset()`.
+     */
+    void check_colsargs(size_t first_col, size_t last_col, size_t first, size_t last) const {
+        dim_checker::check_subset(first_col, last_col, ncol, "column");
+        dim_checker::check_subset(first, last, nrow, "row");
+        return;
+    }
+
+    /**
+     * Check that the requested row range and column subsets are compatible with the stored dimensions.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return An error is raised for invalid indices, see `check_subset()`.
+     */
+    void check_rowsargs(size_t first_row, size_t last_row, size_t first, size_t last) const {
+        dim_checker::check_subset(first_row, last_row, nrow, "row");
+        dim_checker::check_subset(first, last, ncol, "column");
+        return;
+    }
 };
 
 }
@@ -0,0 +1,215 @@
+#ifndef BEACHMAT_GCMATRIX_BUILDER_H
+#define BEACHMAT_GCMATRIX_BUILDER_H
+
+/**
+ * @file gCMatrix_builder.h
+ *
+ * Class to incrementally build `*gCMatrix` instances.
+ */
+
+#include "Rcpp.h"
+#include "as_gCMatrix.h"
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace beachmat {
+
+/**
+ * @brief Incremental builder for a `*gCMatrix`, without requiring a sorted triplet store.
+ *
+ * Non-zero entries are held in per-column buffers of row indices and values,
+ * which are sorted by row (if necessary) and concatenated into the compressed sparse column format upon calling `build()`.
+ * This is more memory-efficient than filling a `std::map` for `as_gCMatrix()`,
+ * and entries can be added in any order.
+ *
+ * Adding entries does not involve the R API, so different columns can be filled concurrently from different threads.
+ * However, concurrent additions to the same column are not safe, and `build()` must be called from the main thread.
+ *
+ * @tparam V An `Rcpp::Vector` class, to be used as the `x` slot in the output `*gCMatrix`.
+ * Only `Rcpp::NumericVector` and `Rcpp::LogicalVector` are supported.
+ */
+template <class V>
+class gCMatrix_builder {
+private:
+    typedef typename V::stored_type T;
+public:
+    /**
+     * Constructor for an all-zero matrix.
+     *
+     * @param _nr Number of rows.
+     * @param _nc Number of columns.
+     */
+    gCMatrix_builder(int _nr, int _nc) : nr(_nr), nc(_nc), rows(_nc), values(_nc), sorted(_nc, 1) {}
+
+    /**
+     * Reserve space for the non-zero entries in a column.
+     * This is optional but avoids reallocations when the number of non-zero entries is known in advance.
+     *
+     * @param c Index of the column.
+     * @param n Expected number of non-zero entries in column `c`.
+     */
+    void reserve(size_t c, size_t n) {
+        check_column(c);
+        rows[c].reserve(n);
+        values[c].reserve(n);
+        return;
+    }
+
+    /**
+     * Add a non-zero entry to the matrix.
+     * If multiple entries are added for the same row and column, the last one is used.
+     *
+     * @param r Index of the row.
+     * @param c Index of the column.
+     * @param val Value of the entry.
+     */
+    void add(int r, size_t c, T val) {
+        check_column(c);
+        check_row(r);
+
+        auto& currows = rows[c];
+        if (!currows.empty() && currows.back() >= r) {
+            sorted[c] = 0;
+        }
+        currows.push_back(r);
+        values[c].push_back(val);
+        return;
+    }
+
+    /**
+     * Add a series of non-zero entries to a column.
+     * If multiple entries are added for the same row and column, the last one is used.
+     *
+     * @tparam TIT Iterator to the non-zero values, possibly of a different type from the storage type of `V`.
+     *
+     * @param c Index of the column.
+     * @param idx Pointer to an array of row indices of the non-zero entries.
+     * @param x Iterator to the start of the values of the non-zero entries.
+     * @param n Number of non-zero entries.
+     *
+     * @details
+     * This can be directly used with the output of `lin_sparse_matrix::get_col()`.
+     */
+    template <typename TIT>
+    void add_column(size_t c, const int* idx, TIT x, size_t n) {
+        check_column(c);
+
+        auto& currows = rows[c];
+        auto& curvals = values[c];
+        currows.reserve(currows.size() + n);
+        curvals.reserve(curvals.size() + n);
+
+        for (size_t v = 0; v < n; ++v, ++x) {
+            const int r = idx[v];
+            check_row(r);
+            if (!currows.empty() && currows.back() >= r) {
+                sorted[c] = 0;
+            }
+            currows.push_back(r);
+            curvals.push_back(*x);
+        }
+        return;
+    }
+
+    /**
+     * Create a `*gCMatrix` from all non-zero entries that have been added.
+     * The buffers in the builder are released column-by-column, so this should only be called once.
+     *
+     * @return A `dgCMatrix` or `lgCMatrix` instance (depending on `V`).
+     * The `p` slot is double-precision if the number of non-zero entries is greater than the largest integer in R.
+     */
+    Rcpp::RObject build() {
+        for (size_t c = 0; c < nc; ++c) {
+            if (!sorted[c]) {
+                sort_column(c);
+            }
+        }
+
+        size_t nnzero = 0;
+        for (const auto& currows : rows) {
+            nnzero += currows.size();
+        }
+
+        auto mat = generate_gCMatrix<V>();
+        mat.slot("Dim") = Rcpp::IntegerVector::create(nr, nc);
+
+        Rcpp::IntegerVector i(nnzero);
+        V x(nnzero);
+        std::vector<size_t> p(nc + 1);
+
+        auto iIt = i.begin();
+        auto xIt = x.begin();
+        for (size_t c = 0; c < nc; ++c) {
+            auto& currows = rows[c];
+            auto& curvals = values[c];
+            iIt = std::copy(currows.begin(), currows.end(), iIt);
+            xIt = std::copy(curvals.begin(), curvals.end(), xIt);
+            p[c + 1] = p[c] + currows.size();
+
+            std::vector<int>().swap(currows);
+            std::vector<T>().swap(curvals);
+        }
+
+        mat.slot("p")=create_pointers(p);
+        mat.slot("i")=i;
+        mat.slot("x")=x;
+
+        return SEXP(mat);
+    }
+private:
+    int nr;
+    size_t nc;
+    std::vector<std::vector<int> > rows;
+    std::vector<std::vector<T> > values;
+    std::vector<unsigned char> sorted; // not std::vector<bool>, so that different columns can be modified concurrently.
+
+    void check_column(size_t c) const {
+        if (c >= nc) {
+            throw std::runtime_error("column index out of range");
+        }
+    }
+
+    void check_row(int r) const {
+        if (r < 0 || r >= nr) {
+            throw std::runtime_error("row index out of range");
+        }
+    }
+
+    void sort_column(size_t c) {
+        auto& currows = rows[c];
+        auto& curvals = values[c];
+        const size_t n = currows.size();
+
+        std::vector<size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) -> bool {
+            return currows[left] < currows[right];
+        });
+
+        // Keeping the last entry for each row, consistent with repeated assignment into a std::map.
+        std::vector<int> new_rows;
+        std::vector<T> new_vals;
+        new_rows.reserve(n);
+        new_vals.reserve(n);
+        for (auto o : order) {
+            if (!new_rows.empty() && new_rows.back() == currows[o]) {
+                new_vals.back() = curvals[o];
+            } else {
+                new_rows.push_back(currows[o]);
+                new_vals.push_back(curvals[o]);
+            }
+        }
+
+        currows.swap(new_rows);
+        curvals.swap(new_vals);
+        sorted[c] = 1;
+        return;
+    }
+};
+
+}
+
+#endif
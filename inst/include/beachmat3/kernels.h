@@ -0,0 +1,468 @@
+#ifndef BEACHMAT_KERNELS_H
+#define BEACHMAT_KERNELS_H
+
+/**
+ * @file kernels.h
+ *
+ * Internal kernels for the innermost copy and scatter loops of the various **beachmat** classes.
+ *
+ * Type-converting copies between `int` and `double`, and between `float` and `double`, are vectorized with AVX2 or SSE2 instructions on x86 processors,
+ * where the instruction set is chosen at runtime based on the capabilities of the CPU.
+ * Otherwise, we fall back to a scalar loop, which is also used if `BEACHMAT_NO_SIMD` is defined.
+ * In all cases, missing integers are converted to missing doubles and vice versa, consistent with R's own type conversions.
+ */
+
+#include "Rcpp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(BEACHMAT_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BEACHMAT_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace beachmat {
+
+/**
+ * Copy values from one array to another, possibly with type conversion.
+ * This falls back to `std::copy()` for all types that do not have a dedicated overload.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam IN Iterator to the input values.
+ * @tparam OUT Iterator to the output array.
+ *
+ * @param in Iterator to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Iterator to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+template <typename IN, typename OUT>
+inline void copy_n_values(IN in, size_t n, OUT out) {
+    std::copy(in, in + n, out);
+    return;
+}
+
+/**
+ * @cond
+ */
+inline void copy_int_to_double_scalar(const int* in, size_t n, double* out) {
+    for (size_t v = 0; v < n; ++v) {
+        out[v] = (in[v] == NA_INTEGER ? NA_REAL : static_cast<double>(in[v]));
+    }
+    return;
+}
+
+/* NaN and out-of-range values would be undefined behavior in a plain cast,
+ * so they are explicitly mapped to NA_INTEGER, matching the SIMD conversions.
+ */
+inline int convert_double_to_int(double x) {
+    if (std::isnan(x) || !(x > -2147483649.0 && x < 2147483648.0)) {
+        return NA_INTEGER;
+    }
+    return static_cast<int>(x);
+}
+
+inline void copy_double_to_int_scalar(const double* in, size_t n, int* out) {
+    for (size_t v = 0; v < n; ++v) {
+        out[v] = convert_double_to_int(in[v]);
+    }
+    return;
+}
+
+inline void copy_float_to_int_scalar(const float* in, size_t n, int* out) {
+    for (size_t v = 0; v < n; ++v) {
+        out[v] = convert_double_to_int(in[v]);
+    }
+    return;
+}
+/**
+ * @endcond
+ */
+
+#ifdef BEACHMAT_X86_SIMD
+
+/**
+ * @cond
+ */
+enum class simd_level { none, sse2, avx2 };
+
+inline simd_level detect_simd() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return simd_level::avx2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return simd_level::sse2;
+    }
+    return simd_level::none;
+}
+
+inline simd_level get_simd() {
+    static const simd_level level = detect_simd(); // thread-safe initialization in C++11.
+    return level;
+}
+
+/* NA_INTEGER lanes are identified by comparison and replaced with NA_REAL,
+ * as a plain conversion would yield -2147483648.
+ */
+__attribute__((target("avx2")))
+inline void copy_int_to_double_avx2(const int* in, size_t n, double* out) {
+    const __m128i na_int = _mm_set1_epi32(NA_INTEGER);
+    const __m256d na_dbl = _mm256_set1_pd(NA_REAL);
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + v));
+        __m256d is_na = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(_mm_cmpeq_epi32(src, na_int)));
+        _mm256_storeu_pd(out + v, _mm256_blendv_pd(_mm256_cvtepi32_pd(src), na_dbl, is_na));
+    }
+    copy_int_to_double_scalar(in + v, n - v, out + v);
+    return;
+}
+
+__attribute__((target("sse2")))
+inline void copy_int_to_double_sse2(const int* in, size_t n, double* out) {
+    const __m128i na_int = _mm_set1_epi32(NA_INTEGER);
+    const __m128d na_dbl = _mm_set1_pd(NA_REAL);
+    size_t v = 0;
+    for (; v + 2 <= n; v += 2) {
+        __m128i src = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + v));
+        __m128i is_na32 = _mm_cmpeq_epi32(src, na_int);
+        __m128d is_na = _mm_castsi128_pd(_mm_unpacklo_epi32(is_na32, is_na32));
+        __m128d converted = _mm_cvtepi32_pd(src);
+        _mm_storeu_pd(out + v, _mm_or_pd(_mm_and_pd(is_na, na_dbl), _mm_andnot_pd(is_na, converted)));
+    }
+    copy_int_to_double_scalar(in + v, n - v, out + v);
+    return;
+}
+
+/* Truncation of out-of-range and NaN values yields INT_MIN, i.e., NA_INTEGER,
+ * consistent with convert_double_to_int() for the scalar conversion.
+ */
+__attribute__((target("avx2")))
+inline void copy_double_to_int_avx2(const double* in, size_t n, int* out) {
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m256d src = _mm256_loadu_pd(in + v);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + v), _mm256_cvttpd_epi32(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = _mm_cvttsd_si32(_mm_set_sd(in[v]));
+    }
+    return;
+}
+
+__attribute__((target("sse2")))
+inline void copy_double_to_int_sse2(const double* in, size_t n, int* out) {
+    size_t v = 0;
+    for (; v + 2 <= n; v += 2) {
+        __m128d src = _mm_loadu_pd(in + v);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + v), _mm_cvttpd_epi32(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = _mm_cvttsd_si32(_mm_set_sd(in[v]));
+    }
+    return;
+}
+
+__attribute__((target("avx2")))
+inline void copy_double_to_float_avx2(const double* in, size_t n, float* out) {
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m256d src = _mm256_loadu_pd(in + v);
+        _mm_storeu_ps(out + v, _mm256_cvtpd_ps(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = in[v];
+    }
+    return;
+}
+
+__attribute__((target("sse2")))
+inline void copy_double_to_float_sse2(const double* in, size_t n, float* out) {
+    size_t v = 0;
+    for (; v + 2 <= n; v += 2) {
+        __m128d src = _mm_loadu_pd(in + v);
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + v), _mm_cvtpd_ps(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = in[v];
+    }
+    return;
+}
+
+__attribute__((target("avx2")))
+inline void copy_float_to_double_avx2(const float* in, size_t n, double* out) {
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128 src = _mm_loadu_ps(in + v);
+        _mm256_storeu_pd(out + v, _mm256_cvtps_pd(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = in[v];
+    }
+    return;
+}
+
+__attribute__((target("sse2")))
+inline void copy_float_to_double_sse2(const float* in, size_t n, double* out) {
+    size_t v = 0;
+    for (; v + 2 <= n; v += 2) {
+        __m128 src = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(in + v));
+        _mm_storeu_pd(out + v, _mm_cvtps_pd(src));
+    }
+    for (; v < n; ++v) {
+        out[v] = in[v];
+    }
+    return;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Copy integer values into an array of doubles, using SIMD instructions where available.
+ * Missing integers are converted to `NA_REAL`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param in Pointer to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Pointer to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+inline void copy_n_values(const int* in, size_t n, double* out) {
+    switch (get_simd()) {
+        case simd_level::avx2:
+            copy_int_to_double_avx2(in, n, out);
+            break;
+        case simd_level::sse2:
+            copy_int_to_double_sse2(in, n, out);
+            break;
+        default:
+            copy_int_to_double_scalar(in, n, out);
+    }
+    return;
+}
+
+/**
+ * Copy double-precision values into an array of integers with truncation, using SIMD instructions where available.
+ * Missing, non-finite and out-of-range values are converted to `NA_INTEGER`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param in Pointer to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Pointer to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+inline void copy_n_values(const double* in, size_t n, int* out) {
+    switch (get_simd()) {
+        case simd_level::avx2:
+            copy_double_to_int_avx2(in, n, out);
+            break;
+        case simd_level::sse2:
+            copy_double_to_int_sse2(in, n, out);
+            break;
+        default:
+            copy_double_to_int_scalar(in, n, out);
+    }
+    return;
+}
+
+/**
+ * Copy double-precision values into an array of single-precision values with rounding, using SIMD instructions where available.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param in Pointer to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Pointer to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+inline void copy_n_values(const double* in, size_t n, float* out) {
+    switch (get_simd()) {
+        case simd_level::avx2:
+            copy_double_to_float_avx2(in, n, out);
+            break;
+        case simd_level::sse2:
+            copy_double_to_float_sse2(in, n, out);
+            break;
+        default:
+            std::copy(in, in + n, out);
+    }
+    return;
+}
+
+/**
+ * Copy single-precision values into an array of doubles, using SIMD instructions where available.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param in Pointer to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Pointer to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+inline void copy_n_values(const float* in, size_t n, double* out) {
+    switch (get_simd()) {
+        case simd_level::avx2:
+            copy_float_to_double_avx2(in, n, out);
+            break;
+        case simd_level::sse2:
+            copy_float_to_double_sse2(in, n, out);
+            break;
+        default:
+            std::copy(in, in + n, out);
+    }
+    return;
+}
+
+#else
+
+/**
+ * @cond
+ */
+inline void copy_n_values(const int* in, size_t n, double* out) {
+    copy_int_to_double_scalar(in, n, out);
+    return;
+}
+
+inline void copy_n_values(const double* in, size_t n, int* out) {
+    copy_double_to_int_scalar(in, n, out);
+    return;
+}
+/**
+ * @endcond
+ */
+
+#endif
+
+/**
+ * Copy single-precision values into an array of integers with truncation.
+ * Missing, non-finite and out-of-range values are converted to `NA_INTEGER`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param in Pointer to the start of the input values.
+ * @param n Number of values to copy.
+ * @param out Pointer to the start of the output array.
+ * This should have at least `n` addressable elements.
+ *
+ * @return `out` is filled with the first `n` values of `in`.
+ */
+inline void copy_n_values(const float* in, size_t n, int* out) {
+    copy_float_to_int_scalar(in, n, out);
+    return;
+}
+
+/**
+ * @cond
+ */
+// Overloads for non-const pointers, which would otherwise be matched by the generic template.
+inline void copy_n_values(int* in, size_t n, double* out) {
+    copy_n_values(static_cast<const int*>(in), n, out);
+    return;
+}
+
+inline void copy_n_values(double* in, size_t n, int* out) {
+    copy_n_values(static_cast<const double*>(in), n, out);
+    return;
+}
+
+inline void copy_n_values(double* in, size_t n, float* out) {
+    copy_n_values(static_cast<const double*>(in), n, out);
+    return;
+}
+
+inline void copy_n_values(float* in, size_t n, double* out) {
+    copy_n_values(static_cast<const float*>(in), n, out);
+    return;
+}
+
+inline void copy_n_values(float* in, size_t n, int* out) {
+    copy_n_values(static_cast<const float*>(in), n, out);
+    return;
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @cond
+ */
+template <typename OUT, typename IN>
+inline OUT convert_value(IN x) {
+    return x;
+}
+
+template <>
+inline double convert_value<double, int>(int x) {
+    return (x == NA_INTEGER ? NA_REAL : static_cast<double>(x));
+}
+
+template <>
+inline int convert_value<int, double>(double x) {
+    return convert_double_to_int(x);
+}
+
+template <>
+inline int convert_value<int, float>(float x) {
+    return convert_double_to_int(x);
+}
+/**
+ * @endcond
+ */
+
+/**
+ * Scatter non-zero values into a dense array according to their indices.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam TIT Iterator to the non-zero values.
+ * @tparam ALT Iterator to the output array.
+ * @tparam I Integer type of the indices.
+ *
+ * @param x Iterator to the start of the non-zero values.
+ * @param idx Pointer to the start of the indices for the non-zero values.
+ * @param n Number of non-zero values.
+ * @param work Iterator to the start of the output array.
+ * @param offset Offset to subtract from each index to obtain a position on `work`.
+ *
+ * @return For each `v` in `[0, n)`, `x[v]` is stored in `work` at position `idx[v] - offset`.
+ */
+template <typename TIT, typename ALT, typename I>
+inline void scatter_values(TIT x, const I* idx, size_t n, ALT work, size_t offset) {
+    /* AVX2 has no scatter instruction, and the stores are random-access anyway;
+     * so we just unroll the loop to allow the loads and conversions to be overlapped.
+     */
+    typedef typename std::remove_reference<decltype(*work)>::type OUT;
+    size_t v = 0;
+    for (; v + 4 <= n; v += 4) {
+        const size_t i0 = idx[v] - offset, i1 = idx[v + 1] - offset, i2 = idx[v + 2] - offset, i3 = idx[v + 3] - offset;
+        *(work + i0) = convert_value<OUT>(*(x + v));
+        *(work + i1) = convert_value<OUT>(*(x + v + 1));
+        *(work + i2) = convert_value<OUT>(*(x + v + 2));
+        *(work + i3) = convert_value<OUT>(*(x + v + 3));
+    }
+    for (; v < n; ++v) {
+        *(work + (idx[v] - offset)) = convert_value<OUT>(*(x + v));
+    }
+    return;
+}
+
+}
+
+#endif
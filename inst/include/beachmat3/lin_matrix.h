@@ -10,10 +10,17 @@
 #include "Rcpp.h"
 #include "ordinary_reader.h"
 #include "Csparse_reader.h"
+#include "Csparse_file.h"
+#include "tiled_file.h"
+#include "delayed_ops.h"
 #include "utils.h"
 
 #include <memory>
 #include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <stdexcept>
 
 namespace beachmat {
 
@@ -61,7 +68,8 @@ public:
      * @param last The index of one-past-the-last column of interest.
      *
      * @return A pointer is returned to the values of `r` as integers, starting at the `first` element.
-     * This involves creating a copy in the workspace so the return value is always equal to `work`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
      */
     virtual const int* get_row(size_t r, int* work, size_t first, size_t last) = 0;
 
@@ -90,7 +98,8 @@ public:
      * @param last The index of one-past-the-last column of interest.
      *
      * @return A pointer is returned to the values of `r` as doubles, starting at the `first` element.
-     * This involves creating a copy in the workspace so the return value is always equal to `work`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
      */
     virtual const double* get_row(size_t r, double* work, size_t first, size_t last) = 0;
 
@@ -117,7 +126,8 @@ public:
      * This should have at least `last - first` addressable elements.
      *
      * @return A pointer is returned to the values of `r` as integers, starting at the first element.
-     * This involves creating a copy in the workspace so the return value is always equal to `work`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
      */
     const int* get_row(size_t r, int* work) {
         return get_row(r, work, 0, ncol);        
@@ -146,12 +156,159 @@ public:
      * This should have at least `last - first` addressable elements.
      *
      * @return A pointer is returned to the values of `r` as doubles, starting at the first element.
-     * This involves creating a copy in the workspace so the return value is always equal to `work`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
      */
     const double* get_row(size_t r, double* work) {
         return get_row(r, work, 0, ncol);        
     }
 
+    /**
+     * Extract values from a column as an array of floats, restricted to a contiguous subset of rows.
+     *
+     * @param c Index of the column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `last - first` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A pointer is returned to the values of `c` as floats, starting at the `first` element.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     *
+     * @details
+     * By default, values are extracted as doubles and narrowed into `work` with a vectorized conversion.
+     * Subclasses that store single-precision values can override this to avoid the conversion.
+     */
+    virtual const float* get_col(size_t c, float* work, size_t first, size_t last) {
+        dim_checker::check_subset(first, last, nrow, "row");
+        const size_t len = last - first;
+        const double* out = get_col(c, get_narrowing_buffer(len), first, last);
+        copy_n_values(out, len, work);
+        return work;
+    }
+
+    /**
+     * Extract values from a row as an array of floats, restricted to a contiguous subset of columns.
+     *
+     * @param r Index of the row of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `last - first` addressable elements.
+     * @param first The index of the first column of interest.
+     * @param last The index of one-past-the-last column of interest.
+     *
+     * @return A pointer is returned to the values of `r` as floats, starting at the `first` element.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    virtual const float* get_row(size_t r, float* work, size_t first, size_t last) {
+        dim_checker::check_subset(first, last, ncol, "column");
+        const size_t len = last - first;
+        const double* out = get_row(r, get_narrowing_buffer(len), first, last);
+        copy_n_values(out, len, work);
+        return work;
+    }
+
+    /**
+     * Extract values from a column as an array of floats.
+     *
+     * @param c Index of the column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `nrow` addressable elements.
+     *
+     * @return A pointer is returned to the values of `c` as floats, starting at the first element.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    const float* get_col(size_t c, float* work) {
+        return get_col(c, work, 0, nrow);
+    }
+
+    /**
+     * Extract values from a row as an array of floats.
+     *
+     * @param r Index of the row of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `ncol` addressable elements.
+     *
+     * @return A pointer is returned to the values of `r` as floats, starting at the first element.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    const float* get_row(size_t r, float* work) {
+        return get_row(r, work, 0, ncol);
+    }
+
+    /**
+     * Extract values from a contiguous block of columns as an array of integers, restricted to a contiguous subset of rows.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A pointer is returned to the values of the block as integers, stored in column-major format.
+     * Values for column `c` start at `(c - first_col) * (last - first)` and begin at row `first`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    virtual const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        return fill_cols(first_col, last_col, work, first, last);
+    }
+
+    /**
+     * Extract values from a contiguous block of columns as an array of doubles, restricted to a contiguous subset of rows.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A pointer is returned to the values of the block as doubles, stored in column-major format.
+     * Values for column `c` start at `(c - first_col) * (last - first)` and begin at row `first`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    virtual const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        return fill_cols(first_col, last_col, work, first, last);
+    }
+
+    /**
+     * Extract values from a contiguous block of columns as an array of integers.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     *
+     * @return A pointer is returned to the values of the block as integers, stored in column-major format.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    const int* get_cols(size_t first_col, size_t last_col, int* work) {
+        return get_cols(first_col, last_col, work, 0, nrow);
+    }
+
+    /**
+     * Extract values from a contiguous block of columns as an array of doubles.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work The workspace, potentially used to store extracted values.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     *
+     * @return A pointer is returned to the values of the block as doubles, stored in column-major format.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value compares equal to `work`.
+     */
+    const double* get_cols(size_t first_col, size_t last_col, double* work) {
+        return get_cols(first_col, last_col, work, 0, nrow);
+    }
+
     /**
      * Get the number of rows in the matrix.
      */
@@ -167,8 +324,32 @@ public:
      */
     virtual bool is_sparse() const { return false; }
 
+    /**
+     * Specify whether rows should be extracted via a row-major tile.
+     * If enabled, the first request for a row will transpose a tile of consecutive rows into an internal buffer,
+     * from which this and subsequent requests for rows in the same tile are served without strided access.
+     * When the requested type matches the storage type, `get_row()` will then return a pointer into the tile without any copy.
+     * Note that such a pointer is only valid until the next call to `get_row()`.
+     * This is most useful for row-wise iteration over tall dense matrices.
+     *
+     * @param use Whether to use row tiling.
+     * @param height Number of rows in each tile.
+     * If zero, this is automatically chosen to fit the tile into a typical L2 cache.
+     *
+     * @return Row tiling is enabled or disabled for this object.
+     * Subclasses that do not support row tiling will silently ignore this request.
+     */
+    virtual void set_row_tile(bool use, size_t height = 0) {}
+
+    /**
+     * @return Whether row tiling is enabled, see `set_row_tile()`.
+     */
+    virtual bool has_row_tile() const { return false; }
+
     /**
      * Clone the current object, returning a pointer to a copy.
+     * If the current object was created with `read_lin_block()` in detached mode,
+     * the cloning process does not involve the R API and can be safely performed in worker threads.
      */
     std::unique_ptr<lin_matrix> clone() const {
         return std::unique_ptr<lin_matrix>(this->clone_internal());
@@ -178,6 +359,37 @@ protected:
     size_t nrow=0, ncol=0;
 
     virtual lin_matrix* clone_internal() const = 0;
+
+    /**
+     * Get a double-precision buffer for the default implementations of the single-precision getters.
+     * This is resized as necessary and retained between calls.
+     */
+    double* get_narrowing_buffer(size_t n) {
+        if (narrowing_buffer.size() < n) {
+            narrowing_buffer.resize(n);
+        }
+        return narrowing_buffer.data();
+    }
+
+    /**
+     * Fallback for block extraction in subclasses that do not provide a specialized `get_cols()` method.
+     * This calls `get_col()` for each column and copies the results into `work`.
+     */
+    template <typename T>
+    const T* fill_cols(size_t first_col, size_t last_col, T* work, size_t first, size_t last) {
+        dim_checker::check_subset(first_col, last_col, ncol, "column");
+        const size_t len = last - first;
+        T* current = work;
+        for (size_t c = first_col; c < last_col; ++c, current += len) {
+            auto out = get_col(c, current, first, last);
+            if (out != current) {
+                std::copy(out, out + len, current);
+            }
+        }
+        return work;
+    }
+private:
+    std::vector<double> narrowing_buffer;
 };
 
 /**
@@ -199,6 +411,10 @@ public:
     lin_sparse_matrix(lin_sparse_matrix&&) = default;
     lin_sparse_matrix& operator=(lin_sparse_matrix&&) = default;
 
+    // Unhiding the dense extraction methods, which would otherwise be hidden by the sparse overloads below.
+    using lin_matrix::get_col;
+    using lin_matrix::get_row;
+
     /**
      * Extract all non-zero elements in a row, restricted to a contiguous subset of columns.
      * Values are returned as integers.
@@ -339,83 +555,443 @@ public:
         return get_row(r, work_x, work_i, 0, this->ncol);
     }
 
-    bool is_sparse() const { return true; }
-
     /**
-     * Get the number of non-zero elements in the matrix.
+     * Extract all non-zero elements in a column, restricted to a contiguous subset of rows.
+     * Values are returned as floats.
+     *
+     * @param c Index of the column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `last - first` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `last - first` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A `sparse_index` is returned containing pointers to non-zero elements in `c` with row indices in `[first, last)`.
+     * This may or may not involve populating `work` with values copied from the underlying matrix;
+     * a copy will have been performed iff the return value's pointers compare equal to `work_x` and `work_i`.
+     *
+     * @details
+     * By default, non-zero values are extracted as doubles and narrowed into `work_x` with a vectorized conversion,
+     * while the row indices may still point into the underlying matrix.
+     * Subclasses that store single-precision values can override this to avoid the conversion.
      */
-    virtual size_t get_nnzero() const = 0;
+    virtual sparse_index<const float*, int> get_col(size_t c, float* work_x, int* work_i, size_t first, size_t last) {
+        dim_checker::check_subset(first, last, nrow, "row");
+        auto out = get_col(c, get_narrowing_buffer(last - first), work_i, first, last);
+        copy_n_values(out.x, out.n, work_x);
+        return sparse_index<const float*, int>(out.n, work_x, out.i);
+    }
 
     /**
-     * Clone the current object, returning a pointer to a copy.
+     * Extract all non-zero elements in a row, restricted to a contiguous subset of columns.
+     * Values are returned as floats.
+     *
+     * @param r Index of the row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `last - first` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `last - first` addressable elements.
+     * @param first The index of the first column of interest.
+     * @param last The index of one-past-the-last column of interest.
+     *
+     * @return A `sparse_index` is returned containing pointers to the workspaces,
+     * containing non-zero elements in `r` with column indices in `[first, last)`.
+     * A copy of non-zero values and their indices is always performed into the workspaces.
      */
-    std::unique_ptr<lin_sparse_matrix> clone() const {
-        return std::unique_ptr<lin_sparse_matrix>(this->clone_internal());
+    virtual sparse_index<const float*, int> get_row(size_t r, float* work_x, int* work_i, size_t first, size_t last) {
+        dim_checker::check_subset(first, last, ncol, "column");
+        auto out = get_row(r, get_narrowing_buffer(last - first), work_i, first, last);
+        copy_n_values(out.x, out.n, work_x);
+        return sparse_index<const float*, int>(out.n, work_x, out.i);
     }
-protected:
-    lin_sparse_matrix* clone_internal() const = 0;
-};
 
-/**
- * @brief Logical, integer or numeric matrices in the "ordinary" R format, i.e., column-major dense arrays.
- *
- * It is unlikely that this class will be constructed directly by users;
- * most applications will use `read_lin_block()` instead.
- *
- * @tparam V The class of the `Rcpp::Vector` holding the R-level data.
- */
-template <class V>
-class lin_ordinary_matrix : public lin_matrix {
-public:
     /**
-     * Constructor from an ordinary R-level matrix.
+     * Extract all non-zero elements in a column, storing values as floats.
      *
-     * @param mat An ordinary R matrix.
+     * @param c Index of the column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `nrow` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `nrow` addressable elements.
+     *
+     * @return A `sparse_index` is returned containing pointers to all non-zero elements in `c`.
+     * See the overload with `first` and `last` for details on copying.
      */
-    lin_ordinary_matrix(Rcpp::RObject mat) : reader(mat) {
-        this->nrow = reader.get_nrow();
-        this->ncol = reader.get_ncol();
-        return;
+    sparse_index<const float*, int> get_col(size_t c, float* work_x, int* work_i) {
+        return get_col(c, work_x, work_i, 0, this->nrow);
     }
 
-    ~lin_ordinary_matrix() = default;
-    lin_ordinary_matrix(const lin_ordinary_matrix&) = default;
-    lin_ordinary_matrix& operator=(const lin_ordinary_matrix&) = default;
-    lin_ordinary_matrix(lin_ordinary_matrix&&) = default;
-    lin_ordinary_matrix& operator=(lin_ordinary_matrix&&) = default;
+    /**
+     * Extract all non-zero elements in a row, storing values as floats.
+     *
+     * @param r Index of the row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `ncol` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `ncol` addressable elements.
+     *
+     * @return A `sparse_index` is returned containing pointers to the workspaces,
+     * containing all non-zero elements in `r`.
+     */
+    sparse_index<const float*, int> get_row(size_t r, float* work_x, int* work_i) {
+        return get_row(r, work_x, work_i, 0, this->ncol);
+    }
 
-    const int* get_col(size_t c, int* work, size_t first, size_t last);
+    using lin_matrix::get_cols;
 
-    const int* get_row(size_t r, int* work, size_t first, size_t last) {
-        reader.get_row(r, work, first, last);       
-        return work;
+    /**
+     * Extract all non-zero elements in a contiguous block of columns, restricted to a contiguous subset of rows.
+     * Values are returned as integers.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_p The workspace for the column pointers.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A `sparse_block` is returned containing the non-zero elements in columns `[first_col, last_col)` with row indices in `[first, last)`.
+     * The column pointers are always stored in `work_p`.
+     * When all rows are requested and no type conversion is required, the values and indices point directly into the underlying matrix;
+     * otherwise, a copy will have been performed and the return value's pointers will compare equal to `work_x` and `work_i`.
+     */
+    virtual sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fill_cols(first_col, last_col, work_x, work_i, work_p, first, last);
     }
 
-    const double* get_col(size_t c, double* work, size_t first, size_t last);
+    /**
+     * Extract all non-zero elements in a contiguous block of columns, restricted to a contiguous subset of rows.
+     * Values are returned as doubles.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `(last - first) * (last_col - first_col)` addressable elements.
+     * @param work_p The workspace for the column pointers.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     * @param first The index of the first row of interest.
+     * @param last The index of one-past-the-last row of interest.
+     *
+     * @return A `sparse_block` is returned containing the non-zero elements in columns `[first_col, last_col)` with row indices in `[first, last)`.
+     * The column pointers are always stored in `work_p`.
+     * When all rows are requested and no type conversion is required, the values and indices point directly into the underlying matrix;
+     * otherwise, a copy will have been performed and the return value's pointers will compare equal to `work_x` and `work_i`.
+     */
+    virtual sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fill_cols(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
 
-    const double* get_row(size_t r, double* work, size_t first, size_t last) {
-        reader.get_row(r, work, first, last); 
-        return work;
+    /**
+     * Extract all non-zero elements in a contiguous block of columns, storing values as integers.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     * @param work_p The workspace for the column pointers.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     *
+     * @return A `sparse_block` is returned containing all non-zero elements in columns `[first_col, last_col)`.
+     * See the overload with `first` and `last` for details on copying.
+     */
+    sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p) {
+        return get_cols(first_col, last_col, work_x, work_i, work_p, 0, this->nrow);
     }
-private:
-    ordinary_reader<V> reader;
 
-    lin_ordinary_matrix<V>* clone_internal() const {
-        return new lin_ordinary_matrix<V>(*this);
+    /**
+     * Extract all non-zero elements in a contiguous block of columns, storing values as doubles.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     * @param work_i The workspace for row indices.
+     * This should have at least `nrow * (last_col - first_col)` addressable elements.
+     * @param work_p The workspace for the column pointers.
+     * This should have at least `last_col - first_col + 1` addressable elements.
+     *
+     * @return A `sparse_block` is returned containing all non-zero elements in columns `[first_col, last_col)`.
+     * See the overload with `first` and `last` for details on copying.
+     */
+    sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p) {
+        return get_cols(first_col, last_col, work_x, work_i, work_p, 0, this->nrow);
     }
-};
 
-using integer_ordinary_matrix = lin_ordinary_matrix<Rcpp::IntegerVector>;
+    /**
+     * Extract all non-zero elements in a contiguous block of rows, restricted to a contiguous subset of columns.
+     * Values are returned as integers.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_p The workspace for the row pointers.
+     * This should have at least `last_row - first_row + 1` addressable elements.
+     * @param first The index of the first column of interest.
+     * @param last The index of one-past-the-last column of interest.
+     *
+     * @return A `sparse_row_block` is returned containing the non-zero elements in rows `[first_row, last_row)` with column indices in `[first, last)`,
+     * in the compressed sparse row format.
+     * The values, column indices and row pointers are always stored in `work_x`, `work_i` and `work_p`, respectively.
+     *
+     * @details
+     * For CSC-based subclasses, this is achieved in a single sweep over the columns,
+     * which is much more efficient than calling `get_row()` on each row in turn.
+     * The workspace requirements can be reduced by using `get_nnzero()` as an upper bound on the number of non-zero elements.
+     */
+    virtual sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fill_rows(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
 
-template <>
-inline const int* integer_ordinary_matrix::get_col(size_t c, int* work, size_t first, size_t last) {
-    return reader.get_col(c, first, last);
-}
+    /**
+     * Extract all non-zero elements in a contiguous block of rows, restricted to a contiguous subset of columns.
+     * Values are returned as doubles.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `(last - first) * (last_row - first_row)` addressable elements.
+     * @param work_p The workspace for the row pointers.
+     * This should have at least `last_row - first_row + 1` addressable elements.
+     * @param first The index of the first column of interest.
+     * @param last The index of one-past-the-last column of interest.
+     *
+     * @return A `sparse_row_block` is returned containing the non-zero elements in rows `[first_row, last_row)` with column indices in `[first, last)`,
+     * in the compressed sparse row format.
+     * See the integer overload for details.
+     */
+    virtual sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fill_rows(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    /**
+     * Extract all non-zero elements in a contiguous block of rows, storing values as integers.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `ncol * (last_row - first_row)` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `ncol * (last_row - first_row)` addressable elements.
+     * @param work_p The workspace for the row pointers.
+     * This should have at least `last_row - first_row + 1` addressable elements.
+     *
+     * @return A `sparse_row_block` is returned containing all non-zero elements in rows `[first_row, last_row)`.
+     */
+    sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p) {
+        return get_rows(first_row, last_row, work_x, work_i, work_p, 0, this->ncol);
+    }
+
+    /**
+     * Extract all non-zero elements in a contiguous block of rows, storing values as doubles.
+     *
+     * @param first_row Index of the first row of interest.
+     * @param last_row Index of one-past-the-last row of interest.
+     * @param work_x The workspace for extracted non-zero values.
+     * This should have at least `ncol * (last_row - first_row)` addressable elements.
+     * @param work_i The workspace for column indices.
+     * This should have at least `ncol * (last_row - first_row)` addressable elements.
+     * @param work_p The workspace for the row pointers.
+     * This should have at least `last_row - first_row + 1` addressable elements.
+     *
+     * @return A `sparse_row_block` is returned containing all non-zero elements in rows `[first_row, last_row)`.
+     */
+    sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p) {
+        return get_rows(first_row, last_row, work_x, work_i, work_p, 0, this->ncol);
+    }
+
+    bool is_sparse() const { return true; }
+
+    /**
+     * Get the number of non-zero elements in the matrix.
+     */
+    virtual size_t get_nnzero() const = 0;
+
+    /**
+     * Specify whether a row index should be used to accelerate random row access.
+     * If enabled, the index is lazily constructed upon the first request for a row that is not adjacent to the previously requested row.
+     * Subsequent row requests are then satisfied in time proportional to the number of non-zero elements in each row,
+     * rather than requiring a search through every column.
+     * This is most useful when rows are requested in arbitrary order.
+     *
+     * @param use Whether to use a row index.
+     * @param limit Maximum memory usage of the row index in bytes, defaulting to `default_row_index_limit`.
+     * If the index would exceed this limit, it is not constructed and row access falls back to the usual column-wise search.
+     *
+     * @return The row index is enabled or disabled for this object.
+     * Subclasses that do not support row indices will silently ignore this request.
+     */
+    virtual void set_row_index(bool use, size_t limit = default_row_index_limit) {}
+
+    /**
+     * @return Whether a row index has been constructed, see `set_row_index()`.
+     */
+    virtual bool has_row_index() const { return false; }
+
+    /**
+     * Clone the current object, returning a pointer to a copy.
+     * If the current object was created with `read_lin_sparse_block()` in detached mode,
+     * the cloning process does not involve the R API and can be safely performed in worker threads.
+     */
+    std::unique_ptr<lin_sparse_matrix> clone() const {
+        return std::unique_ptr<lin_sparse_matrix>(this->clone_internal());
+    }
+protected:
+    lin_sparse_matrix* clone_internal() const = 0;
+
+    using lin_matrix::fill_cols;
+
+    /**
+     * Fallback for sparse block extraction in subclasses that do not provide a specialized `get_cols()` method.
+     * This calls `get_col()` for each column and copies the results into the workspaces.
+     */
+    template <typename T>
+    sparse_block<const T*, int> fill_cols(size_t first_col, size_t last_col, T* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        dim_checker::check_subset(first_col, last_col, ncol, "column");
+        size_t counter = 0;
+        work_p[0] = 0;
+        for (size_t c = first_col; c < last_col; ++c) {
+            auto out = get_col(c, work_x + counter, work_i + counter, first, last);
+            if (out.x != work_x + counter) {
+                std::copy(out.x, out.x + out.n, work_x + counter);
+            }
+            if (out.i != work_i + counter) {
+                std::copy(out.i, out.i + out.n, work_i + counter);
+            }
+            counter += out.n;
+            work_p[c - first_col + 1] = counter;
+        }
+        return sparse_block<const T*, int>(last_col - first_col, work_x, work_i, work_p);
+    }
+
+    /**
+     * Fallback for sparse row block extraction in subclasses that do not provide a specialized `get_rows()` method.
+     * This calls `get_row()` for each row and copies the results into the workspaces.
+     */
+    template <typename T>
+    sparse_row_block<const T*, int> fill_rows(size_t first_row, size_t last_row, T* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        dim_checker::check_subset(first_row, last_row, nrow, "row");
+        size_t counter = 0;
+        work_p[0] = 0;
+        for (size_t r = first_row; r < last_row; ++r) {
+            auto out = get_row(r, work_x + counter, work_i + counter, first, last);
+            if (out.x != work_x + counter) {
+                std::copy(out.x, out.x + out.n, work_x + counter);
+            }
+            if (out.i != work_i + counter) {
+                std::copy(out.i, out.i + out.n, work_i + counter);
+            }
+            counter += out.n;
+            work_p[r - first_row + 1] = counter;
+        }
+        return sparse_row_block<const T*, int>(last_row - first_row, work_x, work_i, work_p);
+    }
+};
+
+/**
+ * @brief Logical, integer or numeric matrices in the "ordinary" R format, i.e., column-major dense arrays.
+ *
+ * It is unlikely that this class will be constructed directly by users;
+ * most applications will use `read_lin_block()` instead.
+ *
+ * @tparam V The class of the `Rcpp::Vector` holding the R-level data.
+ */
+template <class V>
+class lin_ordinary_matrix final : public lin_matrix {
+public:
+    /**
+     * Constructor from an ordinary R-level matrix.
+     *
+     * @param mat An ordinary R matrix.
+     * @param detached Whether to detach the object from `mat`, see `read_lin_block()` for details.
+     */
+    lin_ordinary_matrix(Rcpp::RObject mat, bool detached = false) : reader(mat, detached) {
+        this->nrow = reader.get_nrow();
+        this->ncol = reader.get_ncol();
+        return;
+    }
+
+    ~lin_ordinary_matrix() = default;
+    lin_ordinary_matrix(const lin_ordinary_matrix&) = default;
+    lin_ordinary_matrix& operator=(const lin_ordinary_matrix&) = default;
+    lin_ordinary_matrix(lin_ordinary_matrix&&) = default;
+    lin_ordinary_matrix& operator=(lin_ordinary_matrix&&) = default;
+
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_matrix::get_col;
+    using lin_matrix::get_row;
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last);
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return reader.get_row_direct(r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last);
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return reader.get_row_direct(r, work, first, last);
+    }
+
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last);
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last);
+
+    void set_row_tile(bool use, size_t height = 0) {
+        reader.set_row_tile(use, height);
+        return;
+    }
+
+    bool has_row_tile() const {
+        return reader.has_row_tile();
+    }
+private:
+    ordinary_reader<V> reader;
+
+    lin_ordinary_matrix<V>* clone_internal() const {
+        return new lin_ordinary_matrix<V>(*this);
+    }
+};
+
+using integer_ordinary_matrix = lin_ordinary_matrix<Rcpp::IntegerVector>;
+
+template <>
+inline const int* integer_ordinary_matrix::get_col(size_t c, int* work, size_t first, size_t last) {
+    return reader.get_col(c, first, last);
+}
 
 template <>
 inline const double* integer_ordinary_matrix::get_col(size_t c, double* work, size_t first, size_t last) {
     auto out = reader.get_col(c, first, last);
-    std::copy(out, out + last - first, work);
+    copy_n_values(out, last - first, work);
+    return work;
+}
+
+template <>
+inline const int* integer_ordinary_matrix::get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col);
+    }
+    reader.get_cols(first_col, last_col, work, first, last);
+    return work;
+}
+
+template <>
+inline const double* integer_ordinary_matrix::get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+    reader.get_cols(first_col, last_col, work, first, last);
     return work;
 }
 
@@ -429,7 +1005,22 @@ inline const int* logical_ordinary_matrix::get_col(size_t c, int* work, size_t f
 template <>
 inline const double* logical_ordinary_matrix::get_col(size_t c, double* work, size_t first, size_t last) {
     auto out = reader.get_col(c, first, last);
-    std::copy(out, out + last - first, work);
+    copy_n_values(out, last - first, work);
+    return work;
+}
+
+template <>
+inline const int* logical_ordinary_matrix::get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col);
+    }
+    reader.get_cols(first_col, last_col, work, first, last);
+    return work;
+}
+
+template <>
+inline const double* logical_ordinary_matrix::get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+    reader.get_cols(first_col, last_col, work, first, last);
     return work;
 }
 
@@ -438,7 +1029,7 @@ using double_ordinary_matrix = lin_ordinary_matrix<Rcpp::NumericVector>;
 template <>
 inline const int* double_ordinary_matrix::get_col(size_t c, int* work, size_t first, size_t last) {
     auto out = reader.get_col(c, first, last);
-    std::copy(out, out + last - first, work);
+    copy_n_values(out, last - first, work);
     return work;
 }
 
@@ -447,6 +1038,21 @@ inline const double* double_ordinary_matrix::get_col(size_t c, double* work, siz
     return reader.get_col(c, first, last);
 }
 
+template <>
+inline const double* double_ordinary_matrix::get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col);
+    }
+    reader.get_cols(first_col, last_col, work, first, last);
+    return work;
+}
+
+template <>
+inline const int* double_ordinary_matrix::get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+    reader.get_cols(first_col, last_col, work, first, last);
+    return work;
+}
+
 /**
  * @brief Sparse logical or numeric matrices in the `lgCMatrix` or `dgCMatrix` format, respectively, from the **Matrix** package.
  *
@@ -456,14 +1062,15 @@ inline const double* double_ordinary_matrix::get_col(size_t c, double* work, siz
  * @tparam V The class of the `Rcpp::Vector` holding the R-level data for non-zero values.
  */
 template <class V, typename TIT>
-class gCMatrix : public lin_sparse_matrix {
+class gCMatrix final : public lin_sparse_matrix {
 public:
     /**
      * Constructor from a `*gCMatrix`.
      *
      * @param mat A S4 object of the `dgCMatrix` or `lgCMatrix` class.
+     * @param detached Whether to detach the object from `mat`, see `read_lin_block()` for details.
      */
-    gCMatrix(Rcpp::RObject mat) : reader(mat) {
+    gCMatrix(Rcpp::RObject mat, bool detached = false) : reader(mat, detached) {
         this->nrow = reader.get_nrow();
         this->ncol = reader.get_ncol();
         return;
@@ -475,6 +1082,10 @@ public:
     gCMatrix(gCMatrix&&) = default;
     gCMatrix& operator=(gCMatrix&&) = default;
 
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_sparse_matrix::get_col;
+    using lin_sparse_matrix::get_row;
+
     const int* get_col(size_t c, int* work, size_t first, size_t last) {
         reader.get_col(c, work, first, last);
         return work;        
@@ -507,9 +1118,40 @@ public:
         return reader.template get_row<const double*>(r, work_x, work_i, first, last);
     }
 
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last);
+
+    sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last);
+
+    sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const int*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const double*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
     size_t get_nnzero () const {
         return reader.get_nnzero();
     }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        reader.set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return reader.has_row_index();
+    }
 private:
     gCMatrix_reader<V, TIT> reader;
 
@@ -530,6 +1172,19 @@ inline sparse_index<const double*, int> lgCMatrix::get_col(size_t c, double* wor
     return transplant<const double*>(reader.get_col(c, first, last), work_x, work_i);
 }
 
+template <>
+inline sparse_block<const int*, int> lgCMatrix::get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col, work_p);
+    }
+    return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
+template <>
+inline sparse_block<const double*, int> lgCMatrix::get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
 using dgCMatrix = gCMatrix<Rcpp::NumericVector, const double*>;
 
 template <>
@@ -542,6 +1197,19 @@ inline sparse_index<const double*, int> dgCMatrix::get_col(size_t c, double* wor
     return reader.get_col(c, first, last);
 }
 
+template <>
+inline sparse_block<const double*, int> dgCMatrix::get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col, work_p);
+    }
+    return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
+template <>
+inline sparse_block<const int*, int> dgCMatrix::get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
 /**
  * @brief Sparse integer, logical or numeric matrices in the `SparseArraySeed` format from the **DelayedArray** package.
  *
@@ -551,14 +1219,15 @@ inline sparse_index<const double*, int> dgCMatrix::get_col(size_t c, double* wor
  * @tparam V The class of the `Rcpp::Vector` holding the R-level data for non-zero values.
  */
 template <class V, typename TIT>
-class lin_SparseArraySeed : public lin_sparse_matrix {
+class lin_SparseArraySeed final : public lin_sparse_matrix {
 public:
     /**
      * Constructor from a `SparseArraySeed`.
      *
      * @param mat A S4 object of the `SparseArraySeed` class.
+     * @param detached Whether to detach the object from `mat`, see `read_lin_block()` for details.
      */
-    lin_SparseArraySeed(Rcpp::RObject mat) : reader(mat) {
+    lin_SparseArraySeed(Rcpp::RObject mat, bool detached = false) : reader(mat, detached) {
         this->nrow = reader.get_nrow();
         this->ncol = reader.get_ncol();
         return;
@@ -570,8 +1239,13 @@ public:
     lin_SparseArraySeed(lin_SparseArraySeed&&) = default;
     lin_SparseArraySeed& operator=(lin_SparseArraySeed&&) = default;
 
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_sparse_matrix::get_col;
+    using lin_sparse_matrix::get_row;
+
     const int* get_col(size_t c, int* work, size_t first, size_t last) {
-        reader.get_col(c, work, first, last);
+        // Explicit template argument to avoid the non-template sparse overload that fills 'work' with row indices.
+        reader.template get_col<int*>(c, work, first, last);
         return work;        
     }
 
@@ -602,9 +1276,40 @@ public:
         return reader.template get_row<const double*>(r, work_x, work_i, first, last);
     }
 
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last);
+
+    sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last);
+
+    sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const int*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const double*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
     size_t get_nnzero () const {
         return reader.get_nnzero();
     }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        reader.set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return reader.has_row_index();
+    }
 private:
     SparseArraySeed_reader<V, TIT> reader;
 
@@ -617,41 +1322,1202 @@ using integer_SparseArraySeed = lin_SparseArraySeed<Rcpp::IntegerVector, const i
 
 template <>
 inline sparse_index<const int*, int> integer_SparseArraySeed::get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
-    return reader.get_col(c, first, last);
+    return reader.get_col(c, work_i, first, last);
 }
 
 template <>
 inline sparse_index<const double*, int> integer_SparseArraySeed::get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last)
 {
-    return transplant<const double*>(reader.get_col(c, first, last), work_x, work_i);
+    return transplant<const double*>(reader.get_col(c, work_i, first, last), work_x, work_i);
+}
+
+template <>
+inline sparse_block<const int*, int> integer_SparseArraySeed::get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col, work_i, work_p);
+    }
+    return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
+template <>
+inline sparse_block<const double*, int> integer_SparseArraySeed::get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
 }
 
 using logical_SparseArraySeed = lin_SparseArraySeed<Rcpp::LogicalVector, const int*>;
 
 template <>
 inline sparse_index<const int*, int> logical_SparseArraySeed::get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
-    return reader.get_col(c, first, last);
+    return reader.get_col(c, work_i, first, last);
 }
 
 template <>
 inline sparse_index<const double*, int> logical_SparseArraySeed::get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last)
 {
-    return transplant<const double*>(reader.get_col(c, first, last), work_x, work_i);
+    return transplant<const double*>(reader.get_col(c, work_i, first, last), work_x, work_i);
+}
+
+template <>
+inline sparse_block<const int*, int> logical_SparseArraySeed::get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col, work_i, work_p);
+    }
+    return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
+template <>
+inline sparse_block<const double*, int> logical_SparseArraySeed::get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
 }
 
 using double_SparseArraySeed = lin_SparseArraySeed<Rcpp::NumericVector, const double*>;
 
 template <>
 inline sparse_index<const int*, int> double_SparseArraySeed::get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
-    return transplant<const int*>(reader.get_col(c, first, last), work_x, work_i);
+    return transplant<const int*>(reader.get_col(c, work_i, first, last), work_x, work_i);
 }
 
 template <>
 inline sparse_index<const double*, int> double_SparseArraySeed::get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last)
 {
-    return reader.get_col(c, first, last);
+    return reader.get_col(c, work_i, first, last);
+}
+
+
+template <>
+inline sparse_block<const double*, int> double_SparseArraySeed::get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    if (first == 0 && last == this->nrow) {
+        return reader.get_cols(first_col, last_col, work_i, work_p);
+    }
+    return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
+}
+
+template <>
+inline sparse_block<const int*, int> double_SparseArraySeed::get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+    return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
 }
 
+
+/**
+ * @brief Sparse logical, integer or numeric matrices stored in a memory-mapped CSC file.
+ *
+ * See `Csparse_file_format.h` for a description of the file format.
+ * Non-zero values and row indices are returned directly from the mapping, without any copying or loading of the file into memory.
+ * It is unlikely that this class will be constructed directly by users;
+ * rather, it is typically constructed via `read_lin_block()` from a `CsparseFile` object in R.
+ *
+ * @tparam V The class of the `Rcpp::Vector` corresponding to the type of the non-zero values in the file.
+ * @tparam TIT The type of the (`const`) random-access iterator pointing to the data values.
+ */
+template <class V, typename TIT>
+class lin_Csparse_file final : public lin_sparse_matrix {
+private:
+    typedef typename V::stored_type T;
+public:
+    /**
+     * Constructor from a path to a CSC file.
+     *
+     * @param path Path to the file.
+     * @param check Whether to check the row indices of all non-zero elements, see `Csparse_file_reader` for details.
+     */
+    lin_Csparse_file(const std::string& path, bool check = false) : reader(path, check) {
+        this->nrow = reader.get_nrow();
+        this->ncol = reader.get_ncol();
+        return;
+    }
+
+    /**
+     * Constructor from a `CsparseFile`.
+     *
+     * @param mat A S4 object of the `CsparseFile` class.
+     * @param detached Ignored, as the object never holds references to R-owned memory.
+     * Cloning, using and destroying this object never involves the R API.
+     */
+    lin_Csparse_file(Rcpp::RObject mat, bool detached = false) : lin_Csparse_file(make_to_string(mat.slot("path"))) {}
+
+    ~lin_Csparse_file() = default;
+    lin_Csparse_file(const lin_Csparse_file&) = default;
+    lin_Csparse_file& operator=(const lin_Csparse_file&) = default;
+    lin_Csparse_file(lin_Csparse_file&&) = default;
+    lin_Csparse_file& operator=(lin_Csparse_file&&) = default;
+
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_sparse_matrix::get_col;
+    using lin_sparse_matrix::get_row;
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        reader.get_col(c, work, first, last);
+        return work;        
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        reader.get_row(r, work, first, last);       
+        return work;
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        reader.get_col(c, work, first, last);
+        return work;
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        reader.get_row(r, work, first, last); 
+        return work;
+    }
+
+    sparse_index<const int*, int> get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last, std::is_same<T, int>());
+    }
+
+    sparse_index<const int*, int> get_row(size_t r, int* work_x, int* work_i, size_t first, size_t last) {
+        return reader.template get_row<const int*>(r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last, std::is_same<T, double>());
+    }
+
+    sparse_index<const double*, int> get_row(size_t r, double* work_x, int* work_i, size_t first, size_t last) {
+        return reader.template get_row<const double*>(r, work_x, work_i, first, last);
+    }
+
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        reader.get_cols(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fetch_cols(first_col, last_col, work_x, work_i, work_p, first, last, std::is_same<T, int>());
+    }
+
+    sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return fetch_cols(first_col, last_col, work_x, work_i, work_p, first, last, std::is_same<T, double>());
+    }
+
+    sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const int*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const double*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    size_t get_nnzero () const {
+        return reader.get_nnzero();
+    }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        reader.set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return reader.has_row_index();
+    }
+private:
+    Csparse_file_reader<V, TIT> reader;
+
+    lin_Csparse_file<V, TIT>* clone_internal() const {
+        return new lin_Csparse_file<V, TIT>(*this);
+    }
+
+    // Pointing directly into the mapping when no type conversion is required.
+    template <typename X>
+    sparse_index<const X*, int> fetch_col(size_t c, X* work_x, int* work_i, size_t first, size_t last, std::true_type) {
+        return reader.get_col(c, first, last);
+    }
+
+    template <typename X>
+    sparse_index<const X*, int> fetch_col(size_t c, X* work_x, int* work_i, size_t first, size_t last, std::false_type) {
+        return transplant<const X*>(reader.get_col(c, first, last), work_x, work_i);
+    }
+
+    template <typename X>
+    sparse_block<const X*, int> fetch_cols(size_t first_col, size_t last_col, X* work_x, int* work_i, size_t* work_p, size_t first, size_t last, std::true_type) {
+        if (first == 0 && last == this->nrow) {
+            return reader.get_cols(first_col, last_col, work_p);
+        }
+        return reader.template get_cols<const X*>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    template <typename X>
+    sparse_block<const X*, int> fetch_cols(size_t first_col, size_t last_col, X* work_x, int* work_i, size_t* work_p, size_t first, size_t last, std::false_type) {
+        return reader.template get_cols<const X*>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+};
+
+using logical_Csparse_file = lin_Csparse_file<Rcpp::LogicalVector, const int*>;
+
+using integer_Csparse_file = lin_Csparse_file<Rcpp::IntegerVector, const int*>;
+
+using double_Csparse_file = lin_Csparse_file<Rcpp::NumericVector, const double*>;
+
+/**
+ * @brief Sparse matrices with single-precision values, stored in memory in the compressed sparse column format.
+ *
+ * This is constructed from another `lin_sparse_matrix`, whose non-zero values are narrowed to single precision.
+ * Compared to double-precision storage, this halves the memory footprint and bandwidth required for the non-zero values,
+ * at the cost of precision; it is intended for applications that only require single-precision accuracy anyway.
+ * Extraction of floats will return pointers directly into the stored arrays without any copying.
+ *
+ * The object does not hold any references to R-owned memory and its non-zero elements are shared between clones.
+ * Cloning, using and destroying this object never involves the R API.
+ * Most applications will use `read_lin_sparse_block_float()` to construct instances of this class.
+ */
+class lin_float_sparse_matrix final : public lin_sparse_matrix {
+public:
+    /**
+     * Constructor from another sparse matrix.
+     *
+     * @param source A `lin_sparse_matrix` from which to extract the non-zero elements.
+     * Integer and logical values are converted to floats via double precision, so missing values are stored as NaNs.
+     * These are converted back to `NA_INTEGER` upon extraction into integers, but become (non-`NA`) NaNs upon extraction into doubles,
+     * as the payload of `NA_REAL` does not survive narrowing to single precision.
+     */
+    lin_float_sparse_matrix(lin_sparse_matrix& source) : reader(create_reader(source)) {
+        this->nrow = reader.get_nrow();
+        this->ncol = reader.get_ncol();
+        return;
+    }
+
+    ~lin_float_sparse_matrix() = default;
+    lin_float_sparse_matrix(const lin_float_sparse_matrix&) = default;
+    lin_float_sparse_matrix& operator=(const lin_float_sparse_matrix&) = default;
+    lin_float_sparse_matrix(lin_float_sparse_matrix&&) = default;
+    lin_float_sparse_matrix& operator=(lin_float_sparse_matrix&&) = default;
+
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_sparse_matrix::get_col;
+    using lin_sparse_matrix::get_row;
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        return reader.get_col(c, work, first, last);
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return reader.get_row(r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        return reader.get_col(c, work, first, last);
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return reader.get_row(r, work, first, last);
+    }
+
+    const float* get_col(size_t c, float* work, size_t first, size_t last) {
+        return reader.get_col(c, work, first, last);
+    }
+
+    const float* get_row(size_t r, float* work, size_t first, size_t last) {
+        return reader.get_row(r, work, first, last);
+    }
+
+    sparse_index<const int*, int> get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
+        return transplant<const int*>(reader.get_col(c, first, last), work_x, work_i);
+    }
+
+    sparse_index<const int*, int> get_row(size_t r, int* work_x, int* work_i, size_t first, size_t last) {
+        return reader.template get_row<const int*>(r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last) {
+        return transplant<const double*>(reader.get_col(c, first, last), work_x, work_i);
+    }
+
+    sparse_index<const double*, int> get_row(size_t r, double* work_x, int* work_i, size_t first, size_t last) {
+        return reader.template get_row<const double*>(r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const float*, int> get_col(size_t c, float* work_x, int* work_i, size_t first, size_t last) {
+        return reader.get_col(c, first, last);
+    }
+
+    sparse_index<const float*, int> get_row(size_t r, float* work_x, int* work_i, size_t first, size_t last) {
+        return reader.template get_row<const float*>(r, work_x, work_i, first, last);
+    }
+
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        return reader.get_cols(first_col, last_col, work, first, last);
+    }
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        return reader.get_cols(first_col, last_col, work, first, last);
+    }
+
+    sparse_block<const int*, int> get_cols(size_t first_col, size_t last_col, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_cols<const int*>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_block<const double*, int> get_cols(size_t first_col, size_t last_col, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_cols<const double*>(first_col, last_col, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_row_block<const int*, int> get_rows(size_t first_row, size_t last_row, int* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const int*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    sparse_row_block<const double*, int> get_rows(size_t first_row, size_t last_row, double* work_x, int* work_i, size_t* work_p, size_t first, size_t last) {
+        return reader.template get_rows<const double*>(first_row, last_row, work_x, work_i, work_p, first, last);
+    }
+
+    size_t get_nnzero () const {
+        return reader.get_nnzero();
+    }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        reader.set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return reader.has_row_index();
+    }
+private:
+    float_Csparse_reader reader;
+
+    lin_float_sparse_matrix* clone_internal() const {
+        return new lin_float_sparse_matrix(*this);
+    }
+
+    static float_Csparse_reader create_reader(lin_sparse_matrix& source) {
+        const size_t NR = source.get_nrow(), NC = source.get_ncol();
+        std::vector<float> x;
+        std::vector<int> i;
+        std::vector<size_t> p(NC + 1);
+        x.reserve(source.get_nnzero());
+        i.reserve(source.get_nnzero());
+
+        std::vector<float> work_x(NR);
+        std::vector<int> work_i(NR);
+        for (size_t c = 0; c < NC; ++c) {
+            auto out = source.get_col(c, work_x.data(), work_i.data());
+            x.insert(x.end(), out.x, out.x + out.n);
+            i.insert(i.end(), out.i, out.i + out.n);
+            p[c + 1] = x.size();
+        }
+
+        return float_Csparse_reader(NR, NC, std::move(x), std::move(i), std::move(p));
+    }
+};
+
+/**
+ * @brief Logical, integer or numeric matrices stored in a tile-compressed file.
+ *
+ * See `tiled_file.h` for a description of the file format.
+ * Only the tiles overlapping each requested row or column are decompressed, and decompressed tiles are held in an LRU cache,
+ * so that both row- and column-wise iteration are efficient without loading the entire matrix into memory.
+ * It is unlikely that this class will be constructed directly by users;
+ * rather, it is typically constructed via `read_lin_block()` from a `TiledFile` object in R.
+ *
+ * @tparam V The class of the `Rcpp::Vector` corresponding to the type of the values in the file.
+ */
+template <class V>
+class lin_tiled_file final : public lin_matrix {
+public:
+    /**
+     * Constructor from a path to a tiled file.
+     *
+     * @param path Path to the file.
+     * @param cache_size Maximum size of the cache of decompressed tiles in bytes, see `tiled_file_reader` for details.
+     */
+    lin_tiled_file(const std::string& path, size_t cache_size = 0) : reader(path, cache_size) {
+        this->nrow = reader.get_nrow();
+        this->ncol = reader.get_ncol();
+        return;
+    }
+
+    /**
+     * Constructor from a `TiledFile`.
+     *
+     * @param mat A S4 object of the `TiledFile` class.
+     * @param detached Ignored, as the object never holds references to R-owned memory.
+     * Cloning, using and destroying this object never involves the R API.
+     */
+    lin_tiled_file(Rcpp::RObject mat, bool detached = false) : lin_tiled_file(make_to_string(mat.slot("path"))) {}
+
+    ~lin_tiled_file() = default;
+    lin_tiled_file(const lin_tiled_file&) = default;
+    lin_tiled_file& operator=(const lin_tiled_file&) = default;
+    lin_tiled_file(lin_tiled_file&&) = default;
+    lin_tiled_file& operator=(lin_tiled_file&&) = default;
+
+    // Unhiding the convenience and float overloads in the base class.
+    using lin_matrix::get_col;
+    using lin_matrix::get_row;
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        return reader.get_col(c, work, first, last);
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return reader.get_row(r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        return reader.get_col(c, work, first, last);
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return reader.get_row(r, work, first, last);
+    }
+
+    const int* get_cols(size_t first_col, size_t last_col, int* work, size_t first, size_t last) {
+        return reader.get_cols(first_col, last_col, work, first, last);
+    }
+
+    const double* get_cols(size_t first_col, size_t last_col, double* work, size_t first, size_t last) {
+        return reader.get_cols(first_col, last_col, work, first, last);
+    }
+
+    /**
+     * Set the maximum size of the cache of decompressed tiles.
+     * The cache should be large enough to hold one strip of tiles across the requested rows or columns,
+     * otherwise tiles will be decompressed repeatedly during iteration.
+     *
+     * @param cache_size Maximum size of the cache, in bytes.
+     * This only affects the current object; clones retain the size at the time of cloning.
+     */
+    void set_cache_size(size_t cache_size) {
+        reader.set_cache_size(cache_size);
+        return;
+    }
+
+    /**
+     * @return Maximum size of the cache of decompressed tiles, in bytes.
+     */
+    size_t get_cache_size() const {
+        return reader.get_cache_size();
+    }
+private:
+    tiled_file_reader<V> reader;
+
+    lin_tiled_file<V>* clone_internal() const {
+        return new lin_tiled_file<V>(*this);
+    }
+};
+
+using logical_tiled_file = lin_tiled_file<Rcpp::LogicalVector>;
+
+using integer_tiled_file = lin_tiled_file<Rcpp::IntegerVector>;
+
+using double_tiled_file = lin_tiled_file<Rcpp::NumericVector>;
+
+
+/**
+ * @brief Logical, integer or numeric matrices with delayed subsetting and/or transposition of a seed matrix.
+ *
+ * This is typically constructed via `read_lin_block()` from a `DelayedMatrix` where the net subsetting and transposition are reported by `beachmat:::setupDelayedMatrix()`.
+ * Requests for rows or columns are mapped to the corresponding rows or columns of the seed,
+ * such that a transposed column request is served by extracting a row from the seed and vice versa.
+ * Row or column subsets of the seed are applied as filters on the extracted values.
+ *
+ * @tparam B The base class, either `lin_matrix` or `lin_sparse_matrix`.
+ * The latter should only be used if the seed is sparse, in which case the sparsity of the seed is preserved in the extracted rows and columns.
+ */
+template <class B>
+class lin_delayed_matrix final : public B {
+public:
+    /**
+     * Constructor from a seed matrix and the net subsetting and transposition.
+     *
+     * @param seed Pointer to the seed matrix.
+     * This should be a `lin_sparse_matrix` if `B` is `lin_sparse_matrix`.
+     * @param row_subset Integer vector of 1-based indices of the seed rows to retain, or `NULL` to retain all rows.
+     * @param col_subset Integer vector of 1-based indices of the seed columns to retain, or `NULL` to retain all columns.
+     * @param transposed Whether the subsetted seed should be transposed.
+     */
+    lin_delayed_matrix(std::unique_ptr<B> seed, Rcpp::RObject row_subset, Rcpp::RObject col_subset, bool transposed) : 
+        seed(std::move(seed)), 
+        row_index(row_subset, this->seed->get_nrow(), "row"), 
+        col_index(col_subset, this->seed->get_ncol(), "column"), 
+        transposed(transposed)
+    {
+        this->nrow = row_index.size(this->seed->get_nrow());
+        this->ncol = col_index.size(this->seed->get_ncol());
+        if (transposed) {
+            std::swap(this->nrow, this->ncol);
+        }
+        return;
+    }
+
+    ~lin_delayed_matrix() = default;
+    lin_delayed_matrix(lin_delayed_matrix&&) = default;
+    lin_delayed_matrix& operator=(lin_delayed_matrix&&) = default;
+
+    /**
+     * Copy constructor, which deep-copies the seed matrix via its `clone()` method.
+     */
+    lin_delayed_matrix(const lin_delayed_matrix& other) : B(other), seed(other.seed->clone()), 
+        row_index(other.row_index), col_index(other.col_index), transposed(other.transposed) {}
+
+    /**
+     * Copy assignment operator, which deep-copies the seed matrix via its `clone()` method.
+     */
+    lin_delayed_matrix& operator=(const lin_delayed_matrix& other) {
+        B::operator=(other);
+        seed = other.seed->clone();
+        row_index = other.row_index;
+        col_index = other.col_index;
+        transposed = other.transposed;
+        return *this;
+    }
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        return fetch_col(c, work, first, last);
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return fetch_row(r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        return fetch_col(c, work, first, last);
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return fetch_row(r, work, first, last);
+    }
+
+    sparse_index<const int*, int> get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const int*, int> get_row(size_t r, int* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_row(r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_row(size_t r, double* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_row(r, work_x, work_i, first, last);
+    }
+
+    /**
+     * @return An upper bound on the number of non-zero elements.
+     * This is exact if there are no duplicated indices in the row or column subsets and all seed rows and columns are retained.
+     */
+    size_t get_nnzero() const {
+        size_t bound = seed->get_nnzero() * row_index.multiplicity * col_index.multiplicity;
+        return std::min(bound, this->nrow * this->ncol);
+    }
+
+    void set_row_tile(bool use, size_t height = 0) {
+        seed->set_row_tile(use, height);
+        return;
+    }
+
+    bool has_row_tile() const {
+        return seed->has_row_tile();
+    }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        seed->set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return seed->has_row_index();
+    }
+private:
+    std::unique_ptr<B> seed;
+
+    /* Subset indices along one dimension of the seed. For each requested
+     * stretch of the subsetted dimension, we cache the span of seed indices
+     * that needs to be extracted, and whether the subset is contiguous within
+     * that span (in which case no filtering is required).
+     */
+    struct subset_index {
+        subset_index(Rcpp::RObject subset, size_t dim, const char* msg) {
+            subsetted = !subset.isNULL();
+            if (!subsetted) {
+                return;
+            }
+            if (subset.sexp_type() != INTSXP) {
+                throw std::runtime_error(std::string(msg) + " subset indices should be integer");
+            }
+
+            Rcpp::IntegerVector idx(subset);
+            indices.reserve(idx.size());
+            std::vector<size_t> counts(dim);
+            for (auto i : idx) {
+                if (i < 1 || static_cast<size_t>(i) > dim) {
+                    throw std::runtime_error(std::string(msg) + " subset indices are out of range");
+                }
+                indices.push_back(i - 1);
+                multiplicity = std::max(multiplicity, ++counts[i - 1]);
+            }
+            return;
+        }
+
+        bool subsetted = false;
+        std::vector<int> indices;
+        size_t multiplicity = 1;
+
+        size_t size(size_t dim) const {
+            return (subsetted ? indices.size() : dim);
+        }
+
+        size_t map(size_t i) const {
+            return (subsetted ? indices[i] : i);
+        }
+
+        size_t old_first = 0, old_last = 0, min_index = 0, max_index = 0;
+        bool contiguous = true;
+
+        void prepare(size_t first, size_t last) {
+            if (old_first == first && old_last == last) {
+                return;
+            }
+            old_first = first;
+            old_last = last;
+
+            if (first == last) {
+                min_index = 0;
+                max_index = 0;
+                contiguous = true;
+                return;
+            }
+
+            auto start = indices.begin() + first, end = indices.begin() + last;
+            min_index = *std::min_element(start, end);
+            max_index = *std::max_element(start, end) + 1;
+
+            contiguous = (max_index - min_index == last - first);
+            for (auto it = start + 1; contiguous && it != end; ++it) {
+                contiguous = (*it == *(it - 1) + 1);
+            }
+            return;
+        }
+    };
+
+    subset_index row_index, col_index;
+    bool transposed;
+
+    std::vector<int> ibuffer, ibuffer_i, slot;
+    std::vector<double> dbuffer;
+
+    std::vector<int>& buffer(int*) { return ibuffer; }
+    std::vector<double>& buffer(double*) { return dbuffer; }
+
+    // Avoids hiding of the dense extraction methods by the sparse overloads in lin_sparse_matrix.
+    lin_matrix& dense_seed() {
+        return *seed;
+    }
+
+    /* Dense extraction of the 's'-th row (if 'by_row') or column of the seed,
+     * where 'first' and 'last' refer to the possibly-subsetted other dimension.
+     */
+    template<typename T>
+    const T* fetch(bool by_row, size_t s, T* work, size_t first, size_t last, subset_index& other) {
+        lin_matrix& base = dense_seed();
+        if (!other.subsetted) {
+            return (by_row ? base.get_row(s, work, first, last) : base.get_col(s, work, first, last));
+        }
+
+        other.prepare(first, last);
+        if (other.contiguous) {
+            return (by_row ? base.get_row(s, work, other.min_index, other.max_index) : base.get_col(s, work, other.min_index, other.max_index));
+        }
+
+        auto& holding = buffer(work);
+        holding.resize(other.max_index - other.min_index);
+        auto ptr = (by_row ? base.get_row(s, holding.data(), other.min_index, other.max_index) : base.get_col(s, holding.data(), other.min_index, other.max_index));
+
+        auto start = other.indices.begin() + first, end = other.indices.begin() + last;
+        T* copy = work;
+        for (auto it = start; it != end; ++it, ++copy) {
+            *copy = ptr[*it - other.min_index];
+        }
+        return work;
+    }
+
+    // Sparse counterpart of the above, where 'other' is used to filter the non-zero elements.
+    template<typename T>
+    sparse_index<const T*, int> fetch(bool by_row, size_t s, T* work_x, int* work_i, size_t first, size_t last, subset_index& other) {
+        if (!other.subsetted) {
+            return (by_row ? seed->get_row(s, work_x, work_i, first, last) : seed->get_col(s, work_x, work_i, first, last));
+        }
+
+        other.prepare(first, last);
+        const size_t span = other.max_index - other.min_index;
+        auto& holding = buffer(work_x);
+        holding.resize(span);
+        ibuffer_i.resize(span);
+        auto out = (by_row ? seed->get_row(s, holding.data(), ibuffer_i.data(), other.min_index, other.max_index) : 
+            seed->get_col(s, holding.data(), ibuffer_i.data(), other.min_index, other.max_index));
+
+        if (other.contiguous) {
+            std::copy(out.x, out.x + out.n, work_x);
+            const int shift = static_cast<int>(first) - static_cast<int>(other.min_index);
+            for (size_t k = 0; k < out.n; ++k) {
+                work_i[k] = out.i[k] + shift;
+            }
+            return sparse_index<const T*, int>(out.n, work_x, work_i);
+        }
+
+        // Marking the position of each non-zero element in the span, then filtering in the order of the subset indices.
+        if (slot.size() < span) {
+            slot.resize(span, -1);
+        }
+        for (size_t k = 0; k < out.n; ++k) {
+            slot[out.i[k] - other.min_index] = k;
+        }
+
+        size_t n = 0;
+        for (size_t j = first; j < last; ++j) {
+            int p = slot[other.indices[j] - other.min_index];
+            if (p >= 0) {
+                work_x[n] = out.x[p];
+                work_i[n] = j;
+                ++n;
+            }
+        }
+
+        for (size_t k = 0; k < out.n; ++k) {
+            slot[out.i[k] - other.min_index] = -1;
+        }
+        return sparse_index<const T*, int>(n, work_x, work_i);
+    }
+
+    void check_col(size_t c, size_t first, size_t last) const {
+        dim_checker::check_dimension(c, this->ncol, "column");
+        dim_checker::check_subset(first, last, this->nrow, "row");
+        return;
+    }
+
+    void check_row(size_t r, size_t first, size_t last) const {
+        dim_checker::check_dimension(r, this->nrow, "row");
+        dim_checker::check_subset(first, last, this->ncol, "column");
+        return;
+    }
+
+    template<typename T>
+    const T* fetch_col(size_t c, T* work, size_t first, size_t last) {
+        check_col(c, first, last);
+        if (transposed) {
+            return fetch(true, row_index.map(c), work, first, last, col_index);
+        } else {
+            return fetch(false, col_index.map(c), work, first, last, row_index);
+        }
+    }
+
+    template<typename T>
+    const T* fetch_row(size_t r, T* work, size_t first, size_t last) {
+        check_row(r, first, last);
+        if (transposed) {
+            return fetch(false, col_index.map(r), work, first, last, row_index);
+        } else {
+            return fetch(true, row_index.map(r), work, first, last, col_index);
+        }
+    }
+
+    template<typename T>
+    sparse_index<const T*, int> fetch_col(size_t c, T* work_x, int* work_i, size_t first, size_t last) {
+        check_col(c, first, last);
+        if (transposed) {
+            return fetch(true, row_index.map(c), work_x, work_i, first, last, col_index);
+        } else {
+            return fetch(false, col_index.map(c), work_x, work_i, first, last, row_index);
+        }
+    }
+
+    template<typename T>
+    sparse_index<const T*, int> fetch_row(size_t r, T* work_x, int* work_i, size_t first, size_t last) {
+        check_row(r, first, last);
+        if (transposed) {
+            return fetch(false, col_index.map(r), work_x, work_i, first, last, row_index);
+        } else {
+            return fetch(true, row_index.map(r), work_x, work_i, first, last, col_index);
+        }
+    }
+
+    lin_delayed_matrix* clone_internal() const {
+        return new lin_delayed_matrix(*this);
+    }
+};
+
+
+/**
+ * @brief Logical, integer or numeric matrices formed by combining several matrices by row or by column.
+ *
+ * This is typically constructed via `read_lin_block()` from a `DelayedMatrix` created by `rbind()` or `cbind()`,
+ * where the combined matrices are reported by `beachmat:::setupDelayedMatrix()`.
+ * Each request is dispatched to the relevant matrices based on the cumulative number of rows or columns,
+ * so that each matrix is accessed with its own (possibly sparse) extraction methods.
+ *
+ * @tparam B The base class, either `lin_matrix` or `lin_sparse_matrix`.
+ * The latter should only be used if all combined matrices are sparse, in which case the output rows and columns are also sparse.
+ */
+template <class B>
+class lin_delayed_bind_matrix final : public B {
+public:
+    /**
+     * Constructor from the matrices to be combined.
+     *
+     * @param mats Vector of pointers to the matrices to be combined.
+     * These should be `lin_sparse_matrix` instances if `B` is `lin_sparse_matrix`.
+     * @param byrow Whether the matrices are combined by row, i.e., with `rbind()`.
+     * Otherwise, they are combined by column.
+     */
+    lin_delayed_bind_matrix(std::vector<std::unique_ptr<B> > mats, bool byrow) : children(std::move(mats)), byrow(byrow), cumulative(1) {
+        if (children.empty()) {
+            throw std::runtime_error("no matrices to combine");
+        }
+        this->nrow = children.front()->get_nrow();
+        this->ncol = children.front()->get_ncol();
+
+        size_t total = 0;
+        for (const auto& child : children) {
+            if ((byrow ? child->get_ncol() != this->ncol : child->get_nrow() != this->nrow)) {
+                throw std::runtime_error("combined matrices should have the same number of rows or columns");
+            }
+            total += (byrow ? child->get_nrow() : child->get_ncol());
+            cumulative.push_back(total);
+        }
+
+        if (byrow) {
+            this->nrow = total;
+        } else {
+            this->ncol = total;
+        }
+        return;
+    }
+
+    ~lin_delayed_bind_matrix() = default;
+    lin_delayed_bind_matrix(lin_delayed_bind_matrix&&) = default;
+    lin_delayed_bind_matrix& operator=(lin_delayed_bind_matrix&&) = default;
+
+    /**
+     * Copy constructor, which deep-copies the combined matrices via their `clone()` methods.
+     */
+    lin_delayed_bind_matrix(const lin_delayed_bind_matrix& other) : B(other), byrow(other.byrow), cumulative(other.cumulative) {
+        for (const auto& child : other.children) {
+            children.push_back(child->clone());
+        }
+    }
+
+    /**
+     * Copy assignment operator, which deep-copies the combined matrices via their `clone()` methods.
+     */
+    lin_delayed_bind_matrix& operator=(const lin_delayed_bind_matrix& other) {
+        lin_delayed_bind_matrix copy(other);
+        *this = std::move(copy);
+        return *this;
+    }
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        return fetch_col(c, work, first, last);
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return fetch_row(r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        return fetch_col(c, work, first, last);
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return fetch_row(r, work, first, last);
+    }
+
+    sparse_index<const int*, int> get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const int*, int> get_row(size_t r, int* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_row(r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_col(c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_row(size_t r, double* work_x, int* work_i, size_t first, size_t last) {
+        return fetch_row(r, work_x, work_i, first, last);
+    }
+
+    /**
+     * @return The total number of non-zero elements across all combined matrices.
+     */
+    size_t get_nnzero() const {
+        size_t total = 0;
+        for (const auto& child : children) {
+            total += child->get_nnzero();
+        }
+        return total;
+    }
+
+    void set_row_tile(bool use, size_t height = 0) {
+        for (auto& child : children) {
+            child->set_row_tile(use, height);
+        }
+        return;
+    }
+
+    bool has_row_tile() const {
+        for (const auto& child : children) {
+            if (!child->has_row_tile()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        for (auto& child : children) {
+            child->set_row_index(use, limit);
+        }
+        return;
+    }
+
+    bool has_row_index() const {
+        for (const auto& child : children) {
+            if (!child->has_row_index()) {
+                return false;
+            }
+        }
+        return true;
+    }
+private:
+    std::vector<std::unique_ptr<B> > children;
+    bool byrow;
+    std::vector<size_t> cumulative; // first row/column of each matrix, with the total at the end.
+
+    size_t find_child(size_t i) const {
+        return std::upper_bound(cumulative.begin(), cumulative.end(), i) - cumulative.begin() - 1;
+    }
+
+    // Avoids hiding of the dense extraction methods by the sparse overloads in lin_sparse_matrix.
+    lin_matrix& dense_child(size_t k) {
+        return *children[k];
+    }
+
+    /* Dense extraction of the 's'-th row (if 'by_row') or column, where 
+     * 'first' and 'last' refer to the other dimension. If that dimension is
+     * the combined one, each matrix fills its own stretch of 'work'.
+     */
+    template<typename T>
+    const T* fetch(bool by_row, size_t s, T* work, size_t first, size_t last) {
+        if (by_row == byrow) {
+            const size_t k = find_child(s);
+            s -= cumulative[k];
+            lin_matrix& child = dense_child(k);
+            return (by_row ? child.get_row(s, work, first, last) : child.get_col(s, work, first, last));
+        }
+
+        if (first == last) {
+            return work;
+        }
+        for (size_t k = find_child(first); k < children.size() && cumulative[k] < last; ++k) {
+            const size_t lo = std::max(first, cumulative[k]) - cumulative[k], hi = std::min(last, cumulative[k + 1]) - cumulative[k];
+            if (lo == hi) {
+                continue;
+            }
+
+            lin_matrix& child = dense_child(k);
+            T* current = work + (lo + cumulative[k] - first);
+            auto ptr = (by_row ? child.get_row(s, current, lo, hi) : child.get_col(s, current, lo, hi));
+            if (lo + cumulative[k] == first && hi + cumulative[k] == last) {
+                return ptr; // request lies entirely within one matrix.
+            }
+            if (ptr != current) {
+                std::copy(ptr, ptr + (hi - lo), current);
+            }
+        }
+        return work;
+    }
+
+    // Sparse counterpart of the above, where indices from each matrix are shifted to the combined dimension.
+    template<typename T>
+    sparse_index<const T*, int> fetch(bool by_row, size_t s, T* work_x, int* work_i, size_t first, size_t last) {
+        if (by_row == byrow) {
+            const size_t k = find_child(s);
+            s -= cumulative[k];
+            return (by_row ? children[k]->get_row(s, work_x, work_i, first, last) : children[k]->get_col(s, work_x, work_i, first, last));
+        }
+
+        size_t n = 0;
+        if (first == last) {
+            return sparse_index<const T*, int>(n, work_x, work_i);
+        }
+        for (size_t k = find_child(first); k < children.size() && cumulative[k] < last; ++k) {
+            const size_t lo = std::max(first, cumulative[k]) - cumulative[k], hi = std::min(last, cumulative[k + 1]) - cumulative[k];
+            if (lo == hi) {
+                continue;
+            }
+
+            auto out = (by_row ? children[k]->get_row(s, work_x + n, work_i + n, lo, hi) : children[k]->get_col(s, work_x + n, work_i + n, lo, hi));
+            if (out.x != work_x + n) {
+                std::copy(out.x, out.x + out.n, work_x + n);
+            }
+            const int shift = cumulative[k];
+            for (size_t j = 0; j < out.n; ++j) {
+                work_i[n + j] = out.i[j] + shift;
+            }
+            n += out.n;
+        }
+        return sparse_index<const T*, int>(n, work_x, work_i);
+    }
+
+    template<typename T>
+    const T* fetch_col(size_t c, T* work, size_t first, size_t last) {
+        dim_checker::check_dimension(c, this->ncol, "column");
+        dim_checker::check_subset(first, last, this->nrow, "row");
+        return fetch(false, c, work, first, last);
+    }
+
+    template<typename T>
+    const T* fetch_row(size_t r, T* work, size_t first, size_t last) {
+        dim_checker::check_dimension(r, this->nrow, "row");
+        dim_checker::check_subset(first, last, this->ncol, "column");
+        return fetch(true, r, work, first, last);
+    }
+
+    template<typename T>
+    sparse_index<const T*, int> fetch_col(size_t c, T* work_x, int* work_i, size_t first, size_t last) {
+        dim_checker::check_dimension(c, this->ncol, "column");
+        dim_checker::check_subset(first, last, this->nrow, "row");
+        return fetch(false, c, work_x, work_i, first, last);
+    }
+
+    template<typename T>
+    sparse_index<const T*, int> fetch_row(size_t r, T* work_x, int* work_i, size_t first, size_t last) {
+        dim_checker::check_dimension(r, this->nrow, "row");
+        dim_checker::check_subset(first, last, this->ncol, "column");
+        return fetch(true, r, work_x, work_i, first, last);
+    }
+
+    lin_delayed_bind_matrix* clone_internal() const {
+        return new lin_delayed_bind_matrix(*this);
+    }
+};
+
+
+/**
+ * @brief Logical, integer or numeric matrices with delayed value-modifying operations applied to a seed matrix.
+ *
+ * This is typically constructed via `read_lin_block()` from a `DelayedMatrix` where the delayed operations are supported by `delayed_op_stack`.
+ * Values are extracted from the seed and the operations are applied in double precision on each requested row or column,
+ * avoiding the need to realize the `DelayedMatrix` in R.
+ *
+ * @tparam B The base class, either `lin_matrix` or `lin_sparse_matrix`.
+ * The latter should only be used if the seed is sparse and all operations preserve zeroes, see `delayed_op_stack::preserves_zero()`.
+ */
+template <class B>
+class lin_delayed_ops_matrix final : public B {
+public:
+    /**
+     * Constructor from a seed matrix and a series of delayed operations.
+     *
+     * @param seed Pointer to the seed matrix.
+     * This should be a `lin_sparse_matrix` if `B` is `lin_sparse_matrix`.
+     * @param ops The delayed operations.
+     */
+    lin_delayed_ops_matrix(std::unique_ptr<B> seed, delayed_op_stack ops) : seed(std::move(seed)), ops(std::move(ops)) {
+        this->nrow = this->seed->get_nrow();
+        this->ncol = this->seed->get_ncol();
+        return;
+    }
+
+    ~lin_delayed_ops_matrix() = default;
+    lin_delayed_ops_matrix(lin_delayed_ops_matrix&&) = default;
+    lin_delayed_ops_matrix& operator=(lin_delayed_ops_matrix&&) = default;
+
+    /**
+     * Copy constructor, which deep-copies the seed matrix via its `clone()` method.
+     */
+    lin_delayed_ops_matrix(const lin_delayed_ops_matrix& other) : B(other), seed(other.seed->clone()), ops(other.ops) {}
+
+    /**
+     * Copy assignment operator, which deep-copies the seed matrix via its `clone()` method.
+     */
+    lin_delayed_ops_matrix& operator=(const lin_delayed_ops_matrix& other) {
+        B::operator=(other);
+        seed = other.seed->clone();
+        ops = other.ops;
+        return *this;
+    }
+
+    const int* get_col(size_t c, int* work, size_t first, size_t last) {
+        return ops.fetch(dense_seed(), false, c, work, first, last);
+    }
+
+    const int* get_row(size_t r, int* work, size_t first, size_t last) {
+        return ops.fetch(dense_seed(), true, r, work, first, last);
+    }
+
+    const double* get_col(size_t c, double* work, size_t first, size_t last) {
+        return ops.fetch(dense_seed(), false, c, work, first, last);
+    }
+
+    const double* get_row(size_t r, double* work, size_t first, size_t last) {
+        return ops.fetch(dense_seed(), true, r, work, first, last);
+    }
+
+    sparse_index<const int*, int> get_col(size_t c, int* work_x, int* work_i, size_t first, size_t last) {
+        return ops.fetch(*seed, false, c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const int*, int> get_row(size_t r, int* work_x, int* work_i, size_t first, size_t last) {
+        return ops.fetch(*seed, true, r, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_col(size_t c, double* work_x, int* work_i, size_t first, size_t last) {
+        return ops.fetch(*seed, false, c, work_x, work_i, first, last);
+    }
+
+    sparse_index<const double*, int> get_row(size_t r, double* work_x, int* work_i, size_t first, size_t last) {
+        return ops.fetch(*seed, true, r, work_x, work_i, first, last);
+    }
+
+    /**
+     * @return An upper bound on the number of non-zero elements, as some non-zero values in the seed may become zero after the operations.
+     */
+    size_t get_nnzero() const {
+        return seed->get_nnzero();
+    }
+
+    void set_row_tile(bool use, size_t height = 0) {
+        seed->set_row_tile(use, height);
+        return;
+    }
+
+    bool has_row_tile() const {
+        return seed->has_row_tile();
+    }
+
+    void set_row_index(bool use, size_t limit = default_row_index_limit) {
+        seed->set_row_index(use, limit);
+        return;
+    }
+
+    bool has_row_index() const {
+        return seed->has_row_index();
+    }
+private:
+    std::unique_ptr<B> seed;
+    delayed_op_stack ops;
+
+    // Avoids hiding of the dense extraction methods by the sparse overloads in lin_sparse_matrix.
+    lin_matrix& dense_seed() {
+        return *seed;
+    }
+
+    lin_delayed_ops_matrix* clone_internal() const {
+        return new lin_delayed_ops_matrix(*this);
+    }
+};
+
 }
 
 #endif
@@ -10,6 +10,11 @@
 #include "Rcpp.h"
 #include "dim_checker.h"
 #include "utils.h"
+#include "kernels.h"
+
+#include <memory>
+#include <algorithm>
+#include <vector>
 
 namespace beachmat {
 
@@ -20,10 +25,12 @@ namespace beachmat {
  *
  * @note This is an internal class and should not be constructed directly by **beachmat** users.
  *
- * @tparam V An `Rcpp::Vector` class, used to contain the contents of the matrix.
+ * @tparam V An `Rcpp::Vector` class, used to define the storage type of the matrix contents.
  */
 template <class V>
 class ordinary_reader : public dim_checker {
+private:
+    typedef typename V::stored_type T;
 public:
     ~ordinary_reader() = default;
     ordinary_reader(const ordinary_reader&) = default;
@@ -34,9 +41,10 @@ public:
     /** 
      * Constructor from an ordinary R matrix.
      *
-     * @param An ordinary R matrix.
+     * @param input An ordinary R matrix.
+     * @param detached Whether to detach the reader from `input`, see `make_anchor()` for details.
      */
-    ordinary_reader(Rcpp::RObject input) : mat(input) {
+    ordinary_reader(Rcpp::RObject input, bool detached = false) : mat(make_raw_vector<V>(input)), anchor(make_anchor(input, detached)) {
         this->fill_dims(input.attr("dim")); // consistency between 'dim' and mat.size() is guaranteed by R.
         return;
     }
@@ -49,13 +57,52 @@ public:
      * @param first Index of the first row of interest.
      * @param last Index of one-past-the-last row of interest.
      *
-     * @return An iterator pointing to the `first` element in column `c`.
+     * @return A pointer to the `first` element in column `c`.
      */
-    typename V::const_iterator get_col(size_t c, size_t first, size_t last) {
+    const T* get_col(size_t c, size_t first, size_t last) {
         this->check_colargs(c, first, last);
         return mat.begin() + (c * this->nrow) + first;
     }
 
+    /**
+     * Return a pointer to the start of a contiguous block of columns of the matrix.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     *
+     * @return A pointer to the first element of column `first_col`.
+     * Values for all rows and columns in `[first_col, last_col)` are stored contiguously in column-major format.
+     */
+    const T* get_cols(size_t first_col, size_t last_col) {
+        this->check_colsargs(first_col, last_col, 0, this->nrow);
+        return mat.begin() + first_col * (this->nrow);
+    }
+
+    /**
+     * Extract values from a contiguous block of columns of the matrix, possibly restricted to a subset of rows.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work A pointer to an array of values in which to store the column values.
+     * This should have at least `(last - first) * (last_col - first_col)` accessible elements.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @tparam Iter A pointer or iterator to a writeable sequence of elements.
+     *
+     * @return Values from rows `[first, last)` of columns `[first_col, last_col)` are copied to `work` in column-major format.
+     */
+    template <class Iter>
+    void get_cols(size_t first_col, size_t last_col, Iter work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        const size_t len = last - first;
+        auto src = mat.begin() + first_col * (this->nrow) + first;
+        for (size_t col = first_col; col < last_col; ++col, src += (this->nrow), work += len) {
+            copy_n_values(src, len, work);
+        }
+        return;
+    }
+
     /**
      * Extract values from a row of the matrix, possibly restricted to a subset of columns.
      *
@@ -71,13 +118,144 @@ public:
      */
     template <class Iter>
     void get_row(size_t r, Iter work, size_t first, size_t last) {
+        if (tile_height) {
+            auto src = get_row(r, first, last);
+            copy_n_values(src, last - first, work);
+            return;
+        }
+
         this->check_rowargs(r, first, last);
         auto src=mat.begin() + first * (this->nrow) + r;
         for (size_t col=first; col<last; ++col, src+=(this->nrow), ++work) { (*work)=(*src); }
         return;
     }
+
+    /**
+     * Return a pointer to a sequence of values from a row of the matrix, possibly restricted to a subset of columns.
+     * This requires row tiling to be enabled, see `set_row_tile()`.
+     *
+     * @param r The index of the row to extract.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return A pointer to the value in column `first` of row `r`, 
+     * where values for subsequent columns are stored contiguously in the internal tile.
+     * This pointer is only valid until the next call to any `get_row()` method.
+     */
+    const T* get_row(size_t r, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        if (r < tile_start || r >= tile_end) {
+            fill_tile(r);
+        }
+        return tile.data() + (r - tile_start) * (this->ncol) + first;
+    }
+
+    /**
+     * Extract values from a row of the matrix, possibly restricted to a subset of columns.
+     * If row tiling is enabled and the types match, this is a no-copy operation.
+     *
+     * @tparam X Type of the workspace values.
+     *
+     * @param r The index of the row to extract.
+     * @param work A pointer to an array of values in which to store the row values.
+     * This should have at least `last - first` accessible elements.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return A pointer to the values of row `r` from columns `[first, last)`.
+     * This is either a pointer into the internal tile or `work`.
+     */
+    template <typename X>
+    const X* get_row_direct(size_t r, X* work, size_t first, size_t last) {
+        if (tile_height) {
+            return direct_or_copy(get_row(r, first, last), last - first, work);
+        }
+        get_row(r, work, first, last);
+        return work;
+    }
+
+    /**
+     * Specify whether rows should be extracted via a row-major tile.
+     *
+     * If enabled, the first request for a row will transpose a tile of consecutive rows (across all columns) into an internal buffer.
+     * Subsequent requests for rows in the same tile are then served directly from this buffer,
+     * avoiding the strided access to the column-major array for each row.
+     *
+     * @param use Whether to use row tiling.
+     * @param height Number of rows in each tile.
+     * If zero, this is chosen so that the tile fits into a 256 KiB cache, with a minimum of 16 rows.
+     *
+     * @return Row tiling is enabled or disabled, and any existing tile is discarded.
+     */
+    void set_row_tile(bool use, size_t height) {
+        tile.clear();
+        tile_start = tile_end = 0;
+
+        if (!use) {
+            tile_height = 0;
+            tile.shrink_to_fit();
+            return;
+        }
+
+        if (height == 0) {
+            const size_t per_row = std::max(static_cast<size_t>(1), (this->ncol) * sizeof(T));
+            height = std::max(static_cast<size_t>(16), static_cast<size_t>(262144) / per_row);
+        }
+        tile_height = std::max(static_cast<size_t>(1), std::min(height, this->nrow));
+        return;
+    }
+
+    /**
+     * @return Whether row tiling is enabled, see `set_row_tile()`.
+     */
+    bool has_row_tile() const {
+        return tile_height > 0;
+    }
 private:
-    V mat;
+    raw_vector<T> mat;
+    std::shared_ptr<const Rcpp::RObject> anchor;
+
+    size_t tile_height = 0, tile_start = 0, tile_end = 0;
+    std::vector<T> tile;
+
+    /**
+     * Transpose the tile containing row `r` into the row-major buffer.
+     * Tiles are aligned to multiples of `tile_height` so that both forward and reverse passes reuse each tile.
+     */
+    void fill_tile(size_t r) {
+        const size_t NR = this->nrow, NC = this->ncol;
+        tile_start = (r / tile_height) * tile_height;
+        tile_end = std::min(tile_start + tile_height, NR);
+        const size_t h = tile_end - tile_start;
+        tile.resize(h * NC);
+
+        // Processing a few columns at a time, so that each row of the tile is written in contiguous runs
+        // while the reads from each column in the block proceed sequentially.
+        const size_t colblock = 8;
+        for (size_t c0 = 0; c0 < NC; c0 += colblock) {
+            const size_t c1 = std::min(c0 + colblock, NC);
+            auto src = mat.begin() + c0 * NR + tile_start;
+            auto dest = tile.begin() + c0;
+            for (size_t k = 0; k < h; ++k, ++src, dest += NC) {
+                auto curdest = dest;
+                auto cursrc = src;
+                for (size_t c = c0; c < c1; ++c, ++curdest, cursrc += NR) {
+                    *curdest = *cursrc;
+                }
+            }
+        }
+        return;
+    }
+
+    static const T* direct_or_copy(const T* src, size_t n, T* work) {
+        return src;
+    }
+
+    template <typename X>
+    static const X* direct_or_copy(const T* src, size_t n, X* work) {
+        copy_n_values(src, n, work);
+        return work;
+    }
 };
 
 }
@@ -11,6 +11,8 @@
 #include "lin_matrix.h"
 #include <stdexcept>
 #include <memory>
+#include <string>
+#include <utility>
 
 namespace beachmat {
 
@@ -20,12 +22,13 @@ namespace beachmat {
  *
  * @note This is an internal function and should not be called directly by **beachmat** users.
  *
- * @param block An R object containing a `dgCMatrix`, `lgCMatrix` or `SparseArraySeed`.
+ * @param block An R object containing a `dgCMatrix`, `lgCMatrix`, `SparseArraySeed` or `CsparseFile`.
+ * @param detached Whether to detach the output object from `block`, see `read_lin_block()`.
  *
  * @return A pointer to an instance of the `M` class.
  */
 template <class M> 
-std::unique_ptr<M> read_lin_sparse_block_raw (Rcpp::RObject block) {
+std::unique_ptr<M> read_lin_sparse_block_raw (Rcpp::RObject block, bool detached = false) {
     std::string ctype=get_class_name(block);
 
     if (ctype == "SparseArraySeed") {
@@ -33,47 +36,88 @@ std::unique_ptr<M> read_lin_sparse_block_raw (Rcpp::RObject block) {
         auto sexptype = nzdata.sexp_type();
         
         if (sexptype == INTSXP) {
-            return std::unique_ptr<M>(new integer_SparseArraySeed(block));
+            return std::unique_ptr<M>(new integer_SparseArraySeed(block, detached));
         } else if (sexptype == REALSXP) {
-            return std::unique_ptr<M>(new double_SparseArraySeed(block));
+            return std::unique_ptr<M>(new double_SparseArraySeed(block, detached));
         } else if (sexptype == LGLSXP) {
-            return std::unique_ptr<M>(new logical_SparseArraySeed(block));
+            return std::unique_ptr<M>(new logical_SparseArraySeed(block, detached));
         }
 
     } else if (ctype == "lgCMatrix") {
-        return std::unique_ptr<M>(new lgCMatrix(block));
+        return std::unique_ptr<M>(new lgCMatrix(block, detached));
 
     } else if (ctype == "dgCMatrix") {
-        return std::unique_ptr<M>(new dgCMatrix(block));
+        return std::unique_ptr<M>(new dgCMatrix(block, detached));
 
-    } 
+    } else if (ctype == "CsparseFile") {
+        std::string path = make_to_string(block.slot("path"));
+        auto type = read_Csparse_file_header(path).type;
+
+        if (type == INTSXP) {
+            return std::unique_ptr<M>(new integer_Csparse_file(path));
+        } else if (type == REALSXP) {
+            return std::unique_ptr<M>(new double_Csparse_file(path));
+        } else if (type == LGLSXP) {
+            return std::unique_ptr<M>(new logical_Csparse_file(path));
+        }
+    }
 
     return std::unique_ptr<M>();
 }
 
+inline std::unique_ptr<lin_matrix> read_lin_delayed_block(Rcpp::RObject, bool);
+
 /**
  * Read a logical, integer or numeric block into an instance of a `lin_matrix` subclass.
  * This can then be used to perform class- and type-agnostic extraction of row/column vectors.
  *
- * @param block An R object containing an ordinary submatrix, `dgCMatrix`, `lgCMatrix` or `SparseArraySeed`.
+ * @param block An R object containing an ordinary submatrix, `dgCMatrix`, `lgCMatrix`, `SparseArraySeed`, `CsparseFile` or `TiledFile`.
+ * Alternatively, a `DelayedMatrix` containing any of these as a seed, with supported delayed operations (see `read_lin_delayed_block()`).
+ * @param detached Whether to detach the output object from `block`.
  *
  * @return A pointer to a `lin_matrix` instance.
  * This function will automatically choose the most appropriate subclass or throw an error if none are available.
+ *
+ * @details
+ * By default, the output object (and any of its clones) will hold a reference to `block` to protect it from garbage collection.
+ * If `detached = true`, the output object instead holds raw pointers to the contents of `block`.
+ * This means that cloning, using and destroying the object (or its clones) will never involve the R API,
+ * allowing developers to safely create per-thread clones inside worker threads, e.g., with OpenMP or `std::thread`.
+ * Construction of the detached object itself should still be performed on the main thread.
+ * It is the caller's responsibility to ensure that `block` remains protected for the lifetime of the object and all of its clones;
+ * this is usually achieved by passing `block` directly from the arguments of a `.Call()`.
  */
-inline std::unique_ptr<lin_matrix> read_lin_block(Rcpp::RObject block) {
+inline std::unique_ptr<lin_matrix> read_lin_block(Rcpp::RObject block, bool detached = false) {
     if (block.isS4()) {
-        auto ptr = read_lin_sparse_block_raw<lin_matrix>(block);
+        std::string ctype = get_class_name(block);
+        if (ctype == "DelayedMatrix") {
+            return read_lin_delayed_block(block, detached);
+
+        } else if (ctype == "TiledFile") {
+            std::string path = make_to_string(block.slot("path"));
+            auto type = read_tiled_file_header(path).type;
+
+            if (type == INTSXP) {
+                return std::unique_ptr<lin_matrix>(new integer_tiled_file(path));
+            } else if (type == REALSXP) {
+                return std::unique_ptr<lin_matrix>(new double_tiled_file(path));
+            } else if (type == LGLSXP) {
+                return std::unique_ptr<lin_matrix>(new logical_tiled_file(path));
+            }
+        }
+
+        auto ptr = read_lin_sparse_block_raw<lin_matrix>(block, detached);
         if (ptr) {
             return ptr;
         }
     } else {
         auto sexptype = block.sexp_type();
         if (sexptype == INTSXP) {
-            return std::unique_ptr<lin_matrix>(new integer_ordinary_matrix(block));
+            return std::unique_ptr<lin_matrix>(new integer_ordinary_matrix(block, detached));
         } else if (sexptype == REALSXP) {
-            return std::unique_ptr<lin_matrix>(new double_ordinary_matrix(block));
+            return std::unique_ptr<lin_matrix>(new double_ordinary_matrix(block, detached));
         } else if (sexptype == LGLSXP) {
-            return std::unique_ptr<lin_matrix>(new logical_ordinary_matrix(block));
+            return std::unique_ptr<lin_matrix>(new logical_ordinary_matrix(block, detached));
         }
     }
 
@@ -84,14 +128,23 @@ inline std::unique_ptr<lin_matrix> read_lin_block(Rcpp::RObject block) {
  * Read a sparse logical, integer or numeric block into an instance of a `lin_sparse_matrix` subclass.
  * This can then be used to perform class- and type-agnostic extraction of row/column vectors and their non-zero values.
  *
- * @param block An R object containing a `dgCMatrix`, `lgCMatrix` or `SparseArraySeed`.
+ * @param block An R object containing a `dgCMatrix`, `lgCMatrix`, `SparseArraySeed` or `CsparseFile`.
+ * Alternatively, a `DelayedMatrix` containing any of these as a seed, where all delayed operations preserve sparsity (see `read_lin_delayed_block()`).
+ * @param detached Whether to detach the output object from `block`, see `read_lin_block()` for details.
  *
  * @return A pointer to a `lin_sparse_matrix` instance.
  * This function will automatically choose the most appropriate subclass or throw an error if none are available.
  */
-inline std::unique_ptr<lin_sparse_matrix> read_lin_sparse_block(Rcpp::RObject block) {
+inline std::unique_ptr<lin_sparse_matrix> read_lin_sparse_block(Rcpp::RObject block, bool detached = false) {
     if (block.isS4()) {
-        auto ptr = read_lin_sparse_block_raw<lin_sparse_matrix>(block);
+        if (get_class_name(block) == "DelayedMatrix") {
+            auto ptr = read_lin_delayed_block(block, detached);
+            if (ptr->is_sparse()) {
+                return std::unique_ptr<lin_sparse_matrix>(static_cast<lin_sparse_matrix*>(ptr.release()));
+            }
+        }
+
+        auto ptr = read_lin_sparse_block_raw<lin_sparse_matrix>(block, detached);
         if (ptr) {
             return ptr;
         }
@@ -101,6 +154,157 @@ inline std::unique_ptr<lin_sparse_matrix> read_lin_sparse_block(Rcpp::RObject bl
     throw std::runtime_error(ctype + std::string(" is not a recognized sparse representation"));
 }
 
+/**
+ * Read a sparse logical, integer or numeric block into an in-memory `lin_float_sparse_matrix`,
+ * where the non-zero values are stored in single precision.
+ *
+ * @param block An R object containing any of the sparse representations supported by `read_lin_sparse_block()`.
+ *
+ * @return A pointer to a `lin_sparse_matrix` instance.
+ * This does not hold any references to `block`, so cloning, using and destroying the object (or its clones) never involves the R API.
+ *
+ * @details
+ * The non-zero elements of `block` are copied upon construction, after which `block` may be discarded.
+ * This is most useful for repeated passes over a matrix with single-precision workspaces,
+ * as float extraction from the output object does not require any type conversion.
+ */
+inline std::unique_ptr<lin_sparse_matrix> read_lin_sparse_block_float(Rcpp::RObject block) {
+    auto ptr = read_lin_sparse_block(block, false);
+    return std::unique_ptr<lin_sparse_matrix>(new lin_float_sparse_matrix(*ptr));
+}
+
+/**
+ * Read a sparse logical, integer or numeric block into an instance of the appropriate concrete class,
+ * and call a function on that instance.
+ *
+ * @tparam F A callable type, typically a generic lambda or a class with a templated `operator()`.
+ *
+ * @param block An R object containing a `dgCMatrix`, `lgCMatrix`, `SparseArraySeed` or `CsparseFile`.
+ * @param fun A callable that accepts a reference to any of `lgCMatrix`, `dgCMatrix`, `integer_SparseArraySeed`,
+ * `logical_SparseArraySeed`, `double_SparseArraySeed`, `integer_Csparse_file`, `logical_Csparse_file` or `double_Csparse_file`.
+ * All instantiations should have the same return type.
+ * @param detached Whether to detach the object from `block`, see `read_lin_block()` for details.
+ *
+ * @return The return value of `fun`.
+ * An error is raised if `block` is not a recognized sparse representation.
+ *
+ * @details
+ * See `visit_lin_block()` for the motivation.
+ */
+template <class F>
+auto visit_lin_sparse_block(Rcpp::RObject block, F&& fun, bool detached = false) -> decltype(fun(std::declval<dgCMatrix&>())) {
+    if (!block.isS4()) {
+        throw std::runtime_error("'block' is not a recognized sparse representation");
+    }
+    std::string ctype=get_class_name(block);
+
+    if (ctype == "SparseArraySeed") {
+        Rcpp::RObject nzdata=block.slot("nzdata");
+        auto sexptype = nzdata.sexp_type();
+
+        if (sexptype == INTSXP) {
+            integer_SparseArraySeed mat(block, detached);
+            return fun(mat);
+        } else if (sexptype == REALSXP) {
+            double_SparseArraySeed mat(block, detached);
+            return fun(mat);
+        } else if (sexptype == LGLSXP) {
+            logical_SparseArraySeed mat(block, detached);
+            return fun(mat);
+        }
+
+    } else if (ctype == "lgCMatrix") {
+        lgCMatrix mat(block, detached);
+        return fun(mat);
+
+    } else if (ctype == "dgCMatrix") {
+        dgCMatrix mat(block, detached);
+        return fun(mat);
+
+    } else if (ctype == "CsparseFile") {
+        std::string path = make_to_string(block.slot("path"));
+        auto type = read_Csparse_file_header(path).type;
+
+        if (type == INTSXP) {
+            integer_Csparse_file mat(path);
+            return fun(mat);
+        } else if (type == REALSXP) {
+            double_Csparse_file mat(path);
+            return fun(mat);
+        } else if (type == LGLSXP) {
+            logical_Csparse_file mat(path);
+            return fun(mat);
+        }
+    }
+
+    throw std::runtime_error(ctype + std::string(" is not a recognized sparse representation"));
+}
+
+/**
+ * Read a logical, integer or numeric block into an instance of the appropriate concrete class,
+ * and call a function on that instance.
+ *
+ * @tparam F A callable type, typically a generic lambda or a class with a templated `operator()`.
+ *
+ * @param block An R object containing an ordinary submatrix, `dgCMatrix`, `lgCMatrix`, `SparseArraySeed`, `CsparseFile` or `TiledFile`.
+ * @param fun A callable that accepts a reference to any of the concrete `lin_matrix` subclasses,
+ * i.e., `integer_ordinary_matrix`, `logical_ordinary_matrix`, `double_ordinary_matrix`,
+ * `lgCMatrix`, `dgCMatrix`, `integer_SparseArraySeed`, `logical_SparseArraySeed`, `double_SparseArraySeed`,
+ * `integer_Csparse_file`, `logical_Csparse_file`, `double_Csparse_file`,
+ * `integer_tiled_file`, `logical_tiled_file` or `double_tiled_file`.
+ * All instantiations should have the same return type.
+ * @param detached Whether to detach the object from `block`, see `read_lin_block()` for details.
+ *
+ * @return The return value of `fun`.
+ * An error is raised if `block` is not a recognized matrix representation.
+ *
+ * @details
+ * This is an alternative to `read_lin_block()` where the class of `block` is only inspected once.
+ * As all concrete classes are `final`, calls to `get_col()`, `get_row()`, etc. within `fun` can be resolved at compile time,
+ * allowing the compiler to inline and vectorize the entire kernel for each representation.
+ * This is most beneficial for tight loops where the cost of the virtual call is a large fraction of the work per row/column.
+ * Note that the convenience overloads without `first` and `last` are only available via the base classes and remain virtual,
+ * so `fun` should call the full forms to benefit from devirtualization.
+ *
+ * The object passed to `fun` only exists for the duration of the call,
+ * though `fun` is free to `clone()` it as necessary.
+ */
+template <class F>
+auto visit_lin_block(Rcpp::RObject block, F&& fun, bool detached = false) -> decltype(fun(std::declval<double_ordinary_matrix&>())) {
+    if (block.isS4()) {
+        if (get_class_name(block) == "TiledFile") {
+            std::string path = make_to_string(block.slot("path"));
+            auto type = read_tiled_file_header(path).type;
+
+            if (type == INTSXP) {
+                integer_tiled_file mat(path);
+                return fun(mat);
+            } else if (type == REALSXP) {
+                double_tiled_file mat(path);
+                return fun(mat);
+            } else if (type == LGLSXP) {
+                logical_tiled_file mat(path);
+                return fun(mat);
+            }
+        }
+        return visit_lin_sparse_block(block, std::forward<F>(fun), detached);
+    } else {
+        auto sexptype = block.sexp_type();
+        if (sexptype == INTSXP) {
+            integer_ordinary_matrix mat(block, detached);
+            return fun(mat);
+        } else if (sexptype == REALSXP) {
+            double_ordinary_matrix mat(block, detached);
+            return fun(mat);
+        } else if (sexptype == LGLSXP) {
+            logical_ordinary_matrix mat(block, detached);
+            return fun(mat);
+        }
+    }
+
+    throw std::runtime_error("'block' is not a recognized matrix representation");
+}
+
 /**
  * Promote an existing pointer to a `lin_matrix` into a pointer to a `lin_sparse_matrix`.
  * This allows the code to switch between dense/sparse processing based on the observed class.
@@ -124,6 +328,109 @@ inline std::unique_ptr<lin_sparse_matrix> promote_to_sparse(std::unique_ptr<lin_
     return newptr;
 }
 
+
+/**
+ * Read a `DelayedMatrix` into an instance of a `lin_matrix` subclass, applying supported delayed operations natively.
+ *
+ * @param block An R object containing a `DelayedMatrix`.
+ * @param detached Whether to detach the output object from the seed of `block`, see `read_lin_block()` for details.
+ *
+ * @return A pointer to a `lin_matrix` instance.
+ * An error is raised if `block` contains unsupported delayed operations or its seed is not a recognized matrix representation.
+ *
+ * @details
+ * The seed of `block` is read with `read_lin_block()`.
+ * Value-modifying operations at the top of the delayed operation tree are parsed by `beachmat:::setupDelayedMatrix()` and,
+ * if they are all supported by `delayed_op_stack`, they are applied to the values extracted from the seed in each row or column.
+ * This avoids realizing the common `log1p(x / sf)` or `x * 2` matrices in R.
+ * If the seed is sparse and all operations map zero to zero, the output is a `lin_sparse_matrix` that preserves the sparsity of the seed.
+ *
+ * Any delayed subsetting or transposition of the seed below those operations is handled by `lin_delayed_matrix`,
+ * which also preserves the sparsity of the seed.
+ * Matrices combined with `rbind()` or `cbind()` are each read with `read_lin_block()` and handled by `lin_delayed_bind_matrix`,
+ * which is sparse if all of the combined matrices are sparse.
+ */
+inline std::unique_ptr<lin_matrix> read_lin_delayed_block(Rcpp::RObject block, bool detached) {
+    Rcpp::Environment beachenv = Rcpp::Environment::namespace_env("beachmat");
+    Rcpp::Function parser(beachenv["setupDelayedMatrix"]);
+    Rcpp::List parsed = parser(block);
+    if (parsed.size() != 5) {
+        throw std::runtime_error("output of beachmat:::setupDelayedMatrix should be a list of length 5");
+    }
+
+    std::unique_ptr<lin_matrix> ptr;
+    Rcpp::RObject net_sub = parsed[0], seed = parsed[2], bind_info = parsed[4];
+
+    if (!bind_info.isNULL()) {
+        Rcpp::List bind_parts(bind_info);
+        Rcpp::IntegerVector along(bind_parts[0]);
+        if (along.size() != 1) {
+            throw std::runtime_error("binding dimension should be an integer scalar");
+        }
+
+        // Each combined matrix is itself a DelayedMatrix, so recursion will handle any operations therein.
+        Rcpp::List seeds(bind_parts[1]);
+        std::vector<std::unique_ptr<lin_matrix> > children;
+        bool all_sparse = true;
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            children.push_back(read_lin_block(seeds[i], detached));
+            all_sparse = all_sparse && children.back()->is_sparse();
+        }
+
+        if (all_sparse) {
+            std::vector<std::unique_ptr<lin_sparse_matrix> > sparse_children;
+            for (auto& child : children) {
+                sparse_children.push_back(promote_to_sparse(child));
+            }
+            ptr.reset(new lin_delayed_bind_matrix<lin_sparse_matrix>(std::move(sparse_children), along[0] == 1));
+        } else {
+            ptr.reset(new lin_delayed_bind_matrix<lin_matrix>(std::move(children), along[0] == 1));
+        }
+
+    } else {
+        if (net_sub.isNULL() || (seed.isS4() && get_class_name(seed) == "DelayedMatrix")) {
+            throw std::runtime_error("'block' contains unsupported delayed operations");
+        }
+
+        Rcpp::List subs(net_sub);
+        Rcpp::LogicalVector trans(parsed[1]);
+        if (subs.size() != 2) {
+            throw std::runtime_error("subsetting list should be of length 2");
+        }
+        if (trans.size() != 1) {
+            throw std::runtime_error("transposition specifier should be of length 1");
+        }
+
+        ptr = read_lin_block(seed, detached);
+        Rcpp::RObject row_subset = subs[0], col_subset = subs[1];
+        const bool transposed = trans[0];
+        if (!row_subset.isNULL() || !col_subset.isNULL() || transposed) {
+            lin_matrix* delayed;
+            if (ptr->is_sparse()) {
+                delayed = new lin_delayed_matrix<lin_sparse_matrix>(promote_to_sparse(ptr), row_subset, col_subset, transposed);
+            } else {
+                delayed = new lin_delayed_matrix<lin_matrix>(std::move(ptr), row_subset, col_subset, transposed);
+            }
+            ptr.reset(delayed);
+        }
+    }
+
+    Rcpp::RObject op_info = parsed[3];
+    if (op_info.isNULL()) {
+        return ptr;
+    }
+
+    Rcpp::List op_parts(op_info);
+    Rcpp::List op_list = op_parts[1];
+    delayed_op_stack ops(op_list, make_to_string(op_parts[0]) != "double");
+
+    if (ptr->is_sparse() && ops.preserves_zero()) {
+        return std::unique_ptr<lin_matrix>(new lin_delayed_ops_matrix<lin_sparse_matrix>(promote_to_sparse(ptr), std::move(ops)));
+    } else {
+        return std::unique_ptr<lin_matrix>(new lin_delayed_ops_matrix<lin_matrix>(std::move(ptr), std::move(ops)));
+    }
+}
+
 }
 
 #endif
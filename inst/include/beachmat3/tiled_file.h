@@ -0,0 +1,822 @@
+#ifndef BEACHMAT_TILED_FILE_H
+#define BEACHMAT_TILED_FILE_H
+
+/**
+ * @file tiled_file.h
+ *
+ * Reading and writing of dense matrices in a simple tile-compressed binary file format.
+ *
+ * The matrix is partitioned into tiles of `tile_nrow` rows and `tile_ncol` columns,
+ * where the tiles on the bottom and right edges may be smaller if the dimensions are not exact multiples.
+ * Each file starts with a 64-byte header containing:
+ *
+ * - Bytes 0-7: the magic string `BMTILED` followed by a null terminator.
+ * - Bytes 8-11: the format version, as a 32-bit unsigned integer.
+ *   This is currently 1.
+ * - Bytes 12-15: the type of the values, as a 32-bit unsigned integer containing R's `SEXPTYPE` code,
+ *   i.e., `LGLSXP` for logical, `INTSXP` for integer and `REALSXP` for double-precision values.
+ * - Bytes 16-23 and 24-31: the number of rows and columns, respectively, as 64-bit unsigned integers.
+ * - Bytes 32-35 and 36-39: the number of rows and columns in each tile, respectively, as 32-bit unsigned integers.
+ * - Bytes 40-63: padding, filled with zeroes.
+ *
+ * This is followed by the tile index, containing the offset from the start of the file and the size in bytes of each tile
+ * as pairs of 64-bit unsigned integers, with tiles ordered in column-major fashion across the tile grid.
+ * The contents of each tile are stored as a column-major array of 32-bit signed integers for logical and integer types, or doubles otherwise.
+ * If the size of a tile is less than that of the uncompressed array, the tile has been compressed with the codec described in `encode_tile()`.
+ *
+ * All fields are stored in the native byte order of the machine that wrote the file.
+ */
+
+#include "Rcpp.h"
+#include "Csparse_file.h"
+#include "dim_checker.h"
+#include "kernels.h"
+#include "utils.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace beachmat {
+
+/**
+ * @brief Contents of the header of a tiled file.
+ */
+struct tiled_file_header {
+    /**
+     * R's `SEXPTYPE` code for the type of the values.
+     */
+    uint32_t type = 0;
+
+    /**
+     * Number of rows.
+     */
+    uint64_t nrow = 0;
+
+    /**
+     * Number of columns.
+     */
+    uint64_t ncol = 0;
+
+    /**
+     * Number of rows in each tile.
+     */
+    uint32_t tile_nrow = 0;
+
+    /**
+     * Number of columns in each tile.
+     */
+    uint32_t tile_ncol = 0;
+};
+
+/**
+ * @cond
+ */
+const size_t tiled_file_header_size = 64;
+
+const char tiled_file_magic[8] = { 'B', 'M', 'T', 'I', 'L', 'E', 'D', '\0' };
+
+const uint32_t tiled_file_version = 1;
+
+const size_t tiled_file_default_cache = 100000000;
+
+inline tiled_file_header parse_tiled_file_header(const unsigned char* buffer, const std::string& path) {
+    if (std::memcmp(buffer, tiled_file_magic, sizeof(tiled_file_magic)) != 0) {
+        throw std::runtime_error(std::string("'") + path + "' is not a tiled file");
+    }
+
+    uint32_t version;
+    std::memcpy(&version, buffer + 8, sizeof(version));
+    if (version != tiled_file_version) {
+        if (version == (tiled_file_version << 24)) {
+            throw std::runtime_error(std::string("'") + path + "' was written with a different byte order");
+        }
+        throw std::runtime_error(std::string("unsupported version of the tiled file format in '") + path + "'");
+    }
+
+    tiled_file_header header;
+    std::memcpy(&header.type, buffer + 12, sizeof(header.type));
+    if (header.type != LGLSXP && header.type != INTSXP && header.type != REALSXP) {
+        throw std::runtime_error(std::string("unsupported type of values in '") + path + "'");
+    }
+
+    std::memcpy(&header.nrow, buffer + 16, sizeof(header.nrow));
+    std::memcpy(&header.ncol, buffer + 24, sizeof(header.ncol));
+    std::memcpy(&header.tile_nrow, buffer + 32, sizeof(header.tile_nrow));
+    std::memcpy(&header.tile_ncol, buffer + 36, sizeof(header.tile_ncol));
+    if (header.tile_nrow == 0 || header.tile_ncol == 0) {
+        throw std::runtime_error(std::string("tile dimensions in '") + path + "' should be positive");
+    }
+    return header;
+}
+
+inline size_t tiled_file_ntiles(uint64_t extent, uint32_t tile_extent) {
+    return extent / tile_extent + (extent % tile_extent > 0);
+}
+
+template <typename T>
+using tile_word = typename std::conditional<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>::type;
+/**
+ * @endcond
+ */
+
+/**
+ * Read the header of a tiled file.
+ *
+ * @param path Path to the file.
+ *
+ * @return A `tiled_file_header` containing the type and dimensions of the matrix.
+ * An error is raised if the file is not a valid tiled file.
+ */
+inline tiled_file_header read_tiled_file_header(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error(std::string("failed to open '") + path + "'");
+    }
+
+    unsigned char buffer[tiled_file_header_size];
+    in.read(reinterpret_cast<char*>(buffer), tiled_file_header_size);
+    if (in.gcount() != static_cast<std::streamsize>(tiled_file_header_size)) {
+        throw std::runtime_error(std::string("'") + path + "' is too small to be a tiled file");
+    }
+
+    return parse_tiled_file_header(buffer, path);
+}
+
+/**
+ * Compress the contents of a tile with a lightweight codec.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam T Type of the values, either `int32_t` or `double`.
+ *
+ * @param values Pointer to an array of values.
+ * @param n Number of values.
+ * @param shuffled Workspace for the shuffled bytes.
+ * @param out Vector in which to store the compressed bytes.
+ *
+ * @details
+ * The bit pattern of each value is XOR'd with that of the previous value,
+ * so that runs of identical or similar values yield words where most bytes are zero.
+ * Bytes are then shuffled so that the `b`-th byte of every word is stored contiguously,
+ * grouping the (mostly zero) high-order bytes together.
+ * Finally, runs of zero bytes are run-length encoded.
+ * Each token starts with a control byte `c`; if `c < 128`, it is followed by `c + 1` literal bytes,
+ * otherwise it represents a run of `c - 126` zero bytes.
+ *
+ * This requires no external libraries and is much faster to decode than general-purpose compressors,
+ * while achieving good compression for integer counts, logicals and repeated or sparse double-precision values.
+ */
+template <typename T>
+inline void encode_tile(const T* values, size_t n, std::vector<unsigned char>& shuffled, std::vector<unsigned char>& out) {
+    typedef tile_word<T> W;
+    const size_t nbytes = sizeof(W);
+    const size_t N = n * nbytes;
+    shuffled.resize(N);
+
+    W prev = 0;
+    for (size_t k = 0; k < n; ++k) {
+        W cur;
+        std::memcpy(&cur, values + k, nbytes);
+        W delta = cur ^ prev;
+        prev = cur;
+        for (size_t b = 0; b < nbytes; ++b) {
+            shuffled[b * n + k] = static_cast<unsigned char>(delta >> (8 * b));
+        }
+    }
+
+    out.clear();
+    size_t literal = 0, i = 0;
+    auto flush = [&](size_t end) -> void {
+        while (literal < end) {
+            const size_t len = std::min(static_cast<size_t>(128), end - literal);
+            out.push_back(static_cast<unsigned char>(len - 1));
+            out.insert(out.end(), shuffled.begin() + literal, shuffled.begin() + literal + len);
+            literal += len;
+        }
+    };
+
+    while (i < N) {
+        if (shuffled[i] == 0) {
+            size_t j = i;
+            while (j < N && shuffled[j] == 0 && j - i < 129) {
+                ++j;
+            }
+            if (j - i >= 2) {
+                flush(i);
+                out.push_back(static_cast<unsigned char>(j - i + 126));
+                i = j;
+                literal = i;
+                continue;
+            }
+        }
+        ++i;
+    }
+    flush(N);
+    return;
+}
+
+/**
+ * Decompress the contents of a tile that was compressed with `encode_tile()`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam T Type of the values, either `int32_t` or `double`.
+ *
+ * @param in Pointer to the compressed bytes.
+ * @param len Number of compressed bytes.
+ * @param shuffled Workspace for the shuffled bytes.
+ * @param values Pointer to an array of length `n`, in which to store the decompressed values.
+ * @param n Number of values.
+ *
+ * @return `values` is filled with the decompressed values.
+ * An error is raised if the compressed bytes are corrupted.
+ */
+template <typename T>
+inline void decode_tile(const unsigned char* in, size_t len, std::vector<unsigned char>& shuffled, T* values, size_t n) {
+    typedef tile_word<T> W;
+    const size_t nbytes = sizeof(W);
+    const size_t N = n * nbytes;
+    shuffled.resize(N);
+
+    size_t pos = 0, o = 0;
+    while (pos < len) {
+        const unsigned char c = in[pos];
+        ++pos;
+        if (c < 128) {
+            const size_t l = static_cast<size_t>(c) + 1;
+            if (pos + l > len || o + l > N) {
+                throw std::runtime_error("corrupted tile in tiled file");
+            }
+            std::memcpy(shuffled.data() + o, in + pos, l);
+            pos += l;
+            o += l;
+        } else {
+            const size_t l = static_cast<size_t>(c) - 126;
+            if (o + l > N) {
+                throw std::runtime_error("corrupted tile in tiled file");
+            }
+            std::fill(shuffled.begin() + o, shuffled.begin() + o + l, 0);
+            o += l;
+        }
+    }
+    if (o != N) {
+        throw std::runtime_error("corrupted tile in tiled file");
+    }
+
+    W prev = 0;
+    for (size_t k = 0; k < n; ++k) {
+        W delta = 0;
+        for (size_t b = 0; b < nbytes; ++b) {
+            delta |= static_cast<W>(shuffled[b * n + k]) << (8 * b);
+        }
+        prev ^= delta;
+        std::memcpy(values + k, &prev, nbytes);
+    }
+    return;
+}
+
+/**
+ * @brief Least-recently-used cache of decompressed tiles.
+ *
+ * This also holds the file stream from which tiles are read.
+ * Copies of this object do not share or copy the cached tiles or the stream, only the size limit;
+ * this ensures that copies can be used safely in different threads.
+ *
+ * @note This is an internal class and should not be constructed directly by **beachmat** users.
+ *
+ * @tparam T Type of the values.
+ */
+template <typename T>
+class tile_cache {
+public:
+    /**
+     * @param l Maximum size of the cached tiles, in bytes.
+     */
+    tile_cache(size_t l = tiled_file_default_cache) : limit(l) {}
+
+    ~tile_cache() = default;
+    tile_cache(const tile_cache& other) : limit(other.limit) {}
+    tile_cache& operator=(const tile_cache& other) {
+        if (this != &other) {
+            clear();
+            limit = other.limit;
+        }
+        return *this;
+    }
+    tile_cache(tile_cache&&) = default;
+    tile_cache& operator=(tile_cache&&) = default;
+
+    /**
+     * @param id Identifier of the tile.
+     *
+     * @return Pointer to the values of the cached tile, or `NULL` if the tile is not in the cache.
+     * If found, the tile is marked as the most recently used.
+     */
+    const T* find(size_t id) {
+        auto it = lookup.find(id);
+        if (it == lookup.end()) {
+            return NULL;
+        }
+        tiles.splice(tiles.begin(), tiles, it->second);
+        return it->second->second.data();
+    }
+
+    /**
+     * @param id Identifier of the tile.
+     * @param n Number of values in the tile.
+     *
+     * @return Reference to a vector of length `n` to be filled with the tile's values.
+     * Least recently used tiles are evicted to keep the total size within the limit,
+     * though the new tile is always added even if it is larger than the limit.
+     */
+    std::vector<T>& insert(size_t id, size_t n) {
+        const size_t required = n * sizeof(T);
+        while (!tiles.empty() && used + required > limit) {
+            used -= tiles.back().second.size() * sizeof(T);
+            lookup.erase(tiles.back().first);
+            tiles.pop_back();
+        }
+
+        tiles.emplace_front(id, std::vector<T>(n));
+        lookup[id] = tiles.begin();
+        used += required;
+        return tiles.front().second;
+    }
+
+    /**
+     * Remove all cached tiles.
+     */
+    void clear() {
+        tiles.clear();
+        lookup.clear();
+        used = 0;
+        return;
+    }
+
+    /**
+     * @param l Maximum size of the cached tiles, in bytes.
+     * Existing tiles are evicted upon the next insertion if they exceed the new limit.
+     */
+    void set_limit(size_t l) {
+        limit = l;
+        return;
+    }
+
+    /**
+     * @return Maximum size of the cached tiles, in bytes.
+     */
+    size_t get_limit() const { return limit; }
+
+    /**
+     * Stream to the file, opened lazily by the reader.
+     */
+    std::unique_ptr<std::ifstream> stream;
+
+    /**
+     * Workspaces for reading and decompressing tiles.
+     */
+    std::vector<unsigned char> buffer, shuffled;
+private:
+    size_t limit, used = 0;
+    std::list<std::pair<size_t, std::vector<T> > > tiles;
+    std::unordered_map<size_t, typename std::list<std::pair<size_t, std::vector<T> > >::iterator> lookup;
+};
+
+/**
+ * @brief Reader for a tiled file.
+ *
+ * Tiles are read from the file and decompressed on demand, and the decompressed tiles are held in an LRU cache.
+ * Extraction of a row or column only involves the tiles that overlap with the requested interval,
+ * so both row- and column-wise access are efficient as long as one strip of tiles fits in the cache.
+ * Copies of this reader share the tile index but have their own cache and file stream,
+ * and neither copying nor destruction involves the R API.
+ *
+ * @note This is an internal class and should not be constructed directly by **beachmat** users.
+ *
+ * @tparam V The type of the `Rcpp::Vector` corresponding to the type of the values.
+ */
+template <class V>
+class tiled_file_reader : public dim_checker {
+private:
+    typedef typename V::stored_type T;
+public:
+    ~tiled_file_reader() = default;
+    tiled_file_reader(const tiled_file_reader&) = default;
+    tiled_file_reader& operator=(const tiled_file_reader&) = default;
+    tiled_file_reader(tiled_file_reader&&) = default;
+    tiled_file_reader& operator=(tiled_file_reader&&) = default;
+
+    /**
+     * Constructor from a path to a tiled file.
+     *
+     * @param path Path to the file.
+     * @param cache_size Maximum size of the cache of decompressed tiles, in bytes.
+     * If zero, this defaults to 100 MB or the size of the largest strip of tiles spanning the rows or columns, whichever is larger.
+     */
+    tiled_file_reader(const std::string& path, size_t cache_size = 0) : fname(path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error(std::string("failed to open '") + path + "'");
+        }
+
+        unsigned char buffer[tiled_file_header_size];
+        in.read(reinterpret_cast<char*>(buffer), tiled_file_header_size);
+        if (in.gcount() != static_cast<std::streamsize>(tiled_file_header_size)) {
+            throw std::runtime_error(std::string("'") + path + "' is too small to be a tiled file");
+        }
+
+        auto header = parse_tiled_file_header(buffer, path);
+        if (header.type != get_Csparse_file_type<V>()) {
+            throw std::runtime_error(std::string("'") + path + "' contains " + translate_type(header.type) + " values");
+        }
+        this->nrow = header.nrow;
+        this->ncol = header.ncol;
+        tile_nrow = header.tile_nrow;
+        tile_ncol = header.tile_ncol;
+        ntile_rows = tiled_file_ntiles(header.nrow, header.tile_nrow);
+        const size_t ntiles = ntile_rows * tiled_file_ntiles(header.ncol, header.tile_ncol);
+
+        auto idx = std::make_shared<std::vector<uint64_t> >(ntiles * 2);
+        in.read(reinterpret_cast<char*>(idx->data()), sizeof(uint64_t) * idx->size());
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(uint64_t) * idx->size())) {
+            throw std::runtime_error(std::string("'") + path + "' is truncated");
+        }
+
+        in.seekg(0, std::ios::end);
+        const uint64_t total = in.tellg();
+        for (size_t t = 0; t < ntiles; ++t) {
+            const uint64_t offset = (*idx)[2 * t], size = (*idx)[2 * t + 1];
+            if (offset > total || size > total - offset) {
+                throw std::runtime_error(std::string("'") + path + "' is truncated");
+            }
+            if (size > tile_length(t % ntile_rows, t / ntile_rows) * sizeof(T)) {
+                throw std::runtime_error(std::string("tile sizes in '") + path + "' should not exceed the uncompressed size");
+            }
+        }
+        index = idx;
+
+        if (cache_size == 0) {
+            const size_t row_strip = std::min(this->nrow, tile_nrow) * this->ncol * sizeof(T);
+            const size_t col_strip = std::min(this->ncol, tile_ncol) * this->nrow * sizeof(T);
+            cache_size = std::max(tiled_file_default_cache, std::max(row_strip, col_strip));
+        }
+        cache.set_limit(cache_size);
+        return;
+    }
+
+    /**
+     * Extract values from a column.
+     *
+     * @tparam ALT A pointer to an integer or double-precision array.
+     *
+     * @param c Index of the column of interest.
+     * @param work Pointer to an array of length `last - first`, in which to store the values.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @return `work` is filled with the values of rows `[first, last)` in column `c`.
+     */
+    template <typename ALT>
+    ALT get_col(size_t c, ALT work, size_t first, size_t last) {
+        this->check_colargs(c, first, last);
+        fill_block(c, c + 1, work, first, last);
+        return work;
+    }
+
+    /**
+     * Extract values from a row.
+     *
+     * @tparam ALT A pointer to an integer or double-precision array.
+     *
+     * @param r Index of the row of interest.
+     * @param work Pointer to an array of length `last - first`, in which to store the values.
+     * @param first Index of the first column of interest.
+     * @param last Index of one-past-the-last column of interest.
+     *
+     * @return `work` is filled with the values of columns `[first, last)` in row `r`.
+     */
+    template <typename ALT>
+    ALT get_row(size_t r, ALT work, size_t first, size_t last) {
+        this->check_rowargs(r, first, last);
+        if (first == last) {
+            return work;
+        }
+
+        const size_t tr = r / tile_nrow, lr = r - tr * tile_nrow;
+        const size_t tfirst = first / tile_ncol, tlast = (last - 1) / tile_ncol;
+        for (size_t tc = tfirst; tc <= tlast; ++tc) {
+            const T* tile = fetch_tile(tr, tc);
+            const size_t height = tile_height(tr);
+            const size_t start = std::max(first, tc * tile_ncol), end = std::min(last, (tc + 1) * tile_ncol);
+
+            tile += (start - tc * tile_ncol) * height + lr;
+            for (size_t c = start; c < end; ++c, tile += height) {
+                work[c - first] = convert_value<typename std::remove_pointer<ALT>::type>(*tile);
+            }
+        }
+        return work;
+    }
+
+    /**
+     * Extract values from a contiguous block of columns.
+     *
+     * @tparam ALT A pointer to an integer or double-precision array.
+     *
+     * @param first_col Index of the first column of interest.
+     * @param last_col Index of one-past-the-last column of interest.
+     * @param work Pointer to an array of length `(last - first) * (last_col - first_col)`, in which to store the values.
+     * @param first Index of the first row of interest.
+     * @param last Index of one-past-the-last row of interest.
+     *
+     * @return `work` is filled with the values of rows `[first, last)` in columns `[first_col, last_col)`, in column-major format.
+     * Each overlapping tile is only visited once, regardless of the size of the cache.
+     */
+    template <typename ALT>
+    ALT get_cols(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        this->check_colsargs(first_col, last_col, first, last);
+        fill_block(first_col, last_col, work, first, last);
+        return work;
+    }
+
+    /**
+     * @param cache_size Maximum size of the cache of decompressed tiles, in bytes.
+     */
+    void set_cache_size(size_t cache_size) {
+        cache.set_limit(cache_size);
+        return;
+    }
+
+    /**
+     * @return Maximum size of the cache of decompressed tiles, in bytes.
+     */
+    size_t get_cache_size() const {
+        return cache.get_limit();
+    }
+
+    /**
+     * @return Number of rows in each tile.
+     */
+    size_t get_tile_nrow() const { return tile_nrow; }
+
+    /**
+     * @return Number of columns in each tile.
+     */
+    size_t get_tile_ncol() const { return tile_ncol; }
+
+private:
+    std::string fname;
+    size_t tile_nrow = 0, tile_ncol = 0, ntile_rows = 0;
+    std::shared_ptr<const std::vector<uint64_t> > index;
+    tile_cache<T> cache;
+
+    size_t tile_height(size_t tr) const {
+        return std::min(tile_nrow, this->nrow - tr * tile_nrow);
+    }
+
+    size_t tile_width(size_t tc) const {
+        return std::min(tile_ncol, this->ncol - tc * tile_ncol);
+    }
+
+    size_t tile_length(size_t tr, size_t tc) const {
+        return tile_height(tr) * tile_width(tc);
+    }
+
+    const T* fetch_tile(size_t tr, size_t tc) {
+        const size_t id = tc * ntile_rows + tr;
+        const T* found = cache.find(id);
+        if (found) {
+            return found;
+        }
+
+        if (!cache.stream) {
+            cache.stream.reset(new std::ifstream(fname, std::ios::binary));
+            if (!(*cache.stream)) {
+                cache.stream.reset();
+                throw std::runtime_error(std::string("failed to open '") + fname + "'");
+            }
+        }
+
+        const uint64_t offset = (*index)[2 * id], size = (*index)[2 * id + 1];
+        auto& buffer = cache.buffer;
+        buffer.resize(size);
+        auto& in = *cache.stream;
+        in.seekg(offset);
+        in.read(reinterpret_cast<char*>(buffer.data()), size);
+        if (!in) {
+            in.clear();
+            throw std::runtime_error(std::string("failed to read a tile from '") + fname + "'");
+        }
+
+        const size_t n = tile_length(tr, tc);
+        auto& values = cache.insert(id, n);
+        if (size == n * sizeof(T)) {
+            std::memcpy(values.data(), buffer.data(), size);
+        } else {
+            decode_tile(buffer.data(), size, cache.shuffled, values.data(), n);
+        }
+        return values.data();
+    }
+
+    template <typename ALT>
+    void fill_block(size_t first_col, size_t last_col, ALT work, size_t first, size_t last) {
+        if (first == last || first_col == last_col) {
+            return;
+        }
+
+        const size_t len = last - first;
+        const size_t tfirst = first / tile_nrow, tlast = (last - 1) / tile_nrow;
+        const size_t cfirst = first_col / tile_ncol, clast = (last_col - 1) / tile_ncol;
+
+        for (size_t tc = cfirst; tc <= clast; ++tc) {
+            const size_t cstart = std::max(first_col, tc * tile_ncol), cend = std::min(last_col, (tc + 1) * tile_ncol);
+            for (size_t tr = tfirst; tr <= tlast; ++tr) {
+                const T* tile = fetch_tile(tr, tc);
+                const size_t height = tile_height(tr);
+                const size_t rstart = std::max(first, tr * tile_nrow), rend = std::min(last, (tr + 1) * tile_nrow);
+
+                const T* src = tile + (cstart - tc * tile_ncol) * height + (rstart - tr * tile_nrow);
+                ALT dest = work + (cstart - first_col) * len + (rstart - first);
+                for (size_t c = cstart; c < cend; ++c, src += height, dest += len) {
+                    copy_n_values(src, rend - rstart, dest);
+                }
+            }
+        }
+        return;
+    }
+};
+
+/**
+ * @brief Writer for a tiled file.
+ *
+ * Columns should be added in order with `add_column()`, after which `finish()` should be called to complete the file.
+ * Only one strip of `tile_ncol` columns is held in memory at any time,
+ * so files can be created for matrices that are much larger than the available memory.
+ */
+class tiled_file_writer {
+public:
+    /**
+     * @param path Path to the output file.
+     * Any existing file is overwritten.
+     * @param nr Number of rows.
+     * @param nc Number of columns.
+     * @param type R's `SEXPTYPE` code for the type of the values, i.e., `LGLSXP`, `INTSXP` or `REALSXP`.
+     * @param tnr Number of rows in each tile.
+     * @param tnc Number of columns in each tile.
+     * @param compress Whether to compress each tile, see `encode_tile()`.
+     * Tiles are stored uncompressed if compression does not reduce their size.
+     */
+    tiled_file_writer(const std::string& path, size_t nr, size_t nc, uint32_t type, size_t tnr, size_t tnc, bool compress = true) :
+        out(path, std::ios::binary | std::ios::trunc), fname(path), use_compression(compress)
+    {
+        if (!out) {
+            throw std::runtime_error(std::string("failed to open '") + path + "' for writing");
+        }
+        if (type != LGLSXP && type != INTSXP && type != REALSXP) {
+            throw std::runtime_error("unsupported type of values");
+        }
+        if (tnr == 0 || tnc == 0 || tnr > std::numeric_limits<uint32_t>::max() || tnc > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("tile dimensions should be positive 32-bit integers");
+        }
+
+        header.type = type;
+        header.nrow = nr;
+        header.ncol = nc;
+        header.tile_nrow = std::min(tnr, std::max(nr, static_cast<size_t>(1)));
+        header.tile_ncol = std::min(tnc, std::max(nc, static_cast<size_t>(1)));
+        ntile_rows = tiled_file_ntiles(nr, header.tile_nrow);
+        index.resize(ntile_rows * tiled_file_ntiles(nc, header.tile_ncol) * 2);
+
+        unsigned char buffer[tiled_file_header_size];
+        std::fill(buffer, buffer + tiled_file_header_size, 0);
+        std::memcpy(buffer, tiled_file_magic, sizeof(tiled_file_magic));
+        std::memcpy(buffer + 8, &tiled_file_version, sizeof(tiled_file_version));
+        std::memcpy(buffer + 12, &header.type, sizeof(header.type));
+        std::memcpy(buffer + 16, &header.nrow, sizeof(header.nrow));
+        std::memcpy(buffer + 24, &header.ncol, sizeof(header.ncol));
+        std::memcpy(buffer + 32, &header.tile_nrow, sizeof(header.tile_nrow));
+        std::memcpy(buffer + 36, &header.tile_ncol, sizeof(header.tile_ncol));
+        out.write(reinterpret_cast<const char*>(buffer), tiled_file_header_size);
+
+        // Reserving space for the index, which is filled in by finish().
+        std::vector<char> placeholder(sizeof(uint64_t) * index.size());
+        out.write(placeholder.data(), placeholder.size());
+        position = tiled_file_header_size + placeholder.size();
+        return;
+    }
+
+    /**
+     * Add the next column to the file.
+     *
+     * @tparam TIT Iterator to the values, possibly of a different type from that in the file.
+     *
+     * @param x Iterator to the start of the values of the column, containing `nr` values.
+     *
+     * @details
+     * This can be directly used with the output of `lin_matrix::get_col()`.
+     */
+    template <typename TIT>
+    void add_column(TIT x) {
+        if (column == header.ncol) {
+            throw std::runtime_error("all columns have already been added");
+        }
+        if (header.type == REALSXP) {
+            append(x, dstrip, dtile);
+        } else {
+            append(x, istrip, itile);
+        }
+        return;
+    }
+
+    /**
+     * Finish writing the file by adding the tile index.
+     * This should be called after all columns have been added.
+     */
+    void finish() {
+        if (column != header.ncol) {
+            throw std::runtime_error("not all columns have been added");
+        }
+
+        out.seekp(tiled_file_header_size);
+        out.write(reinterpret_cast<const char*>(index.data()), sizeof(uint64_t) * index.size());
+        out.close();
+        if (!out) {
+            throw std::runtime_error(std::string("failed to write '") + fname + "'");
+        }
+        return;
+    }
+private:
+    std::ofstream out;
+    std::string fname;
+    bool use_compression;
+    tiled_file_header header;
+    size_t ntile_rows = 0, column = 0, position = 0;
+    std::vector<uint64_t> index;
+
+    std::vector<double> dstrip, dtile;
+    std::vector<int32_t> istrip, itile;
+    std::vector<unsigned char> shuffled, compressed;
+
+    template <typename TIT, typename T>
+    void append(TIT x, std::vector<T>& strip, std::vector<T>& tile) {
+        const size_t NR = header.nrow;
+        const size_t offset = strip.size();
+        strip.resize(offset + NR);
+        std::copy(x, x + NR, strip.begin() + offset);
+        ++column;
+
+        if (column % header.tile_ncol == 0 || column == header.ncol) {
+            flush(strip, tile);
+        }
+        return;
+    }
+
+    template <typename T>
+    void flush(std::vector<T>& strip, std::vector<T>& tile) {
+        const size_t NR = header.nrow;
+        const size_t width = strip.size() / std::max(NR, static_cast<size_t>(1));
+        const size_t tc = (column - 1) / header.tile_ncol;
+
+        for (size_t tr = 0; tr < ntile_rows; ++tr) {
+            const size_t start = tr * header.tile_nrow;
+            const size_t height = std::min(static_cast<size_t>(header.tile_nrow), NR - start);
+            tile.resize(height * width);
+            for (size_t c = 0; c < width; ++c) {
+                auto src = strip.begin() + c * NR + start;
+                std::copy(src, src + height, tile.begin() + c * height);
+            }
+
+            const char* ptr = reinterpret_cast<const char*>(tile.data());
+            size_t size = tile.size() * sizeof(T);
+            if (use_compression) {
+                encode_tile(tile.data(), tile.size(), shuffled, compressed);
+                if (compressed.size() < size) {
+                    ptr = reinterpret_cast<const char*>(compressed.data());
+                    size = compressed.size();
+                }
+            }
+
+            const size_t id = tc * ntile_rows + tr;
+            index[2 * id] = position;
+            index[2 * id + 1] = size;
+            out.write(ptr, size);
+            position += size;
+        }
+
+        strip.clear();
+        return;
+    }
+};
+
+}
+
+#endif
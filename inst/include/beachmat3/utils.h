@@ -11,6 +11,8 @@
 #include <string>
 #include <utility>
 #include <stdexcept>
+#include <vector>
+#include <memory>
 
 namespace beachmat { 
 
@@ -127,6 +129,118 @@ inline std::string translate_type(int sexp_type) {
     return should_be;
 }
 
+/**
+ * @brief Read-only view of a contiguous array of values.
+ *
+ * This either points into the payload of an existing R vector, or shares ownership of a buffer allocated on the C++ side.
+ * Copying, assigning or destroying a `raw_vector` never touches the R API,
+ * so readers built around this class can be freely cloned in worker threads.
+ *
+ * @note This is an internal class and should not be constructed directly by **beachmat** users.
+ *
+ * @tparam T Type of the values.
+ */
+template <typename T>
+class raw_vector {
+public:
+    /**
+     * Trivial constructor, creating an empty view.
+     */
+    raw_vector() {}
+
+    /**
+     * Constructor from a pointer to an existing array.
+     * The array is not copied and should outlive the `raw_vector` and all of its copies.
+     *
+     * @param _ptr Pointer to the start of the array.
+     * @param _len Number of elements in the array.
+     */
+    raw_vector(const T* _ptr, size_t _len) : ptr(_ptr), len(_len) {}
+
+    /**
+     * Constructor from a buffer, taking (shared) ownership of its contents.
+     *
+     * @param store A vector of values.
+     */
+    raw_vector(std::vector<T> store) : owner(std::make_shared<const std::vector<T> >(std::move(store))) {
+        ptr = owner->data();
+        len = owner->size();
+    }
+
+    /**
+     * Pointer to the start of the array.
+     */
+    const T* begin() const { return ptr; }
+
+    /**
+     * Pointer to one-past-the-end of the array.
+     */
+    const T* end() const { return ptr + len; }
+
+    /**
+     * Number of elements in the array.
+     */
+    size_t size() const { return len; }
+
+    /**
+     * Value of the `i`-th element in the array.
+     */
+    const T& operator[](size_t i) const { return ptr[i]; }
+private:
+    const T* ptr = NULL;
+    size_t len = 0;
+    std::shared_ptr<const std::vector<T> > owner;
+};
+
+/**
+ * Create a `raw_vector` from an R vector.
+ * If `x` does not need any type coercion to be stored in `V`, the `raw_vector` will point directly into its payload;
+ * otherwise, the coerced values will be copied into a buffer owned by the `raw_vector`.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @tparam V An `Rcpp::Vector` class with the desired storage type.
+ *
+ * @param x An R object containing a vector or matrix.
+ *
+ * @return A `raw_vector` containing the values of `x`.
+ * This may only be used while `x` remains protected from garbage collection.
+ */
+template <class V>
+inline raw_vector<typename V::stored_type> make_raw_vector(const Rcpp::RObject& x) {
+    typedef typename V::stored_type T;
+    V tmp(x);
+    if (static_cast<SEXP>(tmp) == static_cast<SEXP>(x)) {
+        return raw_vector<T>(tmp.begin(), tmp.size());
+    } else {
+        return raw_vector<T>(std::vector<T>(tmp.begin(), tmp.end()));
+    }
+}
+
+/**
+ * Create an anchor to protect an R object for as long as a reader (or any of its copies) is alive.
+ *
+ * @note This is an internal function and should not be called directly by **beachmat** users.
+ *
+ * @param x An R object.
+ * @param detached Whether the reader should be detached from the R object.
+ *
+ * @return A shared pointer to a copy of `x`, which protects `x` from garbage collection.
+ * If `detached = true`, a null pointer is returned instead;
+ * it is then the caller's responsibility to ensure that `x` remains protected while the reader is in use.
+ *
+ * @details
+ * Copying the anchor only increments a reference count and does not involve the R API.
+ * However, destruction of the last copy will release the protection on `x`, which must be done on the main thread.
+ */
+inline std::shared_ptr<const Rcpp::RObject> make_anchor(const Rcpp::RObject& x, bool detached) {
+    if (detached) {
+        return nullptr;
+    } else {
+        return std::make_shared<const Rcpp::RObject>(x);
+    }
+}
+
 }
 
 #endif
@@ -5,6 +5,21 @@
 
 using namespace Rcpp;
 
+// build_gCMatrix
+Rcpp::RObject build_gCMatrix(Rcpp::IntegerVector i, Rcpp::IntegerVector j, Rcpp::RObject x, int nr, int nc, bool by_column);
+RcppExport SEXP _morebeachtests_build_gCMatrix(SEXP iSEXP, SEXP jSEXP, SEXP xSEXP, SEXP nrSEXP, SEXP ncSEXP, SEXP by_columnSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type i(iSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type j(jSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type nr(nrSEXP);
+    Rcpp::traits::input_parameter< int >::type nc(ncSEXP);
+    Rcpp::traits::input_parameter< bool >::type by_column(by_columnSEXP);
+    rcpp_result_gen = Rcpp::wrap(build_gCMatrix(i, j, x, nr, nc, by_column));
+    return rcpp_result_gen;
+END_RCPP
+}
 // test_clone
 Rcpp::NumericVector test_clone(Rcpp::RObject mat);
 RcppExport SEXP _morebeachtests_test_clone(SEXP matSEXP) {
@@ -25,6 +40,85 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// test_clone_detached
+Rcpp::NumericVector test_clone_detached(Rcpp::RObject mat);
+RcppExport SEXP _morebeachtests_test_clone_detached(SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_clone_detached(mat));
+    return rcpp_result_gen;
+END_RCPP
+}
+// test_clone_sparse_detached
+Rcpp::NumericVector test_clone_sparse_detached(Rcpp::RObject mat);
+RcppExport SEXP _morebeachtests_test_clone_sparse_detached(SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_clone_sparse_detached(mat));
+    return rcpp_result_gen;
+END_RCPP
+}
+// test_clone_threaded
+Rcpp::NumericVector test_clone_threaded(Rcpp::RObject mat, int nthreads);
+RcppExport SEXP _morebeachtests_test_clone_threaded(SEXP matSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_clone_threaded(mat, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// test_clone_sparse_threaded
+Rcpp::NumericVector test_clone_sparse_threaded(Rcpp::RObject mat, int nthreads);
+RcppExport SEXP _morebeachtests_test_clone_sparse_threaded(SEXP matSEXP, SEXP nthreadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_clone_sparse_threaded(mat, nthreads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fill_dense_output
+Rcpp::RObject fill_dense_output(Rcpp::RObject mat, Rcpp::IntegerVector order, int mode);
+RcppExport SEXP _morebeachtests_fill_dense_output(SEXP matSEXP, SEXP orderSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(fill_dense_output(mat, order, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fill_dense_output_sparse
+Rcpp::RObject fill_dense_output_sparse(Rcpp::RObject mat, Rcpp::IntegerVector order, int mode);
+RcppExport SEXP _morebeachtests_fill_dense_output_sparse(SEXP matSEXP, SEXP orderSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(fill_dense_output_sparse(mat, order, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fill_dense_output_threaded
+Rcpp::RObject fill_dense_output_threaded(Rcpp::RObject mat, int nthreads, int mode, bool sparse);
+RcppExport SEXP _morebeachtests_fill_dense_output_threaded(SEXP matSEXP, SEXP nthreadsSEXP, SEXP modeSEXP, SEXP sparseSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type nthreads(nthreadsSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< bool >::type sparse(sparseSEXP);
+    rcpp_result_gen = Rcpp::wrap(fill_dense_output_threaded(mat, nthreads, mode, sparse));
+    return rcpp_result_gen;
+END_RCPP
+}
 // test_sparse_writer1
 Rcpp::RObject test_sparse_writer1(int type);
 RcppExport SEXP _morebeachtests_test_sparse_writer1(SEXP typeSEXP) {
@@ -55,6 +149,74 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// get_column_float
+Rcpp::RObject get_column_float(Rcpp::RObject mat, Rcpp::IntegerVector order);
+RcppExport SEXP _morebeachtests_get_column_float(SEXP matSEXP, SEXP orderSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_column_float(mat, order));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_row_float
+Rcpp::RObject get_row_float(Rcpp::RObject mat, Rcpp::IntegerVector order);
+RcppExport SEXP _morebeachtests_get_row_float(SEXP matSEXP, SEXP orderSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_row_float(mat, order));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_sparse_column_float
+Rcpp::RObject get_sparse_column_float(Rcpp::RObject mat, Rcpp::IntegerVector order, bool stored);
+RcppExport SEXP _morebeachtests_get_sparse_column_float(SEXP matSEXP, SEXP orderSEXP, SEXP storedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type stored(storedSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_column_float(mat, order, stored));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_sparse_row_float
+Rcpp::RObject get_sparse_row_float(Rcpp::RObject mat, Rcpp::IntegerVector order, bool stored);
+RcppExport SEXP _morebeachtests_get_sparse_row_float(SEXP matSEXP, SEXP orderSEXP, SEXP storedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< bool >::type stored(storedSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_row_float(mat, order, stored));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_sparse_column_from_float
+Rcpp::RObject get_sparse_column_from_float(Rcpp::RObject mat, Rcpp::IntegerVector order);
+RcppExport SEXP _morebeachtests_get_sparse_column_from_float(SEXP matSEXP, SEXP orderSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_column_from_float(mat, order));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_integer_from_float
+Rcpp::RObject get_integer_from_float(Rcpp::RObject mat, bool by_row);
+RcppExport SEXP _morebeachtests_get_integer_from_float(SEXP matSEXP, SEXP by_rowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< bool >::type by_row(by_rowSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_integer_from_float(mat, by_row));
+    return rcpp_result_gen;
+END_RCPP
+}
 // get_column_slice
 Rcpp::RObject get_column_slice(Rcpp::RObject mat, Rcpp::IntegerVector order, Rcpp::IntegerVector starts, Rcpp::IntegerVector ends, int mode);
 RcppExport SEXP _morebeachtests_get_column_slice(SEXP matSEXP, SEXP orderSEXP, SEXP startsSEXP, SEXP endsSEXP, SEXP modeSEXP) {
@@ -107,6 +269,61 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// get_row_tiled
+Rcpp::RObject get_row_tiled(Rcpp::RObject mat, Rcpp::IntegerVector order, int height, int mode);
+RcppExport SEXP _morebeachtests_get_row_tiled(SEXP matSEXP, SEXP orderSEXP, SEXP heightSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< int >::type height(heightSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_row_tiled(mat, order, height, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_sparse_row_block
+Rcpp::RObject get_sparse_row_block(Rcpp::RObject mat, int step, int first, int last, int mode);
+RcppExport SEXP _morebeachtests_get_sparse_row_block(SEXP matSEXP, SEXP stepSEXP, SEXP firstSEXP, SEXP lastSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type last(lastSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_row_block(mat, step, first, last, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_column_block
+Rcpp::RObject get_column_block(Rcpp::RObject mat, int step, int first, int last, int mode);
+RcppExport SEXP _morebeachtests_get_column_block(SEXP matSEXP, SEXP stepSEXP, SEXP firstSEXP, SEXP lastSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type last(lastSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_column_block(mat, step, first, last, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
+// get_sparse_column_block
+Rcpp::RObject get_sparse_column_block(Rcpp::RObject mat, int step, int first, int last, int mode);
+RcppExport SEXP _morebeachtests_get_sparse_column_block(SEXP matSEXP, SEXP stepSEXP, SEXP firstSEXP, SEXP lastSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< int >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< int >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type last(lastSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_column_block(mat, step, first, last, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
 // get_sparse_column_slice
 Rcpp::RObject get_sparse_column_slice(Rcpp::RObject mat, Rcpp::IntegerVector order, Rcpp::IntegerVector starts, Rcpp::IntegerVector ends, int mode);
 RcppExport SEXP _morebeachtests_get_sparse_column_slice(SEXP matSEXP, SEXP orderSEXP, SEXP startsSEXP, SEXP endsSEXP, SEXP modeSEXP) {
@@ -159,6 +376,19 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// get_sparse_row_indexed
+Rcpp::RObject get_sparse_row_indexed(Rcpp::RObject mat, Rcpp::IntegerVector order, double limit, int mode);
+RcppExport SEXP _morebeachtests_get_sparse_row_indexed(SEXP matSEXP, SEXP orderSEXP, SEXP limitSEXP, SEXP modeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type order(orderSEXP);
+    Rcpp::traits::input_parameter< double >::type limit(limitSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    rcpp_result_gen = Rcpp::wrap(get_sparse_row_indexed(mat, order, limit, mode));
+    return rcpp_result_gen;
+END_RCPP
+}
 // test_promotion
 Rcpp::NumericVector test_promotion(Rcpp::RObject mat);
 RcppExport SEXP _morebeachtests_test_promotion(SEXP matSEXP) {
@@ -169,22 +399,63 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// test_visit
+Rcpp::NumericVector test_visit(Rcpp::RObject mat);
+RcppExport SEXP _morebeachtests_test_visit(SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_visit(mat));
+    return rcpp_result_gen;
+END_RCPP
+}
+// test_visit_sparse
+Rcpp::NumericVector test_visit_sparse(Rcpp::RObject mat);
+RcppExport SEXP _morebeachtests_test_visit_sparse(SEXP matSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    rcpp_result_gen = Rcpp::wrap(test_visit_sparse(mat));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_morebeachtests_build_gCMatrix", (DL_FUNC) &_morebeachtests_build_gCMatrix, 6},
     {"_morebeachtests_test_clone", (DL_FUNC) &_morebeachtests_test_clone, 1},
     {"_morebeachtests_test_clone_sparse", (DL_FUNC) &_morebeachtests_test_clone_sparse, 1},
+    {"_morebeachtests_test_clone_detached", (DL_FUNC) &_morebeachtests_test_clone_detached, 1},
+    {"_morebeachtests_test_clone_sparse_detached", (DL_FUNC) &_morebeachtests_test_clone_sparse_detached, 1},
+    {"_morebeachtests_test_clone_threaded", (DL_FUNC) &_morebeachtests_test_clone_threaded, 2},
+    {"_morebeachtests_test_clone_sparse_threaded", (DL_FUNC) &_morebeachtests_test_clone_sparse_threaded, 2},
+    {"_morebeachtests_fill_dense_output", (DL_FUNC) &_morebeachtests_fill_dense_output, 3},
+    {"_morebeachtests_fill_dense_output_sparse", (DL_FUNC) &_morebeachtests_fill_dense_output_sparse, 3},
+    {"_morebeachtests_fill_dense_output_threaded", (DL_FUNC) &_morebeachtests_fill_dense_output_threaded, 4},
     {"_morebeachtests_test_sparse_writer1", (DL_FUNC) &_morebeachtests_test_sparse_writer1, 1},
     {"_morebeachtests_test_sparse_writer2", (DL_FUNC) &_morebeachtests_test_sparse_writer2, 2},
     {"_morebeachtests_test_sparse_writer3", (DL_FUNC) &_morebeachtests_test_sparse_writer3, 0},
+    {"_morebeachtests_get_column_float", (DL_FUNC) &_morebeachtests_get_column_float, 2},
+    {"_morebeachtests_get_row_float", (DL_FUNC) &_morebeachtests_get_row_float, 2},
+    {"_morebeachtests_get_sparse_column_float", (DL_FUNC) &_morebeachtests_get_sparse_column_float, 3},
+    {"_morebeachtests_get_sparse_row_float", (DL_FUNC) &_morebeachtests_get_sparse_row_float, 3},
+    {"_morebeachtests_get_sparse_column_from_float", (DL_FUNC) &_morebeachtests_get_sparse_column_from_float, 2},
+    {"_morebeachtests_get_integer_from_float", (DL_FUNC) &_morebeachtests_get_integer_from_float, 2},
     {"_morebeachtests_get_column_slice", (DL_FUNC) &_morebeachtests_get_column_slice, 5},
     {"_morebeachtests_get_column", (DL_FUNC) &_morebeachtests_get_column, 3},
     {"_morebeachtests_get_row_slice", (DL_FUNC) &_morebeachtests_get_row_slice, 5},
     {"_morebeachtests_get_row", (DL_FUNC) &_morebeachtests_get_row, 3},
+    {"_morebeachtests_get_row_tiled", (DL_FUNC) &_morebeachtests_get_row_tiled, 4},
+    {"_morebeachtests_get_sparse_row_block", (DL_FUNC) &_morebeachtests_get_sparse_row_block, 5},
+    {"_morebeachtests_get_column_block", (DL_FUNC) &_morebeachtests_get_column_block, 5},
+    {"_morebeachtests_get_sparse_column_block", (DL_FUNC) &_morebeachtests_get_sparse_column_block, 5},
     {"_morebeachtests_get_sparse_column_slice", (DL_FUNC) &_morebeachtests_get_sparse_column_slice, 5},
     {"_morebeachtests_get_sparse_column", (DL_FUNC) &_morebeachtests_get_sparse_column, 3},
     {"_morebeachtests_get_sparse_row_slice", (DL_FUNC) &_morebeachtests_get_sparse_row_slice, 5},
     {"_morebeachtests_get_sparse_row", (DL_FUNC) &_morebeachtests_get_sparse_row, 3},
+    {"_morebeachtests_get_sparse_row_indexed", (DL_FUNC) &_morebeachtests_get_sparse_row_indexed, 4},
     {"_morebeachtests_test_promotion", (DL_FUNC) &_morebeachtests_test_promotion, 1},
+    {"_morebeachtests_test_visit", (DL_FUNC) &_morebeachtests_test_visit, 1},
+    {"_morebeachtests_test_visit_sparse", (DL_FUNC) &_morebeachtests_test_visit_sparse, 1},
     {NULL, NULL, 0}
 };
 
@@ -0,0 +1,41 @@
+#include "beachmat3/beachmat.h"
+
+#include <vector>
+
+/* Building a *gCMatrix from zero-based triplets in the supplied order, either
+ * one entry at a time or one column at a time (preserving the order of the
+ * entries within each column). Duplicated entries should be resolved with
+ * the last entry taking precedence.
+ */
+template <class V, typename T = typename V::stored_type>
+Rcpp::RObject build_gCMatrix0(Rcpp::IntegerVector i, Rcpp::IntegerVector j, V x, int nr, int nc, bool by_column) {
+    beachmat::gCMatrix_builder<V> builder(nr, nc);
+
+    if (!by_column) {
+        for (size_t k = 0; k < i.size(); ++k) {
+            builder.add(i[k], j[k], x[k]);
+        }
+    } else {
+        std::vector<std::vector<int> > rows(nc);
+        std::vector<std::vector<T> > vals(nc);
+        for (size_t k = 0; k < i.size(); ++k) {
+            rows[j[k]].push_back(i[k]);
+            vals[j[k]].push_back(x[k]);
+        }
+        for (int c = 0; c < nc; ++c) {
+            builder.reserve(c, rows[c].size());
+            builder.add_column(c, rows[c].data(), vals[c].data(), rows[c].size());
+        }
+    }
+
+    return builder.build();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject build_gCMatrix(Rcpp::IntegerVector i, Rcpp::IntegerVector j, Rcpp::RObject x, int nr, int nc, bool by_column) {
+    if (x.sexp_type() == LGLSXP) {
+        return build_gCMatrix0<Rcpp::LogicalVector>(i, j, x, nr, nc, by_column);
+    } else {
+        return build_gCMatrix0<Rcpp::NumericVector>(i, j, x, nr, nc, by_column);
+    }
+}
@@ -1,5 +1,7 @@
 #include "beachmat3/beachmat.h"
 #include <algorithm>
+#include <numeric>
+#include <thread>
 
 // [[Rcpp::export(rng=false)]]
 Rcpp::NumericVector test_clone(Rcpp::RObject mat) {
@@ -42,3 +44,100 @@ Rcpp::NumericVector test_clone_sparse(Rcpp::RObject mat) {
 
     return Rcpp::NumericVector::create(value);
 }
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_clone_detached(Rcpp::RObject mat) {
+    auto thing = beachmat::read_lin_block(mat, true);
+    std::vector<std::unique_ptr<beachmat::lin_matrix> > clones;
+    for (size_t i = 0; i < 3; ++i) {
+        clones.push_back(thing->clone());
+    }
+    thing.reset();
+
+    double value = 0;
+    std::vector<double> workspace(clones.front()->get_nrow());
+    for (size_t i = 0; i < clones.front()->get_ncol(); ++i) {
+        auto& current = clones[i % clones.size()];
+        auto out = current->get_col(i, workspace.data());
+        value += std::accumulate(out, out + current->get_nrow(), 0.0);
+    }
+
+    return Rcpp::NumericVector::create(value);
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_clone_sparse_detached(Rcpp::RObject mat) {
+    auto thing = beachmat::read_lin_sparse_block(mat, true);
+    std::vector<std::unique_ptr<beachmat::lin_sparse_matrix> > clones;
+    for (size_t i = 0; i < 3; ++i) {
+        clones.push_back(thing->clone());
+    }
+    thing.reset();
+
+    double value = 0;
+    std::vector<double> workspace_x(clones.front()->get_ncol());
+    std::vector<int> workspace_i(clones.front()->get_ncol());
+
+    for (size_t i = 0; i < clones.front()->get_nrow(); ++i) {
+        auto& current = clones[i % clones.size()];
+        auto out = current->get_row(i, workspace_x.data(), workspace_i.data());
+        value += std::accumulate(out.x, out.x + out.n, 0.0);
+    }
+
+    return Rcpp::NumericVector::create(value);
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_clone_threaded(Rcpp::RObject mat, int nthreads) {
+    auto thing = beachmat::read_lin_block(mat, true);
+    const beachmat::lin_matrix* source = thing.get();
+    std::vector<double> values(nthreads);
+    std::vector<std::thread> workers;
+
+    // Each worker clones the detached object and reads every 'nthreads'-th column.
+    for (int t = 0; t < nthreads; ++t) {
+        workers.emplace_back([=,&values]() -> void {
+            auto current = source->clone();
+            std::vector<double> workspace(current->get_nrow());
+            double value = 0;
+            for (size_t i = t; i < current->get_ncol(); i += nthreads) {
+                auto out = current->get_col(i, workspace.data());
+                value += std::accumulate(out, out + current->get_nrow(), 0.0);
+            }
+            values[t] = value;
+        });
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+    return Rcpp::NumericVector(values.begin(), values.end());
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_clone_sparse_threaded(Rcpp::RObject mat, int nthreads) {
+    auto thing = beachmat::read_lin_sparse_block(mat, true);
+    const beachmat::lin_sparse_matrix* source = thing.get();
+    std::vector<double> values(nthreads);
+    std::vector<std::thread> workers;
+
+    // Each worker clones the detached object and reads every 'nthreads'-th row.
+    for (int t = 0; t < nthreads; ++t) {
+        workers.emplace_back([=,&values]() -> void {
+            auto current = source->clone();
+            std::vector<double> workspace_x(current->get_ncol());
+            std::vector<int> workspace_i(current->get_ncol());
+            double value = 0;
+            for (size_t i = t; i < current->get_nrow(); i += nthreads) {
+                auto out = current->get_row(i, workspace_x.data(), workspace_i.data());
+                value += std::accumulate(out.x, out.x + out.n, 0.0);
+            }
+            values[t] = value;
+        });
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+    return Rcpp::NumericVector(values.begin(), values.end());
+}
@@ -0,0 +1,102 @@
+#include "beachmat3/beachmat.h"
+
+#include <thread>
+
+template <class V>
+Rcpp::RObject fill_dense_output0(Rcpp::RObject mat, Rcpp::IntegerVector order) {
+    auto ptr = beachmat::read_lin_block(mat);
+    beachmat::dense_output<V> output(ptr->get_nrow(), ptr->get_ncol());
+
+    // Extracting directly into the output columns, which is only a copy if the matrix does not use the workspace.
+    for (auto o : order) {
+        auto curout = output.get_col(o);
+        auto vec = ptr->get_col(o, curout);
+        if (vec != curout) {
+            output.set_col(o, vec);
+        }
+    }
+
+    return output.yield();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject fill_dense_output(Rcpp::RObject mat, Rcpp::IntegerVector order, int mode) {
+    if (mode==0) {
+        return fill_dense_output0<Rcpp::LogicalVector>(mat, order);
+    } else if (mode==1) {
+        return fill_dense_output0<Rcpp::IntegerVector>(mat, order);
+    } else {
+        return fill_dense_output0<Rcpp::NumericVector>(mat, order);
+    }
+}
+
+template <class V, typename T = typename V::stored_type>
+Rcpp::RObject fill_dense_output_sparse0(Rcpp::RObject mat, Rcpp::IntegerVector order) {
+    auto ptr = beachmat::read_lin_sparse_block(mat);
+    beachmat::dense_output<V> output(ptr->get_nrow(), ptr->get_ncol());
+    std::vector<int> work_i(ptr->get_nrow());
+    std::vector<T> work_x(ptr->get_nrow());
+
+    for (auto o : order) {
+        output.set_col(o, ptr->get_col(o, work_x.data(), work_i.data()));
+    }
+
+    return output.yield();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject fill_dense_output_sparse(Rcpp::RObject mat, Rcpp::IntegerVector order, int mode) {
+    if (mode==0) {
+        return fill_dense_output_sparse0<Rcpp::LogicalVector>(mat, order);
+    } else {
+        return fill_dense_output_sparse0<Rcpp::NumericVector>(mat, order);
+    }
+}
+
+template <class V, bool sparse, typename T = typename V::stored_type>
+Rcpp::RObject fill_dense_output_threaded0(Rcpp::RObject mat, int nthreads) {
+    auto source = beachmat::read_lin_sparse_block(mat, true);
+    const size_t NR = source->get_nrow(), NC = source->get_ncol();
+    beachmat::dense_output<V> output(NR, NC);
+    std::vector<std::thread> workers;
+
+    // Each worker clones the detached object and fills its own contiguous range of columns.
+    const size_t per_thread = (NC + nthreads - 1) / nthreads;
+    for (int t = 0; t < nthreads; ++t) {
+        const size_t start = std::min(NC, t * per_thread), end = std::min(NC, start + per_thread);
+        workers.emplace_back([&,start,end]() -> void {
+            auto current = source->clone();
+            std::vector<int> work_i(NR);
+            std::vector<T> work_x(NR);
+            for (size_t c = start; c < end; ++c) {
+                if (sparse) {
+                    output.set_col(c, current->get_col(c, work_x.data(), work_i.data()));
+                } else {
+                    output.set_col(c, current->get_col(c, work_x.data()));
+                }
+            }
+        });
+    }
+
+    for (auto& w : workers) {
+        w.join();
+    }
+    return output.yield();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject fill_dense_output_threaded(Rcpp::RObject mat, int nthreads, int mode, bool sparse) {
+    if (sparse) {
+        if (mode==0) {
+            return fill_dense_output_threaded0<Rcpp::LogicalVector, true>(mat, nthreads);
+        } else {
+            return fill_dense_output_threaded0<Rcpp::NumericVector, true>(mat, nthreads);
+        }
+    } else {
+        if (mode==0) {
+            return fill_dense_output_threaded0<Rcpp::LogicalVector, false>(mat, nthreads);
+        } else {
+            return fill_dense_output_threaded0<Rcpp::NumericVector, false>(mat, nthreads);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "beachmat3/beachmat.h"
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_column_float(Rcpp::RObject mat, Rcpp::IntegerVector order) {
+    auto ptr = beachmat::read_lin_block(mat);
+    std::vector<float> tmp(ptr->get_nrow());
+    Rcpp::NumericMatrix output(ptr->get_nrow(), ptr->get_ncol());
+
+    for (auto o : order) {
+        auto vec = ptr->get_col(o, tmp.data());
+        auto curout = output.column(o);
+        std::copy(vec, vec + ptr->get_nrow(), curout.begin());
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_row_float(Rcpp::RObject mat, Rcpp::IntegerVector order) {
+    auto ptr = beachmat::read_lin_block(mat);
+    std::vector<float> tmp(ptr->get_ncol());
+    Rcpp::NumericMatrix output(ptr->get_nrow(), ptr->get_ncol());
+
+    for (auto o : order) {
+        auto vec = ptr->get_row(o, tmp.data());
+        auto curout = output.row(o);
+        std::copy(vec, vec + ptr->get_ncol(), curout.begin());
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_column_float(Rcpp::RObject mat, Rcpp::IntegerVector order, bool stored) {
+    auto ptr = (stored ? beachmat::read_lin_sparse_block_float(mat) : beachmat::read_lin_sparse_block(mat));
+    beachmat::gCMatrix_builder<Rcpp::NumericVector> builder(ptr->get_nrow(), ptr->get_ncol());
+    std::vector<int> work_i(ptr->get_nrow());
+    std::vector<float> work_x(ptr->get_nrow());
+
+    for (auto o : order) {
+        auto stuff = ptr->get_col(o, work_x.data(), work_i.data());
+        builder.add_column(o, stuff.i, stuff.x, stuff.n);
+    }
+
+    return builder.build();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_row_float(Rcpp::RObject mat, Rcpp::IntegerVector order, bool stored) {
+    auto ptr = (stored ? beachmat::read_lin_sparse_block_float(mat) : beachmat::read_lin_sparse_block(mat));
+    beachmat::gCMatrix_builder<Rcpp::NumericVector> builder(ptr->get_nrow(), ptr->get_ncol());
+    std::vector<int> work_i(ptr->get_ncol());
+    std::vector<float> work_x(ptr->get_ncol());
+
+    for (auto o : order) {
+        auto stuff = ptr->get_row(o, work_x.data(), work_i.data());
+        for (size_t j = 0; j < stuff.n; ++j) {
+            builder.add(o, stuff.i[j], stuff.x[j]);
+        }
+    }
+
+    return builder.build();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_column_from_float(Rcpp::RObject mat, Rcpp::IntegerVector order) {
+    auto ptr = beachmat::read_lin_sparse_block_float(mat);
+    beachmat::gCMatrix_builder<Rcpp::NumericVector> builder(ptr->get_nrow(), ptr->get_ncol());
+    std::vector<int> work_i(ptr->get_nrow());
+    std::vector<double> work_x(ptr->get_nrow());
+
+    for (auto o : order) {
+        auto stuff = ptr->get_col(o, work_x.data(), work_i.data());
+        builder.add_column(o, stuff.i, stuff.x, stuff.n);
+    }
+
+    return builder.build();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_integer_from_float(Rcpp::RObject mat, bool by_row) {
+    auto ptr = beachmat::read_lin_sparse_block_float(mat);
+    beachmat::lin_matrix* dense = ptr.get();
+    const size_t NR = dense->get_nrow(), NC = dense->get_ncol();
+    Rcpp::IntegerMatrix output(NR, NC);
+
+    if (by_row) {
+        std::vector<int> tmp(NC);
+        for (size_t r = 0; r < NR; ++r) {
+            auto vec = dense->get_row(r, tmp.data());
+            auto curout = output.row(r);
+            std::copy(vec, vec + NC, curout.begin());
+        }
+    } else {
+        std::vector<int> tmp(NR);
+        for (size_t c = 0; c < NC; ++c) {
+            auto vec = dense->get_col(c, tmp.data());
+            auto curout = output.column(c);
+            std::copy(vec, vec + NR, curout.begin());
+        }
+    }
+
+    return output;
+}
@@ -0,0 +1,63 @@
+#include "beachmat3/beachmat.h"
+#include <algorithm>
+
+template <class M, typename T = typename M::stored_type>
+Rcpp::RObject get_column_block0(Rcpp::RObject mat, int step, int first, int last) {
+    auto ptr = beachmat::read_lin_block(mat);
+    const size_t NC = ptr->get_ncol(), len = last - first;
+    std::vector<T> tmp(len * step);
+    M output(ptr->get_nrow(), NC);
+
+    for (size_t c = 0; c < NC; c += step) {
+        size_t end = std::min(NC, c + step);
+        auto vec = ptr->get_cols(c, end, tmp.data(), first, last);
+        for (size_t j = c; j < end; ++j, vec += len) {
+            auto curout = output.column(j);
+            std::copy(vec, vec + len, curout.begin() + first);
+        }
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_column_block(Rcpp::RObject mat, int step, int first, int last, int mode) {
+    if (mode==0) {
+        return get_column_block0<Rcpp::LogicalMatrix>(mat, step, first, last);
+    } else if (mode==1) {
+        return get_column_block0<Rcpp::IntegerMatrix>(mat, step, first, last);
+    } else {
+        return get_column_block0<Rcpp::NumericMatrix>(mat, step, first, last);
+    }
+}
+
+template <class V, typename T = typename V::stored_type>
+Rcpp::RObject get_sparse_column_block0(Rcpp::RObject mat, int step, int first, int last) {
+    auto ptr = beachmat::read_lin_sparse_block(mat);
+    const size_t NC = ptr->get_ncol(), len = last - first;
+    std::vector<int> work_i(len * step);
+    std::vector<T> work_x(len * step);
+    std::vector<size_t> work_p(step + 1);
+    std::map<std::pair<int, int>, T> store;
+
+    for (size_t c = 0; c < NC; c += step) {
+        size_t end = std::min(NC, c + step);
+        auto stuff = ptr->get_cols(c, end, work_x.data(), work_i.data(), work_p.data(), first, last);
+        for (size_t j = 0; j < stuff.ncol; ++j) {
+            for (size_t k = stuff.p[j]; k < stuff.p[j + 1]; ++k) {
+                store[std::make_pair(c + j, stuff.i[k])] = stuff.x[k];
+            }
+        }
+    }
+
+    return beachmat::as_gCMatrix<V>(ptr->get_nrow(), NC, store); 
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_column_block(Rcpp::RObject mat, int step, int first, int last, int mode) {
+    if (mode == 0) {
+        return get_sparse_column_block0<Rcpp::LogicalVector>(mat, step, first, last);
+    } else {
+        return get_sparse_column_block0<Rcpp::NumericVector>(mat, step, first, last);
+    }
+}
@@ -59,3 +59,30 @@ Rcpp::RObject get_row(Rcpp::RObject mat, Rcpp::IntegerVector order, int mode)
         return get_row0<Rcpp::NumericMatrix>(mat, order);
     }
 }
+
+template <class M, typename T = typename M::stored_type>
+Rcpp::RObject get_row_tiled0(Rcpp::RObject mat, Rcpp::IntegerVector order, int height) {
+    auto ptr = beachmat::read_lin_block(mat);
+    ptr->set_row_tile(true, height);
+    std::vector<T> tmp(ptr->get_ncol());
+    M output(ptr->get_nrow(), ptr->get_ncol());
+
+    for (auto o : order) {
+        auto vec = ptr->get_row(o, tmp.data());
+        auto curout = output.row(o);
+        std::copy(vec, vec + ptr->get_ncol(), curout.begin());
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_row_tiled(Rcpp::RObject mat, Rcpp::IntegerVector order, int height, int mode) {
+    if (mode==0) {
+        return get_row_tiled0<Rcpp::LogicalMatrix>(mat, order, height);
+    } else if (mode==1) {
+        return get_row_tiled0<Rcpp::IntegerMatrix>(mat, order, height);
+    } else {
+        return get_row_tiled0<Rcpp::NumericMatrix>(mat, order, height);
+    }
+}
@@ -0,0 +1,32 @@
+#include "beachmat3/beachmat.h"
+
+template <class V, typename T = typename V::stored_type>
+Rcpp::RObject get_sparse_row_block0(Rcpp::RObject mat, int step, int first, int last) {
+    auto ptr = beachmat::read_lin_sparse_block(mat);
+    const size_t NR = ptr->get_nrow(), len = last - first;
+    std::vector<int> work_i(len * step);
+    std::vector<T> work_x(len * step);
+    std::vector<size_t> work_p(step + 1);
+    beachmat::gCMatrix_builder<V> builder(NR, ptr->get_ncol());
+
+    for (size_t r = 0; r < NR; r += step) {
+        size_t end = std::min(NR, r + step);
+        auto stuff = ptr->get_rows(r, end, work_x.data(), work_i.data(), work_p.data(), first, last);
+        for (size_t j = 0; j < stuff.nrow; ++j) {
+            for (size_t k = stuff.p[j]; k < stuff.p[j + 1]; ++k) {
+                builder.add(r + j, stuff.i[k], stuff.x[k]);
+            }
+        }
+    }
+
+    return builder.build();
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_row_block(Rcpp::RObject mat, int step, int first, int last, int mode) {
+    if (mode == 0) {
+        return get_sparse_row_block0<Rcpp::LogicalVector>(mat, step, first, last);
+    } else {
+        return get_sparse_row_block0<Rcpp::NumericVector>(mat, step, first, last);
+    }
+}
@@ -58,3 +58,33 @@ Rcpp::RObject get_sparse_row(Rcpp::RObject mat, Rcpp::IntegerVector order, int m
         return get_sparse_row0<Rcpp::NumericVector>(mat, order);
     }
 }
+
+template <class V, typename T = typename V::stored_type>
+Rcpp::RObject get_sparse_row_indexed0(Rcpp::RObject mat, Rcpp::IntegerVector order, double limit) {
+    auto ptr = beachmat::read_lin_sparse_block(mat);
+    ptr->set_row_index(true, limit);
+    std::vector<int> work_i(ptr->get_ncol());
+    std::vector<T> work_x(ptr->get_ncol());
+    std::map<std::pair<int, int>, T> store;
+
+    for (auto o : order) {
+        auto stuff = ptr->get_row(o, work_x.data(), work_i.data());
+        for (size_t j = 0; j < stuff.n; ++j) {
+            store[std::make_pair(stuff.i[j], o)] = stuff.x[j];
+        }
+    }
+
+    return Rcpp::List::create(
+        beachmat::as_gCMatrix<V>(ptr->get_nrow(), ptr->get_ncol(), store),
+        Rcpp::LogicalVector::create(ptr->has_row_index())
+    );
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject get_sparse_row_indexed(Rcpp::RObject mat, Rcpp::IntegerVector order, double limit, int mode) {
+    if (mode == 0) {
+        return get_sparse_row_indexed0<Rcpp::LogicalVector>(mat, order, limit);
+    } else {
+        return get_sparse_row_indexed0<Rcpp::NumericVector>(mat, order, limit);
+    }
+}
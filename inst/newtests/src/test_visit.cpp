@@ -0,0 +1,45 @@
+#include "beachmat3/beachmat.h"
+#include <numeric>
+
+struct column_sums {
+    template <class M>
+    Rcpp::NumericVector operator()(M& mat) const {
+        const size_t NR = mat.get_nrow(), NC = mat.get_ncol();
+        std::vector<double> work(NR);
+        Rcpp::NumericVector output(NC);
+
+        for (size_t c = 0; c < NC; ++c) {
+            auto ptr = mat.get_col(c, work.data(), 0, NR);
+            output[c] = std::accumulate(ptr, ptr + NR, 0.0);
+        }
+
+        return output;
+    }
+};
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_visit(Rcpp::RObject mat) {
+    return beachmat::visit_lin_block(mat, column_sums());
+}
+
+struct sparse_column_sums {
+    template <class M>
+    Rcpp::NumericVector operator()(M& mat) const {
+        const size_t NR = mat.get_nrow(), NC = mat.get_ncol();
+        std::vector<double> work_x(NR);
+        std::vector<int> work_i(NR);
+        Rcpp::NumericVector output(NC);
+
+        for (size_t c = 0; c < NC; ++c) {
+            auto idx = mat.get_col(c, work_x.data(), work_i.data(), 0, NR);
+            output[c] = std::accumulate(idx.x, idx.x + idx.n, 0.0);
+        }
+
+        return output;
+    }
+};
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::NumericVector test_visit_sparse(Rcpp::RObject mat) {
+    return beachmat::visit_lin_sparse_block(mat, sparse_column_sums());
+}
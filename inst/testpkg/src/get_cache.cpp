@@ -0,0 +1,42 @@
+#include "beachtest.h"
+
+/* Running a sequence of requests through the unknown reader, where non-negative
+ * values are column indices and negative values encode row '-value - 1'. The 
+ * cache statistics are reported along with the extracted values.
+ */
+
+extern "C" {
+
+SEXP get_cache_numeric(SEXP in, SEXP requests, SEXP limit) {
+    BEGIN_RCPP
+    beachmat::unknown_reader<double, Rcpp::NumericVector> reader(in);
+    Rcpp::NumericVector Limit(limit);
+    if (Limit.size()) {
+        reader.set_cache_size(Limit[0]);
+    }
+
+    Rcpp::IntegerVector Requests(requests);
+    Rcpp::List values(Requests.size());
+    for (size_t i=0; i<Requests.size(); ++i) {
+        const int current=Requests[i];
+        if (current >= 0) {
+            Rcpp::NumericVector out(reader.get_nrow());
+            reader.get_col(current, out.begin(), 0, reader.get_nrow());
+            values[i]=out;
+        } else {
+            Rcpp::NumericVector out(reader.get_ncol());
+            reader.get_row(-current - 1, out.begin(), 0, reader.get_ncol());
+            values[i]=out;
+        }
+    }
+
+    return Rcpp::List::create(
+        Rcpp::Named("hits")=static_cast<int>(reader.get_cache_hits()),
+        Rcpp::Named("misses")=static_cast<int>(reader.get_cache_misses()),
+        Rcpp::Named("size")=static_cast<double>(reader.get_cache_size()),
+        Rcpp::Named("values")=values
+    );
+    END_RCPP
+}
+
+}
@@ -0,0 +1,54 @@
+#include "beachtest.h"
+
+/* Reading all columns from copies of a DelayedMatrix reader, 
+ * created by copy construction and by copy assignment.
+ */
+
+template <class T, class O, class M>
+O get_col_copy (M& mat) {
+    const size_t nrows=mat.get_nrow(), ncols=mat.get_ncol();
+    O output(nrows, ncols);
+    T target(nrows);
+    for (size_t c=0; c<ncols; ++c) {
+        mat.get_col(c, target.begin());
+        auto outcol=output.column(c);
+        std::copy(target.begin(), target.end(), outcol.begin());
+    }
+    return output;
+}
+
+template <class T, class O, class M>
+Rcpp::List get_delayed_copy (SEXP in, SEXP other) {
+    M original(in);
+    M constructed(original);
+
+    M assigned(other);
+    assigned=original;
+
+    return Rcpp::List::create(
+        get_col_copy<T, O>(constructed), 
+        get_col_copy<T, O>(assigned)
+    );
+}
+
+extern "C" {
+
+SEXP get_delayed_copy_integer(SEXP in, SEXP other) {
+    BEGIN_RCPP
+    return get_delayed_copy<Rcpp::IntegerVector, Rcpp::IntegerMatrix, beachmat::delayed_integer_matrix>(in, other);
+    END_RCPP
+}
+
+SEXP get_delayed_copy_numeric(SEXP in, SEXP other) {
+    BEGIN_RCPP
+    return get_delayed_copy<Rcpp::NumericVector, Rcpp::NumericMatrix, beachmat::delayed_numeric_matrix>(in, other);
+    END_RCPP
+}
+
+SEXP get_delayed_copy_logical(SEXP in, SEXP other) {
+    BEGIN_RCPP
+    return get_delayed_copy<Rcpp::LogicalVector, Rcpp::LogicalMatrix, beachmat::delayed_logical_matrix>(in, other);
+    END_RCPP
+}
+
+}
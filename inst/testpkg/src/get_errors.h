@@ -70,6 +70,23 @@ void get_multi_errors(M ptr, const Rcpp::IntegerVector& mode) {
         } else {
             ptr->get_cols(thingy.begin(), thingy.size(), stuff.begin(), 0, -1); // break!
         }
+
+    } else if (Mode==5 || Mode==-5) {
+        Rcpp::IntegerVector thingy=Rcpp::IntegerVector::create(-1, 0, 1); // invalid first index.
+        if (Mode > 0) { 
+            ptr->get_rows(thingy.begin(), thingy.size(), stuff.begin(), 0, 0); // break!
+        } else {
+            ptr->get_cols(thingy.begin(), thingy.size(), stuff.begin(), 0, 0); // break!
+        }
+
+    } else if (Mode==6 || Mode==-6) {
+        if (Mode > 0) { 
+            Rcpp::IntegerVector thingy=Rcpp::IntegerVector::create(ptr->get_nrow()); 
+            ptr->get_rows(thingy.begin(), thingy.size(), stuff.begin(), 0, 0); // break!
+        } else {
+            Rcpp::IntegerVector thingy=Rcpp::IntegerVector::create(ptr->get_ncol());
+            ptr->get_cols(thingy.begin(), thingy.size(), stuff.begin(), 0, 0); // break!
+        }
     }
     return;
 }
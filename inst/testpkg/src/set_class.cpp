@@ -1,5 +1,29 @@
 #include "beachtest.h"
 
+/* Filling an output matrix that respects the realization backend, by row or by column. */
+
+template <class T, class M, class CREATOR>
+Rcpp::List set_sink(M ptr, CREATOR creator, SEXP byrow) {
+    const size_t nrow=ptr->get_nrow(), ncol=ptr->get_ncol();
+    auto optr=creator(nrow, ncol, beachmat::output_param());
+
+    if (Rcpp::LogicalVector(byrow)[0]) {
+        T work(ncol);
+        for (size_t r=0; r<nrow; ++r) {
+            ptr->get_row(r, work.begin());
+            optr->set_row(r, work.begin());
+        }
+    } else {
+        T work(nrow);
+        for (size_t c=0; c<ncol; ++c) {
+            ptr->get_col(c, work.begin());
+            optr->set_col(c, work.begin());
+        }
+    }
+
+    return Rcpp::List::create(Rcpp::StringVector::create(optr->get_class()), optr->yield());
+}
+
 extern "C" {
 
 SEXP set_class_by_sexp(SEXP incoming) {
@@ -9,5 +33,25 @@ SEXP set_class_by_sexp(SEXP incoming) {
     END_RCPP
 }
 
+SEXP set_sink_numeric(SEXP incoming, SEXP byrow) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_numeric_matrix(incoming);
+    return set_sink<Rcpp::NumericVector>(ptr.get(), beachmat::create_numeric_output, byrow);
+    END_RCPP
+}
+
+SEXP set_sink_integer(SEXP incoming, SEXP byrow) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_integer_matrix(incoming);
+    return set_sink<Rcpp::IntegerVector>(ptr.get(), beachmat::create_integer_output, byrow);
+    END_RCPP
+}
+
+SEXP set_sink_logical(SEXP incoming, SEXP byrow) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_logical_matrix(incoming);
+    return set_sink<Rcpp::LogicalVector>(ptr.get(), beachmat::create_logical_output, byrow);
+    END_RCPP
 }
 
+}
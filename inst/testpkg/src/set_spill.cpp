@@ -0,0 +1,116 @@
+#include "beachtest.h"
+
+/* Filling a sparse output matrix that spills to disk, column by column. We
+ * also check whether the writer can be copied or have its first column
+ * modified, which should only be possible if nothing has been flushed. 
+ */
+
+template <int RTYPE, class W, class M>
+Rcpp::List get_spill(W& writer, M ptr) {
+    const size_t nrow=ptr->get_nrow(), ncol=ptr->get_ncol();
+    Rcpp::Matrix<RTYPE> rows(nrow, ncol), cols(nrow, ncol);
+
+    Rcpp::Vector<RTYPE> work(ncol);
+    for (size_t r=0; r<nrow; ++r) {
+        writer.get_row(r, work.begin(), 0, ncol);
+        auto row=rows.row(r);
+        std::copy(work.begin(), work.end(), row.begin());
+    }
+    for (size_t c=0; c<ncol; ++c) {
+        writer.get_col(c, cols.begin() + c * nrow, 0, nrow);
+    }
+
+    return Rcpp::List::create(rows, cols);
+}
+
+template <int RTYPE, class W, class M>
+Rcpp::List set_spill(W& writer, M ptr) {
+    const size_t nrow=ptr->get_nrow(), ncol=ptr->get_ncol();
+    Rcpp::Vector<RTYPE> work(nrow);
+    for (size_t c=0; c<ncol; ++c) {
+        ptr->get_col(c, work.begin());
+        writer.set_col(c, work.begin(), 0, nrow);
+    }
+
+    bool copied=true;
+    try {
+        W copy(writer);
+    } catch (std::exception& e) {
+        copied=false;
+    }
+
+    bool modified=true;
+    if (ncol) {
+        ptr->get_col(0, work.begin());
+        try {
+            writer.set_col(0, work.begin(), 0, nrow);
+        } catch (std::exception& e) {
+            modified=false;
+        }
+    }
+
+    Rcpp::List before=get_spill<RTYPE>(writer, ptr);
+    Rcpp::RObject result=writer.yield();
+    Rcpp::List after=get_spill<RTYPE>(writer, ptr);
+
+    return Rcpp::List::create(
+        Rcpp::Named("nflushed")=static_cast<int>(writer.get_nflushed()), 
+        Rcpp::Named("copied")=copied, 
+        Rcpp::Named("modified")=modified, 
+        Rcpp::Named("before")=before, 
+        Rcpp::Named("after")=after, 
+        Rcpp::Named("result")=result
+    );
+}
+
+/* Creating the spilling writer via the output parameters. */
+
+template <class T, class M, class CREATOR>
+Rcpp::List set_spill_param(M ptr, CREATOR creator) {
+    const size_t nrow=ptr->get_nrow(), ncol=ptr->get_ncol();
+    auto optr=creator(nrow, ncol, beachmat::output_param("CsparseFile", "beachmat"));
+
+    T work(nrow);
+    for (size_t c=0; c<ncol; ++c) {
+        ptr->get_col(c, work.begin());
+        optr->set_col(c, work.begin());
+    }
+
+    return Rcpp::List::create(Rcpp::StringVector::create(optr->get_class()), optr->yield());
+}
+
+extern "C" {
+
+SEXP set_spill_numeric(SEXP incoming, SEXP budget, SEXP file, SEXP path) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_numeric_matrix(incoming);
+    beachmat::Csparse_spill_writer<double, Rcpp::NumericVector> writer(ptr->get_nrow(), ptr->get_ncol(), 
+        Rcpp::NumericVector(budget)[0], beachmat::make_to_string(path), Rcpp::LogicalVector(file)[0]);
+    return set_spill<REALSXP>(writer, ptr.get());
+    END_RCPP
+}
+
+SEXP set_spill_logical(SEXP incoming, SEXP budget, SEXP file, SEXP path) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_logical_matrix(incoming);
+    beachmat::Csparse_spill_writer<int, Rcpp::LogicalVector> writer(ptr->get_nrow(), ptr->get_ncol(), 
+        Rcpp::NumericVector(budget)[0], beachmat::make_to_string(path), Rcpp::LogicalVector(file)[0]);
+    return set_spill<LGLSXP>(writer, ptr.get());
+    END_RCPP
+}
+
+SEXP set_spill_param_numeric(SEXP incoming) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_numeric_matrix(incoming);
+    return set_spill_param<Rcpp::NumericVector>(ptr.get(), beachmat::create_numeric_output);
+    END_RCPP
+}
+
+SEXP set_spill_param_logical(SEXP incoming) {
+    BEGIN_RCPP
+    auto ptr=beachmat::create_logical_matrix(incoming);
+    return set_spill_param<Rcpp::LogicalVector>(ptr.get(), beachmat::create_logical_output);
+    END_RCPP
+}
+
+}
@@ -0,0 +1,78 @@
+#include "beachtest.h"
+
+/* Filling a sparse output matrix with entries in arbitrary order, possibly
+ * with duplicates. The first batch of entries is read back by row before the
+ * second batch is added, and everything is read by column after compact().
+ */
+
+template <int RTYPE, class W>
+void set_unordered_batch(W& writer, SEXP batch, bool indexed) {
+    Rcpp::List Batch(batch);
+    Rcpp::IntegerVector i(Batch[0]), j(Batch[1]);
+    Rcpp::Vector<RTYPE> x(Batch[2]);
+
+    if (!indexed) {
+        for (size_t k=0; k<i.size(); ++k) {
+            writer.set(i[k], j[k], x[k]);
+        }
+        return;
+    }
+
+    // Entries for each column are added in a single call, preserving their order.
+    for (size_t c=0; c<writer.get_ncol(); ++c) {
+        Rcpp::IntegerVector idx;
+        Rcpp::Vector<RTYPE> vals;
+        for (size_t k=0; k<i.size(); ++k) {
+            if (static_cast<size_t>(j[k])==c) {
+                idx.push_back(i[k]);
+                vals.push_back(x[k]);
+            }
+        }
+        writer.set_col_indexed(c, idx.size(), idx.begin(), vals.begin());
+    }
+    return;
+}
+
+template <int RTYPE, class W>
+Rcpp::List set_unordered(W& writer, SEXP first, SEXP second, SEXP indexed) {
+    const size_t nrow=writer.get_nrow(), ncol=writer.get_ncol();
+    const bool Indexed=Rcpp::LogicalVector(indexed)[0];
+
+    set_unordered_batch<RTYPE>(writer, first, Indexed);
+    Rcpp::Matrix<RTYPE> before(nrow, ncol);
+    Rcpp::Vector<RTYPE> work(ncol);
+    for (size_t r=0; r<nrow; ++r) {
+        writer.get_row(r, work.begin(), 0, ncol);
+        auto row=before.row(r);
+        std::copy(work.begin(), work.end(), row.begin());
+    }
+
+    set_unordered_batch<RTYPE>(writer, second, Indexed);
+    writer.compact();
+    Rcpp::Matrix<RTYPE> after(nrow, ncol);
+    for (size_t c=0; c<ncol; ++c) {
+        writer.get_col(c, after.begin() + c * nrow, 0, nrow);
+    }
+
+    return Rcpp::List::create(before, after, writer.yield());
+}
+
+extern "C" {
+
+SEXP set_unordered_numeric(SEXP dims, SEXP first, SEXP second, SEXP indexed) {
+    BEGIN_RCPP
+    Rcpp::IntegerVector Dims(dims);
+    beachmat::Csparse_writer<double, Rcpp::NumericVector> writer(Dims[0], Dims[1]);
+    return set_unordered<REALSXP>(writer, first, second, indexed);
+    END_RCPP
+}
+
+SEXP set_unordered_logical(SEXP dims, SEXP first, SEXP second, SEXP indexed) {
+    BEGIN_RCPP
+    Rcpp::IntegerVector Dims(dims);
+    beachmat::Csparse_writer<int, Rcpp::LogicalVector> writer(Dims[0], Dims[1]);
+    return set_unordered<LGLSXP>(writer, first, second, indexed);
+    END_RCPP
+}
+
+}
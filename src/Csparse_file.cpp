@@ -0,0 +1,120 @@
+#include "Rcpp.h"
+#include "beachmat3/beachmat.h"
+
+#include <vector>
+#include <limits>
+#include <string>
+
+/* Writing any supported sparse matrix to a CSC file, column by column.
+ * The values are converted to the type requested at the R level.
+ */
+template <class V>
+void write_csparse_file_internal(beachmat::lin_sparse_matrix* mat, const std::string& path) {
+    typedef typename V::stored_type T;
+    const size_t NR = mat->get_nrow(), NC = mat->get_ncol();
+    beachmat::Csparse_file_writer writer(path, NR, NC, mat->get_nnzero(), beachmat::get_Csparse_file_type<V>());
+
+    std::vector<T> work_x(NR);
+    std::vector<int> work_i(NR);
+    for (size_t c = 0; c < NC; ++c) {
+        auto out = mat->get_col(c, work_x.data(), work_i.data());
+        writer.add_column(out.i, out.x, out.n);
+    }
+
+    writer.finish();
+    return;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject write_csparse_file(Rcpp::RObject mat, std::string path, std::string type) {
+    auto ptr = beachmat::read_lin_sparse_block(mat);
+    if (type == "integer") {
+        write_csparse_file_internal<Rcpp::IntegerVector>(ptr.get(), path);
+    } else if (type == "logical") {
+        write_csparse_file_internal<Rcpp::LogicalVector>(ptr.get(), path);
+    } else if (type == "double") {
+        write_csparse_file_internal<Rcpp::NumericVector>(ptr.get(), path);
+    } else {
+        throw std::runtime_error("unsupported type '" + type + "'");
+    }
+    return R_NilValue;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::List csparse_file_header(std::string path) {
+    auto header = beachmat::read_Csparse_file_header(path);
+    const size_t limit = std::numeric_limits<int>::max();
+    if (header.nrow > limit || header.ncol > limit) {
+        throw std::runtime_error("dimensions of '" + path + "' exceed the range of R's integers");
+    }
+
+    Rcpp::IntegerVector dims = Rcpp::IntegerVector::create(header.nrow, header.ncol);
+    std::string type = beachmat::translate_type(header.type);
+    return Rcpp::List::create(dims, Rcpp::StringVector::create(type));
+}
+
+/* Validating the row indices of a CSC file from an untrusted source. This is
+ * done once upon construction of the CsparseFile in R, so that the readers
+ * in the C++ API do not need to scan all non-zero elements upon every use.
+ */
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject validate_csparse_file(std::string path) {
+    auto type = beachmat::read_Csparse_file_header(path).type;
+    if (type == INTSXP) {
+        beachmat::integer_Csparse_file mat(path, true);
+    } else if (type == REALSXP) {
+        beachmat::double_Csparse_file mat(path, true);
+    } else {
+        beachmat::logical_Csparse_file mat(path, true);
+    }
+    return R_NilValue;
+}
+
+/* Extracting an arbitrary submatrix, given 1-based row and column indices.
+ * Each requested column is extracted in its entirety, as the file is memory-mapped
+ * and the cost of populating a dense column is small relative to the indexing.
+ */
+template <int RTYPE, class M>
+Rcpp::RObject extract_csparse_file_internal(M& mat, Rcpp::IntegerVector i, Rcpp::IntegerVector j) {
+    typedef typename Rcpp::Vector<RTYPE>::stored_type T;
+    const size_t NR = mat.get_nrow();
+    Rcpp::Matrix<RTYPE> output(i.size(), j.size());
+    std::vector<T> work(NR);
+
+    for (auto r : i) {
+        if (r < 1 || static_cast<size_t>(r) > NR) {
+            throw std::runtime_error("row index out of range");
+        }
+    }
+    for (auto c : j) {
+        if (c < 1 || static_cast<size_t>(c) > mat.get_ncol()) {
+            throw std::runtime_error("column index out of range");
+        }
+    }
+
+    auto oIt = output.begin();
+    for (auto c : j) {
+        auto ptr = mat.get_col(c - 1, work.data(), 0, NR);
+        for (auto r : i) {
+            *oIt = ptr[r - 1];
+            ++oIt;
+        }
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject extract_csparse_file(std::string path, Rcpp::IntegerVector i, Rcpp::IntegerVector j) {
+    auto type = beachmat::read_Csparse_file_header(path).type;
+    if (type == INTSXP) {
+        beachmat::integer_Csparse_file mat(path);
+        return extract_csparse_file_internal<INTSXP>(mat, i, j);
+    } else if (type == REALSXP) {
+        beachmat::double_Csparse_file mat(path);
+        return extract_csparse_file_internal<REALSXP>(mat, i, j);
+    } else {
+        beachmat::logical_Csparse_file mat(path);
+        return extract_csparse_file_internal<LGLSXP>(mat, i, j);
+    }
+}
@@ -5,33 +5,133 @@
 
 using namespace Rcpp;
 
+// compute_stats
+Rcpp::List compute_stats(Rcpp::RObject block, bool by_row);
+RcppExport SEXP _beachmat_compute_stats(SEXP blockSEXP, SEXP by_rowSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type block(blockSEXP);
+    Rcpp::traits::input_parameter< bool >::type by_row(by_rowSEXP);
+    rcpp_result_gen = Rcpp::wrap(compute_stats(block, by_row));
+    return rcpp_result_gen;
+END_RCPP
+}
+// write_csparse_file
+Rcpp::RObject write_csparse_file(Rcpp::RObject mat, std::string path, std::string type);
+RcppExport SEXP _beachmat_write_csparse_file(SEXP matSEXP, SEXP pathSEXP, SEXP typeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< std::string >::type type(typeSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_csparse_file(mat, path, type));
+    return rcpp_result_gen;
+END_RCPP
+}
+// csparse_file_header
+Rcpp::List csparse_file_header(std::string path);
+RcppExport SEXP _beachmat_csparse_file_header(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(csparse_file_header(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// validate_csparse_file
+Rcpp::RObject validate_csparse_file(std::string path);
+RcppExport SEXP _beachmat_validate_csparse_file(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(validate_csparse_file(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_csparse_file
+Rcpp::RObject extract_csparse_file(std::string path, Rcpp::IntegerVector i, Rcpp::IntegerVector j);
+RcppExport SEXP _beachmat_extract_csparse_file(SEXP pathSEXP, SEXP iSEXP, SEXP jSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type i(iSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type j(jSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_csparse_file(path, i, j));
+    return rcpp_result_gen;
+END_RCPP
+}
 // fragment_sparse_rows
-Rcpp::List fragment_sparse_rows(Rcpp::IntegerVector i, Rcpp::IntegerVector p, Rcpp::IntegerVector limits);
+Rcpp::List fragment_sparse_rows(Rcpp::IntegerVector i, Rcpp::RObject p, Rcpp::IntegerVector limits);
 RcppExport SEXP _beachmat_fragment_sparse_rows(SEXP iSEXP, SEXP pSEXP, SEXP limitsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type i(iSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type p(pSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type p(pSEXP);
     Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type limits(limitsSEXP);
     rcpp_result_gen = Rcpp::wrap(fragment_sparse_rows(i, p, limits));
     return rcpp_result_gen;
 END_RCPP
 }
 // sparse_subset_index
-Rcpp::IntegerVector sparse_subset_index(Rcpp::IntegerVector starts, Rcpp::IntegerVector newp);
+Rcpp::RObject sparse_subset_index(Rcpp::RObject starts, Rcpp::RObject newp);
 RcppExport SEXP _beachmat_sparse_subset_index(SEXP startsSEXP, SEXP newpSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type starts(startsSEXP);
-    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type newp(newpSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type starts(startsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type newp(newpSEXP);
     rcpp_result_gen = Rcpp::wrap(sparse_subset_index(starts, newp));
     return rcpp_result_gen;
 END_RCPP
 }
+// write_tiled_file
+Rcpp::RObject write_tiled_file(Rcpp::RObject mat, std::string path, std::string type, int tile_nrow, int tile_ncol, bool compress);
+RcppExport SEXP _beachmat_write_tiled_file(SEXP matSEXP, SEXP pathSEXP, SEXP typeSEXP, SEXP tile_nrowSEXP, SEXP tile_ncolSEXP, SEXP compressSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< Rcpp::RObject >::type mat(matSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< std::string >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_nrow(tile_nrowSEXP);
+    Rcpp::traits::input_parameter< int >::type tile_ncol(tile_ncolSEXP);
+    Rcpp::traits::input_parameter< bool >::type compress(compressSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_tiled_file(mat, path, type, tile_nrow, tile_ncol, compress));
+    return rcpp_result_gen;
+END_RCPP
+}
+// tiled_file_header
+Rcpp::List tiled_file_header(std::string path);
+RcppExport SEXP _beachmat_tiled_file_header(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(tiled_file_header(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// extract_tiled_file
+Rcpp::RObject extract_tiled_file(std::string path, Rcpp::IntegerVector i, Rcpp::IntegerVector j);
+RcppExport SEXP _beachmat_extract_tiled_file(SEXP pathSEXP, SEXP iSEXP, SEXP jSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type i(iSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type j(jSEXP);
+    rcpp_result_gen = Rcpp::wrap(extract_tiled_file(path, i, j));
+    return rcpp_result_gen;
+END_RCPP
+}
 
 static const R_CallMethodDef CallEntries[] = {
+    {"_beachmat_compute_stats", (DL_FUNC) &_beachmat_compute_stats, 2},
+    {"_beachmat_write_csparse_file", (DL_FUNC) &_beachmat_write_csparse_file, 3},
+    {"_beachmat_csparse_file_header", (DL_FUNC) &_beachmat_csparse_file_header, 1},
+    {"_beachmat_validate_csparse_file", (DL_FUNC) &_beachmat_validate_csparse_file, 1},
+    {"_beachmat_extract_csparse_file", (DL_FUNC) &_beachmat_extract_csparse_file, 3},
     {"_beachmat_fragment_sparse_rows", (DL_FUNC) &_beachmat_fragment_sparse_rows, 3},
     {"_beachmat_sparse_subset_index", (DL_FUNC) &_beachmat_sparse_subset_index, 2},
+    {"_beachmat_write_tiled_file", (DL_FUNC) &_beachmat_write_tiled_file, 6},
+    {"_beachmat_tiled_file_header", (DL_FUNC) &_beachmat_tiled_file_header, 1},
+    {"_beachmat_extract_tiled_file", (DL_FUNC) &_beachmat_extract_tiled_file, 3},
     {NULL, NULL, 0}
 };
 
@@ -0,0 +1,174 @@
+#include "Rcpp.h"
+#include "beachmat3/beachmat.h"
+
+#include <vector>
+#include <type_traits>
+
+/* Figuring out the storage type of each concrete class,
+ * so that values can be extracted without conversion and NAs can be handled properly.
+ */
+template <class M>
+struct stored_type_of {};
+
+template <class V>
+struct stored_type_of<beachmat::lin_ordinary_matrix<V> > { 
+    typedef typename V::stored_type type; 
+};
+
+template <class V, typename TIT>
+struct stored_type_of<beachmat::gCMatrix<V, TIT> > { 
+    typedef typename V::stored_type type; 
+};
+
+template <class V, typename TIT>
+struct stored_type_of<beachmat::lin_SparseArraySeed<V, TIT> > { 
+    typedef typename V::stored_type type; 
+};
+
+template <class V, typename TIT>
+struct stored_type_of<beachmat::lin_Csparse_file<V, TIT> > { 
+    typedef typename V::stored_type type; 
+};
+
+template <class V>
+struct stored_type_of<beachmat::lin_tiled_file<V> > { 
+    typedef typename V::stored_type type; 
+};
+
+inline double to_double(double x) { 
+    return x; 
+}
+
+inline double to_double(int x) { 
+    return (x == NA_INTEGER ? NA_REAL : x); 
+}
+
+/* Computes the sum and the sum of squared differences from the mean
+ * for each column (or row) of the block. For sparse matrices, only the
+ * non-zero elements are visited and the zeroes are handled analytically.
+ * Row statistics are accumulated by looping over columns, so that we never
+ * need to do (potentially costly) row extraction.
+ */
+struct stats_computer {
+    stats_computer(bool r) : by_row(r) {}
+
+    bool by_row;
+
+    template <class M>
+    Rcpp::List operator()(M& mat) const {
+        return compute(mat, std::is_base_of<beachmat::lin_sparse_matrix, M>());
+    }
+
+    template <class M>
+    Rcpp::List compute(M& mat, std::false_type) const {
+        typedef typename stored_type_of<M>::type T;
+        const size_t NR = mat.get_nrow(), NC = mat.get_ncol();
+        std::vector<T> work(NR);
+
+        if (!by_row) {
+            Rcpp::NumericVector sums(NC), ss(NC);
+            for (size_t c = 0; c < NC; ++c) {
+                auto ptr = mat.get_col(c, work.data(), 0, NR);
+
+                double& cursum = sums[c];
+                for (size_t r = 0; r < NR; ++r) {
+                    cursum += to_double(ptr[r]);
+                }
+
+                const double mean = cursum / NR;
+                double& curss = ss[c];
+                for (size_t r = 0; r < NR; ++r) {
+                    const double delta = to_double(ptr[r]) - mean;
+                    curss += delta * delta;
+                }
+            }
+            return Rcpp::List::create(sums, ss);
+
+        } else {
+            Rcpp::NumericVector sums(NR), ss(NR);
+            for (size_t c = 0; c < NC; ++c) {
+                auto ptr = mat.get_col(c, work.data(), 0, NR);
+                for (size_t r = 0; r < NR; ++r) {
+                    sums[r] += to_double(ptr[r]);
+                }
+            }
+
+            std::vector<double> means(sums.begin(), sums.end());
+            for (auto& m : means) {
+                m /= NC;
+            }
+
+            for (size_t c = 0; c < NC; ++c) {
+                auto ptr = mat.get_col(c, work.data(), 0, NR);
+                for (size_t r = 0; r < NR; ++r) {
+                    const double delta = to_double(ptr[r]) - means[r];
+                    ss[r] += delta * delta;
+                }
+            }
+            return Rcpp::List::create(sums, ss);
+        }
+    }
+
+    template <class M>
+    Rcpp::List compute(M& mat, std::true_type) const {
+        typedef typename stored_type_of<M>::type T;
+        const size_t NR = mat.get_nrow(), NC = mat.get_ncol();
+        std::vector<T> work_x(NR);
+        std::vector<int> work_i(NR);
+
+        if (!by_row) {
+            Rcpp::NumericVector sums(NC), ss(NC);
+            for (size_t c = 0; c < NC; ++c) {
+                auto idx = mat.get_col(c, work_x.data(), work_i.data(), 0, NR);
+
+                double& cursum = sums[c];
+                for (size_t v = 0; v < idx.n; ++v) {
+                    cursum += to_double(idx.x[v]);
+                }
+
+                const double mean = cursum / NR;
+                double& curss = ss[c];
+                for (size_t v = 0; v < idx.n; ++v) {
+                    const double delta = to_double(idx.x[v]) - mean;
+                    curss += delta * delta;
+                }
+                curss += mean * mean * (NR - idx.n);
+            }
+            return Rcpp::List::create(sums, ss);
+
+        } else {
+            Rcpp::NumericVector sums(NR), ss(NR);
+            std::vector<size_t> nzeros(NR);
+            for (size_t c = 0; c < NC; ++c) {
+                auto idx = mat.get_col(c, work_x.data(), work_i.data(), 0, NR);
+                for (size_t v = 0; v < idx.n; ++v) {
+                    sums[idx.i[v]] += to_double(idx.x[v]);
+                    ++nzeros[idx.i[v]];
+                }
+            }
+
+            std::vector<double> means(sums.begin(), sums.end());
+            for (auto& m : means) {
+                m /= NC;
+            }
+
+            for (size_t c = 0; c < NC; ++c) {
+                auto idx = mat.get_col(c, work_x.data(), work_i.data(), 0, NR);
+                for (size_t v = 0; v < idx.n; ++v) {
+                    const double delta = to_double(idx.x[v]) - means[idx.i[v]];
+                    ss[idx.i[v]] += delta * delta;
+                }
+            }
+
+            for (size_t r = 0; r < NR; ++r) {
+                ss[r] += means[r] * means[r] * (NC - nzeros[r]);
+            }
+            return Rcpp::List::create(sums, ss);
+        }
+    }
+};
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::List compute_stats(Rcpp::RObject block, bool by_row) {
+    return beachmat::visit_lin_block(block, stats_computer(by_row));
+}
@@ -1,36 +1,41 @@
 #include "Rcpp.h"
 #include <vector>
 #include <algorithm>
+#include <numeric>
 
-// [[Rcpp::export(rng=false)]]
-Rcpp::List fragment_sparse_rows(Rcpp::IntegerVector i, Rcpp::IntegerVector p, Rcpp::IntegerVector limits) {
+/* The column pointers are either integer or double-precision, the latter for matrices with more than 2^31 - 1 non-zeros.
+ * We use the same type for the outputs, along with an appropriate counter type 'C'; 
+ * this means that the usual integer case is unaffected by support for the larger matrices.
+ */
+template <class PV, typename C>
+Rcpp::List fragment_sparse_rows_internal(Rcpp::IntegerVector i, PV p, Rcpp::IntegerVector limits) {
     size_t ncolsp1 = p.size();
     size_t nchunks = limits.size();
 
-    std::vector<Rcpp::IntegerVector> starti(nchunks);
-    std::vector<Rcpp::IntegerVector> newp(nchunks);
+    std::vector<PV> starti(nchunks);
+    std::vector<PV> newp(nchunks);
     for (size_t l = 0; l < nchunks; ++l) {
-        starti[l] = Rcpp::IntegerVector(ncolsp1 - 1);
-        newp[l] = Rcpp::IntegerVector(ncolsp1);
+        starti[l] = PV(ncolsp1 - 1);
+        newp[l] = PV(ncolsp1);
     }
 
-    int counter = 0;
+    C counter = 0;
     auto iIt = i.begin();
 
     for (size_t px = 1; px < ncolsp1; ++px) {
-        auto colend = p[px];
+        C colend = p[px];
         for (size_t l = 0; l < nchunks; ++l) {
             auto chunkend = limits[l];
 
-            auto& start = starti[l][px - 1];
-            start = counter;
+            C start = counter;
+            starti[l][px - 1] = start;
             while (iIt != i.end() && counter < colend && *iIt < chunkend) {
                 ++iIt;
                 ++counter;
             }
 
             auto& curp = newp[l];
-            curp[px] = curp[px - 1] + counter - start;
+            curp[px] = curp[px - 1] + (counter - start);
         }
     }
 
@@ -43,15 +48,33 @@ Rcpp::List fragment_sparse_rows(Rcpp::IntegerVector i, Rcpp::IntegerVector p, Rc
 }
 
 // [[Rcpp::export(rng=false)]]
-Rcpp::IntegerVector sparse_subset_index (Rcpp::IntegerVector starts, Rcpp::IntegerVector newp) {
+Rcpp::List fragment_sparse_rows(Rcpp::IntegerVector i, Rcpp::RObject p, Rcpp::IntegerVector limits) {
+    if (p.sexp_type() == REALSXP) {
+        return fragment_sparse_rows_internal<Rcpp::NumericVector, size_t>(i, Rcpp::NumericVector(p), limits);
+    } else {
+        return fragment_sparse_rows_internal<Rcpp::IntegerVector, int>(i, Rcpp::IntegerVector(p), limits);
+    }
+}
+
+template <class PV>
+PV sparse_subset_index_internal(PV starts, PV newp) {
     size_t ncols = starts.size();
     size_t total = newp[ncols];
-    Rcpp::IntegerVector subset(total);
+    PV subset(total);
     auto sIt = subset.begin();
     for (size_t px = 1; px <= ncols; ++px) {
-        auto delta = newp[px] - newp[px-1];
+        size_t delta = newp[px] - newp[px-1];
         std::iota(sIt, sIt + delta, starts[px-1] + 1);
         sIt += delta;
     }
     return subset;
 }
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject sparse_subset_index (Rcpp::RObject starts, Rcpp::RObject newp) {
+    if (starts.sexp_type() == REALSXP) {
+        return sparse_subset_index_internal<Rcpp::NumericVector>(Rcpp::NumericVector(starts), Rcpp::NumericVector(newp));
+    } else {
+        return sparse_subset_index_internal<Rcpp::IntegerVector>(Rcpp::IntegerVector(starts), Rcpp::IntegerVector(newp));
+    }
+}
@@ -0,0 +1,105 @@
+#include "Rcpp.h"
+#include "beachmat3/beachmat.h"
+
+#include <vector>
+#include <limits>
+#include <string>
+#include <algorithm>
+
+/* Writing any supported matrix to a tiled file, column by column.
+ * The values are converted to the type requested at the R level.
+ */
+template <typename T>
+void write_tiled_file_internal(beachmat::lin_matrix* mat, beachmat::tiled_file_writer& writer) {
+    const size_t NR = mat->get_nrow(), NC = mat->get_ncol();
+    std::vector<T> work(NR);
+    for (size_t c = 0; c < NC; ++c) {
+        writer.add_column(mat->get_col(c, work.data()));
+    }
+    writer.finish();
+    return;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject write_tiled_file(Rcpp::RObject mat, std::string path, std::string type, int tile_nrow, int tile_ncol, bool compress) {
+    auto ptr = beachmat::read_lin_block(mat);
+    if (tile_nrow <= 0 || tile_ncol <= 0) {
+        throw std::runtime_error("tile dimensions should be positive");
+    }
+
+    uint32_t code;
+    if (type == "integer") {
+        code = INTSXP;
+    } else if (type == "logical") {
+        code = LGLSXP;
+    } else if (type == "double") {
+        code = REALSXP;
+    } else {
+        throw std::runtime_error("unsupported type '" + type + "'");
+    }
+
+    beachmat::tiled_file_writer writer(path, ptr->get_nrow(), ptr->get_ncol(), code, tile_nrow, tile_ncol, compress);
+    if (code == REALSXP) {
+        write_tiled_file_internal<double>(ptr.get(), writer);
+    } else {
+        write_tiled_file_internal<int>(ptr.get(), writer);
+    }
+    return R_NilValue;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::List tiled_file_header(std::string path) {
+    auto header = beachmat::read_tiled_file_header(path);
+    const size_t limit = std::numeric_limits<int>::max();
+    if (header.nrow > limit || header.ncol > limit) {
+        throw std::runtime_error("dimensions of '" + path + "' exceed the range of R's integers");
+    }
+
+    Rcpp::IntegerVector dims = Rcpp::IntegerVector::create(header.nrow, header.ncol);
+    Rcpp::IntegerVector tiles = Rcpp::IntegerVector::create(header.tile_nrow, header.tile_ncol);
+    std::string type = beachmat::translate_type(header.type);
+    return Rcpp::List::create(dims, Rcpp::StringVector::create(type), tiles);
+}
+
+/* Extracting an arbitrary submatrix, given 1-based row and column indices.
+ * For each requested column, we only extract the interval spanned by the requested rows,
+ * so that only the overlapping tiles are decompressed.
+ */
+template <int RTYPE, class M>
+Rcpp::RObject extract_tiled_file_internal(M& mat, Rcpp::IntegerVector i, Rcpp::IntegerVector j) {
+    typedef typename Rcpp::Vector<RTYPE>::stored_type T;
+    Rcpp::Matrix<RTYPE> output(i.size(), j.size());
+    if (i.size() == 0) {
+        return output;
+    }
+
+    const size_t first = *std::min_element(i.begin(), i.end()) - 1;
+    const size_t last = *std::max_element(i.begin(), i.end());
+    std::vector<T> work(last - first);
+
+    auto oIt = output.begin();
+    for (auto c : j) {
+        auto ptr = mat.get_col(c - 1, work.data(), first, last);
+        for (auto r : i) {
+            *oIt = ptr[r - 1 - first];
+            ++oIt;
+        }
+    }
+
+    return output;
+}
+
+// [[Rcpp::export(rng=false)]]
+Rcpp::RObject extract_tiled_file(std::string path, Rcpp::IntegerVector i, Rcpp::IntegerVector j) {
+    auto type = beachmat::read_tiled_file_header(path).type;
+    if (type == INTSXP) {
+        beachmat::integer_tiled_file mat(path);
+        return extract_tiled_file_internal<INTSXP>(mat, i, j);
+    } else if (type == REALSXP) {
+        beachmat::double_tiled_file mat(path);
+        return extract_tiled_file_internal<REALSXP>(mat, i, j);
+    } else {
+        beachmat::logical_tiled_file mat(path);
+        return extract_tiled_file_internal<LGLSXP>(mat, i, j);
+    }
+}